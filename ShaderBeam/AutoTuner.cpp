@@ -0,0 +1,120 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "AutoTuner.h"
+
+namespace ShaderBeam
+{
+
+void AutoTuner::Start(const std::vector<AutoTuneCandidate>& candidates, const AutoTuneCandidate& original, unsigned warmup, unsigned window)
+{
+    m_results.clear();
+    for(const auto& candidate : candidates)
+        m_results.push_back({ .candidate = candidate });
+
+    m_original = original;
+    m_warmup   = warmup;
+    m_window   = max(window, 1u);
+    m_ticks    = 0;
+    m_current  = 0;
+    m_running  = !m_results.empty();
+}
+
+void AutoTuner::Stop()
+{
+    m_running = false;
+}
+
+bool AutoTuner::IsRunning() const
+{
+    return m_running;
+}
+
+bool AutoTuner::Tick(const AutoTuneSample& sample, float vsyncDuration)
+{
+    if(!m_running)
+        return false;
+
+    // skip the first few seconds while capture and presentation settle down
+    if(m_ticks++ < m_warmup)
+        return false;
+
+    auto& result = m_results[m_current];
+    result.missedVsyncRate += sample.missedVsyncRate;
+    result.submitP99 = max(result.submitP99, sample.submitP99);
+    result.captureLag += sample.captureLag;
+    result.samples++;
+
+    if(result.samples < (int)m_window)
+        return false;
+
+    result.missedVsyncRate /= result.samples;
+    result.captureLag /= result.samples;
+    result.score = Score(result, vsyncDuration);
+    return true;
+}
+
+bool AutoTuner::NextCandidate()
+{
+    m_ticks = 0;
+    if(m_current + 1 < (int)m_results.size())
+    {
+        m_current++;
+        return true;
+    }
+    m_running = false;
+    return false;
+}
+
+const AutoTuneCandidate& AutoTuner::GetCandidate() const
+{
+    return m_results[m_current].candidate;
+}
+
+const AutoTuneCandidate& AutoTuner::GetOriginal() const
+{
+    return m_original;
+}
+
+const AutoTuneResult* AutoTuner::GetBest() const
+{
+    const AutoTuneResult* best = nullptr;
+    for(const auto& result : m_results)
+    {
+        if(result.samples && (!best || result.score < best->score))
+            best = &result;
+    }
+    return best;
+}
+
+int AutoTuner::GetCandidateNo() const
+{
+    return m_current;
+}
+
+int AutoTuner::GetNumCandidates() const
+{
+    return (int)m_results.size();
+}
+
+float AutoTuner::Score(const AutoTuneResult& result, float vsyncDuration)
+{
+    if(vsyncDuration <= 0)
+        return FLT_MAX;
+
+    // lower is better: 1% of missed vsyncs costs as much as a p99 submit interval one vsync too long,
+    // capture lag and queued frames (latency) only break ties between otherwise stable candidates
+    auto missed  = result.missedVsyncRate * 100.0f;
+    auto jitter  = max(0.0f, result.submitP99 - vsyncDuration) / vsyncDuration;
+    auto lag     = 0.1f * result.captureLag / vsyncDuration;
+    auto latency = 0.01f * result.candidate.maxQueuedFrames;
+    return missed + jitter + lag + latency;
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,67 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+
+namespace ShaderBeam
+{
+
+struct AutoTuneCandidate
+{
+    int maxQueuedFrames;
+    int shaderAdapterNo;
+    int captureMethod;
+};
+
+struct AutoTuneSample
+{
+    float missedVsyncRate;
+    float submitP99;
+    float captureLag;
+};
+
+struct AutoTuneResult
+{
+    AutoTuneCandidate candidate;
+    float             missedVsyncRate { 0 };
+    float             submitP99 { 0 };
+    float             captureLag { 0 };
+    int               samples { 0 };
+    float             score { FLT_MAX };
+};
+
+class AutoTuner
+{
+public:
+    void Start(const std::vector<AutoTuneCandidate>& candidates, const AutoTuneCandidate& original, unsigned warmup, unsigned window);
+    void Stop();
+    bool IsRunning() const;
+
+    // called once per second, returns true when current candidate has been measured
+    bool Tick(const AutoTuneSample& sample, float vsyncDuration);
+    bool NextCandidate();
+
+    const AutoTuneCandidate& GetCandidate() const;
+    const AutoTuneCandidate& GetOriginal() const;
+    const AutoTuneResult*    GetBest() const;
+    int                      GetCandidateNo() const;
+    int                      GetNumCandidates() const;
+
+    static float Score(const AutoTuneResult& result, float vsyncDuration);
+
+private:
+    bool                        m_running { false };
+    unsigned                    m_warmup { 0 };
+    unsigned                    m_window { 0 };
+    unsigned                    m_ticks { 0 };
+    int                         m_current { 0 };
+    AutoTuneCandidate           m_original {};
+    std::vector<AutoTuneResult> m_results;
+};
+} // namespace ShaderBeam
@@ -13,40 +13,43 @@ MIT License
 namespace ShaderBeam
 {
 
-CaptureBase::CaptureBase(Watcher& watcher, const Options& options) : m_watcher(watcher), m_options(options), m_name() { }
+CaptureBase::CaptureBase(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool) :
+    m_watcher(watcher), m_options(options), m_resourcePool(resourcePool), m_name(), m_copyEngine(workerPool), m_tileHasher(workerPool)
+{ }
 
 void CaptureBase::Start(winrt::com_ptr<IDXGIDevice> captureDevice, winrt::com_ptr<ID3D11DeviceContext> outputContext)
 {
-    m_captureDevice       = captureDevice;
-    m_outputContext       = outputContext;
-    m_stopping            = false;
-    m_stagingCopyRequired = false;
-    m_windowX             = 0;
-    m_windowY             = 0;
-
-    if(m_options.captureWindow)
-    {
-        RECT captureRect;
-        if(DwmGetWindowAttribute(m_options.captureWindow, DWMWA_EXTENDED_FRAME_BOUNDS, &captureRect, sizeof(RECT)) == S_OK)
-        {
-            auto        monitor = MonitorFromWindow(m_options.captureWindow, MONITOR_DEFAULTTONEAREST);
-            MONITORINFO monitorInfo;
-            monitorInfo.cbSize = sizeof(monitorInfo);
-            if(GetMonitorInfo(monitor, &monitorInfo))
-            {
-                m_windowX = captureRect.left - monitorInfo.rcMonitor.left;
-                m_windowY = captureRect.top - monitorInfo.rcMonitor.top;
-            }
-        }
-    }
+    m_captureDevice   = captureDevice;
+    m_outputContext   = outputContext;
+    m_stopping        = false;
+    m_nextStagingSlot = 0;
+    m_stagingSequence = 0;
+    m_windowX         = m_options.windowX - m_options.inputX;
+    m_windowY         = m_options.windowY - m_options.inputY;
+    m_uploadValid     = false;
+    m_frameContent    = FrameContent::New;
+    m_tileHasher.Reset(m_options.inputWidth, m_options.inputHeight, m_options.useHdr ? 8 : 4);
+    m_outputDirty.Reset(m_options.inputWidth, m_options.inputHeight);
+    m_stagingDirty.Reset(m_options.inputWidth, m_options.inputHeight);
 
     InternalStart();
 }
 
 void CaptureBase::BenchmarkCopy(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
 {
-    if(m_options.crossAdapter)
-        CopyStagingToOutput(outputTexture);
+    if(m_options.crossAdapter && !m_stagingRing.empty())
+    {
+        DirtyRegions full;
+        full.Reset(m_options.inputWidth, m_options.inputHeight);
+        full.SetFull();
+        CopyStagingToOutput(m_stagingRing[0], outputTexture, true, full);
+    }
+}
+
+double CaptureBase::BenchmarkCPUCopy()
+{
+    const size_t rowBytes = (size_t)m_options.inputWidth * (m_options.useHdr ? 8 : 4);
+    return m_copyEngine.Benchmark(rowBytes, m_options.inputHeight, COPY_BENCHMARK_ITERATIONS);
 }
 
 void CaptureBase::Stop()
@@ -55,12 +58,15 @@ void CaptureBase::Stop()
 
     InternalStop();
 
-    m_stagingFrame        = nullptr;
-    m_stagingContext      = nullptr;
-    m_stagingDevice       = nullptr;
-    m_outputContext       = nullptr;
-    m_captureDevice       = nullptr;
-    m_stagingCopyRequired = false;
+    for(auto& slot : m_stagingRing)
+        m_resourcePool.Release(slot.texture);
+    m_stagingRing.clear();
+    m_resourcePool.Release(m_uploadFrame);
+    m_gpuTileHasher.Stop();
+    m_stagingContext = nullptr;
+    m_stagingDevice  = nullptr;
+    m_outputContext  = nullptr;
+    m_captureDevice  = nullptr;
 }
 
 bool CaptureBase::Poll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
@@ -70,19 +76,37 @@ bool CaptureBase::Poll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
 
     bool newFrame = InternalPoll(outputTexture);
 
-    // we do this separately so that capture API can get its resource back asap
-    if(m_stagingCopyRequired)
-    {
-        CopyStagingToOutput(outputTexture);
-    }
+    // we do this separately so that capture API can get its resource back asap;
+    // across adapters a frame only reaches the output once its readback has completed (sources uploading from CPU don't use one)
+    if(m_options.crossAdapter && !m_stagingRing.empty())
+        newFrame = ReadbackStaging(outputTexture);
 
     return newFrame;
 }
 
-void CaptureBase::CopyToOutput(const winrt::com_ptr<ID3D11Texture2D>& capturedFrame, int width, int height, const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
+bool CaptureBase::CopyToOutput(const winrt::com_ptr<ID3D11Texture2D>& capturedFrame,
+                               int                                    width,
+                               int                                    height,
+                               const winrt::com_ptr<ID3D11Texture2D>& outputTexture,
+                               const std::vector<DirtyRect>*          changedRects)
 {
     if(m_stopping || !capturedFrame || width == 0 || height == 0)
-        return;
+        return false;
+
+    // what changed in this frame, in output coordinates
+    DirtyRegions changes;
+    changes.Reset(m_options.inputWidth, m_options.inputHeight);
+    if(!changedRects || !m_options.dirtyRegions)
+    {
+        changes.SetFull();
+    }
+    else
+    {
+        for(const auto& rect : *changedRects)
+        {
+            changes.Add({ max(rect.left, 0) + m_windowX, max(rect.top, 0) + m_windowY, min(rect.right, width) + m_windowX, min(rect.bottom, height) + m_windowY });
+        }
+    }
 
     if(m_options.crossAdapter)
     {
@@ -92,74 +116,333 @@ void CaptureBase::CopyToOutput(const winrt::com_ptr<ID3D11Texture2D>& capturedFr
             m_stagingDevice = m_captureDevice.as<ID3D11Device>();
             m_stagingDevice->GetImmediateContext(m_stagingContext.put());
         }
-        if(!m_stagingFrame)
+        if(m_stagingRing.empty())
         {
-            D3D11_TEXTURE2D_DESC stagingDesc {};
-            stagingDesc.Width              = m_options.outputWidth;
-            stagingDesc.Height             = m_options.outputHeight;
-            stagingDesc.ArraySize          = 1;
-            stagingDesc.Format             = m_options.format;
-            stagingDesc.SampleDesc.Count   = 1;
-            stagingDesc.SampleDesc.Quality = 0;
-            stagingDesc.MipLevels          = 1;
-            stagingDesc.MiscFlags          = 0;
-            stagingDesc.CPUAccessFlags     = D3D11_CPU_ACCESS_READ;
-            stagingDesc.Usage              = D3D11_USAGE_STAGING;
-            stagingDesc.BindFlags          = 0;
-            THROW(m_stagingDevice->CreateTexture2D(&stagingDesc, nullptr, m_stagingFrame.put()), "Unable to create staging texture");
+            CreateStagingRing();
+        }
+
+        // ring full, newest frame wins over one that was never read back
+        auto& slot = m_stagingRing[m_nextStagingSlot];
+        if(slot.pending)
+        {
+            // its changes still have to reach the render adapter, hand them to the next oldest frame
+            auto& next = m_stagingRing[(m_nextStagingSlot + 1) % m_stagingRing.size()];
+            if(&next != &slot && next.pending)
+                next.changes.Add(slot.changes);
+            else
+                changes.Add(slot.changes);
+            m_watcher.ReadbackDropped();
         }
 
         // copy captured frame to staging frame (because capturedFrame wont't have CPU_ACCESS_READ)
-        CopyTrimToOutputSize(m_stagingContext.get(), m_stagingFrame.get(), capturedFrame.get(), width, height);
+        // slot holds an older frame, so bring over everything that changed since it was last filled
+        m_stagingDirty.MarkDirty(changes);
+        CopyRegions(m_stagingContext.get(), slot.texture.get(), capturedFrame.get(), width, height, m_stagingDirty.Take(slot.texture.get()));
+        m_stagingContext->End(slot.query.get());
+        m_stagingContext->Flush();
 
-        m_stagingCopyRequired = true;
+        slot.changes      = changes;
+        slot.pending      = true;
+        slot.sequence     = ++m_stagingSequence;
+        m_nextStagingSlot = (m_nextStagingSlot + 1) % m_stagingRing.size();
     }
     else
     {
-        // same adapter, just copy directly
-        CopyTrimToOutputSize(m_outputContext.get(), outputTexture.get(), capturedFrame.get(), width, height);
+        // same adapter, just copy directly whatever output slot is missing
+        m_outputDirty.MarkDirty(changes);
+        auto regions = m_outputDirty.Take(outputTexture.get());
+        CopyRegions(m_outputContext.get(), outputTexture.get(), capturedFrame.get(), width, height, regions);
+        m_watcher.FrameTransferred(regions.Coverage());
+
+        // capture APIs deliver frames for cursor moves or repaints that change nothing, no need to show them as new
+        m_frameContent = m_options.frameHashing ? HashOnGPU(outputTexture.get()) : FrameContent::New;
+        if(m_frameContent == FrameContent::Identical)
+        {
+            m_watcher.FrameDuplicated();
+            return false;
+        }
+    }
+    return true;
+}
+
+FrameContent CaptureBase::HashOnGPU(ID3D11Texture2D* outputTexture)
+{
+    if(!m_gpuTileHasher.IsStarted())
+        m_gpuTileHasher.Start(m_outputContext.get(), m_resourcePool, m_options.inputWidth, m_options.inputHeight);
+
+    // earlier frames went out as new before their hashes were back, classifying them now keeps the baseline on what was shown
+    while(m_gpuTileHasher.Read(m_gpuHashes))
+        m_tileHasher.Compare(m_gpuHashes);
+
+    // render thread never waits on these, if the GPU is that far behind the chain of baselines starts over
+    if(!m_gpuTileHasher.Dispatch(outputTexture))
+    {
+        m_gpuTileHasher.Discard();
+        m_tileHasher.Invalidate();
+        return FrameContent::New;
+    }
+    if(m_gpuTileHasher.Read(m_gpuHashes))
+        return m_tileHasher.Compare(m_gpuHashes);
+
+    // not back yet, goes out as new and gets classified at a later poll
+    m_tileHasher.MarkAllChanged();
+    return FrameContent::New;
+}
+
+void CaptureBase::UploadToOutput(const uint8_t* data, size_t pitch, int width, int height, const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
+{
+    if(m_stopping || !data || width == 0 || height == 0)
+        return;
+
+    // truncate if frame is larger than the inputs, driver copies straight from source memory
+    D3D11_BOX box;
+    box.left   = 0;
+    box.top    = 0;
+    box.right  = min(width, (int)m_options.inputWidth);
+    box.bottom = min(height, (int)m_options.inputHeight);
+    box.front  = 0;
+    box.back   = 1;
+    m_outputContext->UpdateSubresource(outputTexture.get(), 0, &box, data, (UINT)pitch, 0);
+    m_watcher.FrameTransferred(1.0f);
+}
+
+void CaptureBase::CreateStagingRing()
+{
+    D3D11_TEXTURE2D_DESC stagingDesc {};
+    stagingDesc.Width              = m_options.inputWidth;
+    stagingDesc.Height             = m_options.inputHeight;
+    stagingDesc.ArraySize          = 1;
+    stagingDesc.Format             = m_options.format;
+    stagingDesc.SampleDesc.Count   = 1;
+    stagingDesc.SampleDesc.Quality = 0;
+    stagingDesc.MipLevels          = 1;
+    stagingDesc.MiscFlags          = 0;
+    stagingDesc.CPUAccessFlags     = D3D11_CPU_ACCESS_READ;
+    stagingDesc.Usage              = D3D11_USAGE_STAGING;
+    stagingDesc.BindFlags          = 0;
+
+    D3D11_QUERY_DESC queryDesc {};
+    queryDesc.Query = D3D11_QUERY_EVENT;
+
+    auto depth = std::clamp(m_options.readbackDepth, 1, MAX_READBACK_DEPTH);
+    m_stagingRing.resize(depth);
+    for(auto& slot : m_stagingRing)
+    {
+        slot.texture = m_resourcePool.AcquireTexture(m_stagingDevice.get(), stagingDesc);
+        THROW(m_stagingDevice->CreateQuery(&queryDesc, slot.query.put()), "Unable to create staging query");
+    }
+}
+
+bool CaptureBase::ReadbackStaging(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
+{
+    // with a single slot we wait for the capture GPU (lowest latency), otherwise take the newest finished copy
+    const bool   wait   = m_stagingRing.size() == 1;
+    StagingSlot* ready  = nullptr;
+    unsigned     queued = 0;
+    for(auto& slot : m_stagingRing)
+    {
+        if(!slot.pending)
+            continue;
+        queued++;
+        if(!wait && m_stagingContext->GetData(slot.query.get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            continue;
+        if(!ready || slot.sequence > ready->sequence)
+            ready = &slot;
+    }
+    if(!ready)
+        return false;
+
+    // render adapter has seen everything up to the last frame read back, collect what changed since
+    DirtyRegions changes;
+    changes.Reset(m_options.inputWidth, m_options.inputHeight);
+    for(const auto& slot : m_stagingRing)
+    {
+        if(slot.pending && slot.sequence <= ready->sequence)
+            changes.Add(slot.changes);
+    }
+
+    if(!CopyStagingToOutput(*ready, outputTexture, wait, changes))
+        return false;
+
+    // GPU completes copies in order, so anything older is done too and has been superseded
+    for(auto& slot : m_stagingRing)
+    {
+        if(slot.pending && slot.sequence < ready->sequence)
+        {
+            slot.pending = false;
+            m_watcher.ReadbackDropped();
+        }
     }
+    m_watcher.ReadbackCompleted(queued);
+
+    // nothing changed on screen (e.g. just the cursor moved), keep showing the previous input
+    if(m_frameContent == FrameContent::Identical)
+    {
+        m_watcher.FrameDuplicated();
+        return false;
+    }
+    return true;
+}
+
+void CaptureBase::CreateUploadFrame()
+{
+    winrt::com_ptr<ID3D11Device> outputDevice;
+    m_outputContext->GetDevice(outputDevice.put());
+
+    D3D11_TEXTURE2D_DESC uploadDesc {};
+    uploadDesc.Width              = m_options.inputWidth;
+    uploadDesc.Height             = m_options.inputHeight;
+    uploadDesc.ArraySize          = 1;
+    uploadDesc.Format             = m_options.format;
+    uploadDesc.SampleDesc.Count   = 1;
+    uploadDesc.SampleDesc.Quality = 0;
+    uploadDesc.MipLevels          = 1;
+    uploadDesc.MiscFlags          = 0;
+    uploadDesc.CPUAccessFlags     = D3D11_CPU_ACCESS_WRITE;
+    uploadDesc.Usage              = D3D11_USAGE_STAGING;
+    uploadDesc.BindFlags          = 0;
+    m_uploadFrame = m_resourcePool.AcquireTexture(outputDevice.get(), uploadDesc);
+    m_uploadValid = false;
 }
 
-void CaptureBase::CopyStagingToOutput(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
+bool CaptureBase::CopyStagingToOutput(StagingSlot& slot, const winrt::com_ptr<ID3D11Texture2D>& outputTexture, bool wait, const DirtyRegions& changes)
 {
-    m_stagingCopyRequired = false;
+    if(!m_uploadFrame)
+        CreateUploadFrame();
 
-    // map both textures to CPU memory and copy between
-    // we can do this because we are polling so render frame is not used by another thread
+    // map both textures to CPU memory and copy changed regions between,
+    // upload texture keeps its contents so only what changed since the last readback needs to cross
     D3D11_MAPPED_SUBRESOURCE stagingResource;
-    THROW(m_stagingContext->Map(m_stagingFrame.get(), 0, D3D11_MAP_READ, 0, &stagingResource), "Unable to map staging texture");
+    auto                     hr = m_stagingContext->Map(slot.texture.get(), 0, D3D11_MAP_READ, wait ? 0 : D3D11_MAP_FLAG_DO_NOT_WAIT, &stagingResource);
+    if(hr == DXGI_ERROR_WAS_STILL_DRAWING)
+        return false;
+    THROW(hr, "Unable to map staging texture");
+
+    // render adapter may still be copying the last upload out, rather than stall the render thread keep the
+    // slot pending for the next poll; mapped before hashing so the hasher only sees frames that go through
+    D3D11_MAPPED_SUBRESOURCE uploadResource;
+    hr = m_outputContext->Map(m_uploadFrame.get(), 0, D3D11_MAP_WRITE, D3D11_MAP_FLAG_DO_NOT_WAIT, &uploadResource);
+    if(FAILED(hr))
+    {
+        m_stagingContext->Unmap(slot.texture.get(), 0);
+        if(hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            return false;
+        THROW(hr, "Unable to map upload texture");
+    }
+
+    DirtyRegions uploadRegions = changes;
+    if(!m_uploadValid)
+        uploadRegions.SetFull();
+
+    // hashing tiles is cheaper than moving them, and finds what capture API didn't tell us
+    m_frameContent = FrameContent::New;
+    if(m_options.frameHashing)
+    {
+        m_frameContent = m_tileHasher.Hash((const uint8_t*)stagingResource.pData, stagingResource.RowPitch, uploadRegions);
+        if(m_frameContent == FrameContent::Identical && m_uploadValid)
+        {
+            m_stagingContext->Unmap(slot.texture.get(), 0);
+            m_outputContext->Unmap(m_uploadFrame.get(), 0);
+            slot.pending = false;
+            return true;
+        }
+        if(m_frameContent == FrameContent::Partial)
+            uploadRegions = m_tileHasher.GetChangedRegions();
+    }
+
+    // row pitches often differ between vendors, copy row by row in parallel bands
+    const size_t bytesPerPixel = m_options.useHdr ? 8 : 4;
+    for(const auto& rect : uploadRegions.GetRects())
+    {
+        const size_t offsetBytes = rect.left * bytesPerPixel;
+        m_copyEngine.Copy({ (uint8_t*)uploadResource.pData + rect.top * uploadResource.RowPitch + offsetBytes, uploadResource.RowPitch },
+                          { (uint8_t*)stagingResource.pData + rect.top * stagingResource.RowPitch + offsetBytes, stagingResource.RowPitch },
+                          (rect.right - rect.left) * bytesPerPixel,
+                          rect.bottom - rect.top);
+    }
+
+    m_stagingContext->Unmap(slot.texture.get(), 0);
+    m_outputContext->Unmap(m_uploadFrame.get(), 0);
+    m_uploadValid = true;
+
+    // then on the render adapter bring the output slot up to date
+    m_outputDirty.MarkDirty(uploadRegions);
+    auto outputRegions = m_outputDirty.Take(outputTexture.get());
+    if(outputRegions.IsFull())
+    {
+        m_outputContext->CopyResource(outputTexture.get(), m_uploadFrame.get());
+    }
+    else
+    {
+        for(const auto& rect : outputRegions.GetRects())
+        {
+            D3D11_BOX box { (UINT)rect.left, (UINT)rect.top, 0, (UINT)rect.right, (UINT)rect.bottom, 1 };
+            m_outputContext->CopySubresourceRegion(outputTexture.get(), 0, rect.left, rect.top, 0, m_uploadFrame.get(), 0, &box);
+        }
+    }
+    m_watcher.FrameTransferred(uploadRegions.Coverage());
+
+    slot.pending = false;
+    return true;
+}
+
+bool CaptureBase::IsSynthetic()
+{
+    return false;
+}
 
-    D3D11_MAPPED_SUBRESOURCE renderResource;
-    THROW(m_outputContext->Map(outputTexture.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &renderResource), "Unable to map render texture");
+FrameContent CaptureBase::GetFrameContent() const
+{
+    return m_frameContent;
+}
+
+const std::vector<uint8_t>& CaptureBase::GetChangedTiles() const
+{
+    return m_tileHasher.GetChangedTiles();
+}
 
-    if(stagingResource.DepthPitch == renderResource.DepthPitch)
+void CaptureBase::CopyRegions(ID3D11DeviceContext* context, ID3D11Texture2D* output, ID3D11Texture2D* source, int width, int height, const DirtyRegions& regions)
+{
+    if(regions.IsFull())
     {
-        // copy between mapped textures
-        memcpy(renderResource.pData, stagingResource.pData, stagingResource.DepthPitch);
+        CopyTrimToOutputSize(context, output, source, width, height);
+        return;
     }
 
-    m_stagingContext->Unmap(m_stagingFrame.get(), 0);
-    m_outputContext->Unmap(outputTexture.get(), 0);
+    // regions are in output coordinates and already clipped to the captured frame
+    for(const auto& rect : regions.GetRects())
+    {
+        D3D11_BOX box;
+        box.left   = rect.left - m_windowX;
+        box.top    = rect.top - m_windowY;
+        box.right  = rect.right - m_windowX;
+        box.bottom = rect.bottom - m_windowY;
+        box.front  = 0;
+        box.back   = 1;
+        context->CopySubresourceRegion(output, 0, rect.left, rect.top, 0, source, 0, &box);
+    }
 }
 
 void CaptureBase::CopyTrimToOutputSize(ID3D11DeviceContext* context, ID3D11Texture2D* output, ID3D11Texture2D* source, int width, int height)
 {
-    if(width == m_options.outputWidth && height == m_options.outputHeight && m_windowX == 0 && m_windowY == 0)
+    const int inputWidth  = m_options.inputWidth;
+    const int inputHeight = m_options.inputHeight;
+    if(width == inputWidth && height == inputHeight && m_windowX == 0 && m_windowY == 0)
     {
         context->CopyResource(output, source);
     }
     else
     {
-        // truncate if monitor sizes differ
+        // truncate if monitor sizes differ, or window hangs off the edge of the input area
         D3D11_BOX box;
-        box.left   = 0;
-        box.top    = 0;
-        box.right  = min(m_options.outputWidth - m_windowX, (unsigned)width);
-        box.bottom = min(m_options.outputHeight - m_windowY, (unsigned)height);
+        box.left   = max(-m_windowX, 0);
+        box.top    = max(-m_windowY, 0);
+        box.right  = min(inputWidth - m_windowX, width);
+        box.bottom = min(inputHeight - m_windowY, height);
         box.front  = 0;
         box.back   = 1;
-        context->CopySubresourceRegion(output, 0, m_windowX, m_windowY, 0, source, 0, &box);
+        if((int)box.right > (int)box.left && (int)box.bottom > (int)box.top)
+            context->CopySubresourceRegion(output, 0, m_windowX + box.left, m_windowY + box.top, 0, source, 0, &box);
     }
 }
 
@@ -9,29 +9,54 @@ MIT License
 
 #include "Common.h"
 #include "Watcher.h"
+#include "CopyEngine.h"
+#include "DirtyRegions.h"
+#include "TileHasher.h"
+#include "GPUTileHasher.h"
+#include "ResourcePool.h"
 
 namespace ShaderBeam
 {
 
+#define MAX_READBACK_DEPTH 4
+
+// one CPU-readable copy of a captured frame, in flight until its query signals
+struct StagingSlot
+{
+    winrt::com_ptr<ID3D11Texture2D> texture;
+    winrt::com_ptr<ID3D11Query>     query;
+    bool                            pending { false };
+    uint64_t                        sequence { 0 };
+    DirtyRegions                    changes; // since previous slot was filled
+};
+
 class CaptureBase
 {
 public:
     // device is the device to capture using
     // frame & context are in device used to process
-    CaptureBase(Watcher& watcher, const Options& options);
+    CaptureBase(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool);
     void Start(winrt::com_ptr<IDXGIDevice> captureDevice, winrt::com_ptr<ID3D11DeviceContext> outputContext);
     void BenchmarkCopy(const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
+    // CPU side of the cross-adapter copy alone on input-sized memory, in GB/s
+    double BenchmarkCPUCopy();
     void Stop();
     bool Poll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
 
     virtual bool IsSupported()           = 0;
     virtual bool SupportsWindowCapture() = 0;
+    virtual bool IsSynthetic();
+
+    // content of the last frame as found by tile hashing
+    FrameContent                GetFrameContent() const;
+    const std::vector<uint8_t>& GetChangedTiles() const;
 
     const char* m_name;
 
 protected:
     Watcher&                    m_watcher;
     const Options&              m_options;
+    ResourcePool&               m_resourcePool;
     volatile bool               m_stopping { false };
     winrt::com_ptr<IDXGIDevice> m_captureDevice;
 
@@ -39,7 +64,16 @@ protected:
     virtual bool InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture) = 0;
     virtual void InternalStop()                                                     = 0;
 
-    void CopyToOutput(const winrt::com_ptr<ID3D11Texture2D>& capturedFrame, int width, int height, const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
+    // changedRects are in captured frame coordinates, nullptr when the whole frame changed;
+    // false when the frame turned out identical to the previous one and shouldn't be shown as new
+    bool CopyToOutput(const winrt::com_ptr<ID3D11Texture2D>& capturedFrame,
+                      int                                    width,
+                      int                                    height,
+                      const winrt::com_ptr<ID3D11Texture2D>& outputTexture,
+                      const std::vector<DirtyRect>*          changedRects = nullptr);
+
+    // frame already in CPU memory in the input format (e.g. a mapped file), goes straight to the output texture
+    void UploadToOutput(const uint8_t* data, size_t pitch, int width, int height, const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
 
 private:
     winrt::com_ptr<ID3D11DeviceContext> m_outputContext;
@@ -47,13 +81,28 @@ private:
     // for copying between devices
     winrt::com_ptr<ID3D11Device>        m_stagingDevice;
     winrt::com_ptr<ID3D11DeviceContext> m_stagingContext;
-    winrt::com_ptr<ID3D11Texture2D>     m_stagingFrame;
-    bool                                m_stagingCopyRequired { false };
-    int                                 m_windowX { 0 };
+    winrt::com_ptr<ID3D11Texture2D>     m_uploadFrame; // render adapter side of CPU copy, keeps last frame
+    bool                                m_uploadValid { false };
+    std::vector<StagingSlot>            m_stagingRing;
+    unsigned                            m_nextStagingSlot { 0 };
+    uint64_t                            m_stagingSequence { 0 };
+    CopyEngine                          m_copyEngine;
+    TileHasher                          m_tileHasher;
+    GPUTileHasher                       m_gpuTileHasher; // same adapter, hashes output slots where they are
+    std::vector<uint64_t>               m_gpuHashes;
+    FrameContent                        m_frameContent { FrameContent::New };
+    DirtyTracker                        m_outputDirty;
+    DirtyTracker                        m_stagingDirty;
+    int                                 m_windowX { 0 }; // captured window position within input textures
     int                                 m_windowY { 0 };
 
     void CopyTrimToOutputSize(ID3D11DeviceContext* context, ID3D11Texture2D* output, ID3D11Texture2D* source, int width, int height);
-    void CopyStagingToOutput(const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
+    void CopyRegions(ID3D11DeviceContext* context, ID3D11Texture2D* output, ID3D11Texture2D* source, int width, int height, const DirtyRegions& regions);
+    void CreateUploadFrame();
+    void CreateStagingRing();
+    FrameContent HashOnGPU(ID3D11Texture2D* outputTexture);
+    bool ReadbackStaging(const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
+    bool CopyStagingToOutput(StagingSlot& slot, const winrt::com_ptr<ID3D11Texture2D>& outputTexture, bool wait, const DirtyRegions& changes);
 };
 
 } // namespace ShaderBeam
\ No newline at end of file
@@ -13,7 +13,8 @@ MIT License
 namespace ShaderBeam
 {
 
-CaptureDD::CaptureDD(Watcher& watcher, const Options& options) : CaptureBase(watcher, options), m_watcher(watcher)
+CaptureDD::CaptureDD(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool) :
+    CaptureBase(watcher, options, workerPool, resourcePool), m_watcher(watcher)
 {
     m_name = "Desktop Duplication";
 }
@@ -52,6 +53,9 @@ void CaptureDD::InternalStart()
         throw std::runtime_error("Unable to find IDXGIOutput for this monitor, wrong GPU?");
 
     THROW(m_capturedOutput->DuplicateOutput(m_captureDevice.get(), m_desktopDuplication.put()), "Unable to start Desktop Duplication");
+
+    // DD holds a single frame at a time
+    m_watcher.GetCaptureStats().Reset(1);
 }
 
 void CaptureDD::InternalStop()
@@ -70,10 +74,27 @@ bool CaptureDD::InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTextur
     DXGI_OUTDUPL_FRAME_INFO       frameInfo;
     winrt::com_ptr<IDXGIResource> resource;
 
-    auto hr = m_desktopDuplication->AcquireNextFrame(0, &frameInfo, resource.put());
+    const auto now   = Helpers::GetTicks();
+    auto&      stats = m_watcher.GetCaptureStats();
+    auto       hr    = m_desktopDuplication->AcquireNextFrame(0, &frameInfo, resource.put());
+    stats.Polled(now, hr == S_OK && frameInfo.LastPresentTime.QuadPart != 0 ? 1 : 0);
     if(hr == S_OK)
     {
-        m_watcher.FrameReceived(Helpers::QPCToTicks(frameInfo.LastPresentTime.QuadPart));
+        if(frameInfo.LastPresentTime.QuadPart == 0)
+        {
+            // only the mouse pointer moved, nothing new to show
+            THROW(m_desktopDuplication->ReleaseFrame(), "Unable to Release Frame");
+            return false;
+        }
+
+        // DD keeps only the latest image, presents since the previous one we acquired are gone
+        if(frameInfo.AccumulatedFrames > 1)
+            stats.FramesMissed(frameInfo.AccumulatedFrames - 1);
+
+        auto presented = Helpers::QPCToTicks(frameInfo.LastPresentTime.QuadPart);
+        m_watcher.FrameReceived(presented);
+        stats.FrameArrived(now, presented);
+        stats.FrameDelivered();
 
         auto texture = resource.as<ID3D11Texture2D>();
         if(m_width == 0 || m_height == 0)
@@ -84,10 +105,10 @@ bool CaptureDD::InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTextur
             m_height = desc.Height;
         }
 
-        CopyToOutput(texture, m_width, m_height, outputTexture);
+        auto newFrame = CopyToOutput(texture, m_width, m_height, outputTexture, GetChangedRects(frameInfo));
 
         THROW(m_desktopDuplication->ReleaseFrame(), "Unable to Release Frame");
-        return true;
+        return newFrame;
     }
     else if(hr == DXGI_ERROR_WAIT_TIMEOUT)
     {
@@ -99,4 +120,42 @@ bool CaptureDD::InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTextur
     }
     return false;
 }
+
+const std::vector<DirtyRect>* CaptureDD::GetChangedRects(const DXGI_OUTDUPL_FRAME_INFO& frameInfo)
+{
+    m_changedRects.clear();
+    if(frameInfo.TotalMetadataBufferSize == 0)
+    {
+        return nullptr;
+    }
+
+    if(m_metadata.size() < frameInfo.TotalMetadataBufferSize)
+        m_metadata.resize(frameInfo.TotalMetadataBufferSize);
+
+    // move rects first, their destinations changed; dirty rects go into the rest of the buffer
+    UINT moveBytes = 0;
+    if(FAILED(m_desktopDuplication->GetFrameMoveRects((UINT)m_metadata.size(), (DXGI_OUTDUPL_MOVE_RECT*)m_metadata.data(), &moveBytes)))
+        return nullptr;
+
+    auto moveRects = (const DXGI_OUTDUPL_MOVE_RECT*)m_metadata.data();
+    for(UINT i = 0; i < moveBytes / sizeof(DXGI_OUTDUPL_MOVE_RECT); i++)
+    {
+        const auto& r = moveRects[i].DestinationRect;
+        m_changedRects.push_back({ r.left, r.top, r.right, r.bottom });
+    }
+
+    UINT dirtyBytes = 0;
+    if(FAILED(m_desktopDuplication->GetFrameDirtyRects((UINT)m_metadata.size() - moveBytes, (RECT*)(m_metadata.data() + moveBytes), &dirtyBytes)))
+        return nullptr;
+
+    auto dirtyRects = (const RECT*)(m_metadata.data() + moveBytes);
+    for(UINT i = 0; i < dirtyBytes / sizeof(RECT); i++)
+    {
+        const auto& r = dirtyRects[i];
+        m_changedRects.push_back({ r.left, r.top, r.right, r.bottom });
+    }
+
+    return &m_changedRects;
+}
+
 } // namespace ShaderBeam
@@ -16,7 +16,7 @@ namespace ShaderBeam
 class CaptureDD : public CaptureBase
 {
 public:
-    CaptureDD(Watcher& watcher, const Options& options);
+    CaptureDD(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool);
 
     bool IsSupported();
     bool SupportsWindowCapture();
@@ -33,5 +33,9 @@ private:
     winrt::com_ptr<IDXGIOutputDuplication> m_desktopDuplication;
     unsigned                               m_width { 0 };
     unsigned                               m_height { 0 };
+    std::vector<uint8_t>                   m_metadata;
+    std::vector<DirtyRect>                 m_changedRects;
+
+    const std::vector<DirtyRect>* GetChangedRects(const DXGI_OUTDUPL_FRAME_INFO& frameInfo);
 };
 } // namespace ShaderBeam
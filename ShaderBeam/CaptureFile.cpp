@@ -0,0 +1,107 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "CaptureFile.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+// Y4M conversion is split into bands of this many rows across the worker pool
+static constexpr unsigned FILE_BAND_ROWS = 32;
+
+CaptureFile::CaptureFile(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool) :
+    CaptureBase(watcher, options, workerPool, resourcePool), m_workerPool(workerPool)
+{
+    m_name = "File";
+}
+
+bool CaptureFile::IsSupported()
+{
+    return true;
+}
+
+bool CaptureFile::SupportsWindowCapture()
+{
+    return false;
+}
+
+bool CaptureFile::IsSynthetic()
+{
+    return true;
+}
+
+void CaptureFile::InternalStart()
+{
+    // raw frames are stored in the input format so they can be uploaded as they are
+    m_file.Open(m_options.captureFile, m_options.fileWidth, m_options.fileHeight, m_options.useHdr ? 8 : 4);
+    if(m_file.IsY4M() && m_options.useHdr)
+    {
+        m_file.Close();
+        throw std::runtime_error("Y4M playback needs HDR off, use a raw RGBA16F file instead");
+    }
+    if(m_file.IsY4M())
+        m_converted.resize((size_t)m_file.GetWidth() * m_file.GetHeight() * 4);
+
+    double frameRate = m_options.fileFrameRate;
+    if(frameRate <= 0)
+        frameRate = m_file.GetFrameRate();
+    if(frameRate <= 0)
+        frameRate = 60;
+
+    m_frameDuration = (float)(TICKS_PER_SEC / frameRate);
+    m_startTicks    = Helpers::GetTicks();
+    m_lastFrameNo   = -1;
+}
+
+void CaptureFile::InternalStop()
+{
+    m_file.Close();
+    m_converted.clear();
+}
+
+bool CaptureFile::InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
+{
+    if(!m_file.IsOpen())
+        return false;
+
+    // frames are due on a fixed clock, like a game presenting at that rate; late polls skip ahead
+    auto frameNo = (int64_t)((Helpers::GetTicks() - m_startTicks) / m_frameDuration);
+    if(frameNo == m_lastFrameNo)
+        return false;
+
+    const auto numFrames = m_file.GetNumFrames();
+    if(frameNo >= numFrames && !m_options.fileLoop)
+    {
+        if(m_lastFrameNo == numFrames - 1)
+            return false;
+        frameNo = numFrames - 1;
+    }
+    m_lastFrameNo = frameNo;
+    m_watcher.FrameReceived(m_startTicks + frameNo * m_frameDuration);
+
+    const auto index = (unsigned)(frameNo % numFrames);
+    if(m_file.IsY4M())
+    {
+        const unsigned height   = m_file.GetHeight();
+        const unsigned numBands = (height + FILE_BAND_ROWS - 1) / FILE_BAND_ROWS;
+        m_workerPool.Run(numBands, [&](unsigned band) {
+            const unsigned firstRow = band * FILE_BAND_ROWS;
+            m_file.ConvertRows(index, m_converted.data(), m_file.GetWidth() * 4, firstRow, std::min(FILE_BAND_ROWS, height - firstRow));
+        });
+        UploadToOutput(m_converted.data(), m_file.GetWidth() * 4, m_file.GetWidth(), m_file.GetHeight(), outputTexture);
+    }
+    else
+    {
+        UploadToOutput(m_file.GetFrame(index), m_file.GetPitch(), m_file.GetWidth(), m_file.GetHeight(), outputTexture);
+    }
+    return true;
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,40 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "CaptureBase.h"
+#include "FrameFile.h"
+#include "Watcher.h"
+
+namespace ShaderBeam
+{
+
+// plays back a recorded clip instead of the desktop, for reproducible benchmarks and pacing runs
+class CaptureFile : public CaptureBase
+{
+public:
+    CaptureFile(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool);
+
+    bool IsSupported();
+    bool SupportsWindowCapture();
+    bool IsSynthetic();
+
+protected:
+    void InternalStart();
+    bool InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
+    void InternalStop();
+
+private:
+    WorkerPool&          m_workerPool;
+    FrameFile            m_file;
+    float                m_startTicks { 0 };
+    float                m_frameDuration { 0 };
+    int64_t              m_lastFrameNo { -1 };
+    std::vector<uint8_t> m_converted; // Y4M frames only, raw ones upload straight from the mapping
+};
+} // namespace ShaderBeam
@@ -0,0 +1,152 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "CaptureStats.h"
+
+#include <algorithm>
+
+namespace ShaderBeam
+{
+
+Histogram::Histogram(float binWidth) : m_binWidth(binWidth) { }
+
+void Histogram::Add(float value)
+{
+    const auto bin = value > 0 ? std::min((unsigned)(value / m_binWidth), HISTOGRAM_BINS - 1) : 0;
+    m_bins[bin]++;
+    m_count++;
+    m_sum += value;
+}
+
+void Histogram::Reset()
+{
+    m_bins.fill(0);
+    m_count = 0;
+    m_sum   = 0;
+}
+
+uint32_t Histogram::GetCount() const
+{
+    return m_count;
+}
+
+float Histogram::GetBinWidth() const
+{
+    return m_binWidth;
+}
+
+const std::array<uint32_t, HISTOGRAM_BINS>& Histogram::GetBins() const
+{
+    return m_bins;
+}
+
+float Histogram::Average() const
+{
+    return m_count ? (float)(m_sum / m_count) : 0;
+}
+
+float Histogram::Percentile(float percentile) const
+{
+    if(!m_count)
+        return 0;
+
+    const auto target = (uint32_t)(percentile * (m_count - 1)) + 1;
+    uint32_t   seen   = 0;
+    for(unsigned bin = 0; bin < HISTOGRAM_BINS; bin++)
+    {
+        seen += m_bins[bin];
+        if(seen >= target)
+            return (bin + 1) * m_binWidth;
+    }
+    return HISTOGRAM_BINS * m_binWidth;
+}
+
+// 1 ms bins cover up to 32 ms frame times and latencies, polls happen at least every vsync so need finer ones
+CaptureStats::CaptureStats() : m_latency(1.0f), m_frameInterval(1.0f), m_pollInterval(0.25f), m_occupancy(1.0f) { }
+
+void CaptureStats::Reset(unsigned poolSize)
+{
+    ClearWindow();
+    m_poolSize      = poolSize;
+    m_lastPoll      = -1;
+    m_lastPresented = -1;
+}
+
+void CaptureStats::ClearWindow()
+{
+    m_counters = {};
+    m_latency.Reset();
+    m_frameInterval.Reset();
+    m_pollInterval.Reset();
+    m_occupancy.Reset();
+}
+
+void CaptureStats::Polled(float now, unsigned queued)
+{
+    m_counters.polls++;
+    if(!queued)
+        m_counters.emptyPolls++;
+    if(m_lastPoll >= 0)
+        m_pollInterval.Add(now - m_lastPoll);
+    m_lastPoll = now;
+    m_occupancy.Add((float)queued);
+}
+
+void CaptureStats::FrameArrived(float now, float presented)
+{
+    m_latency.Add(now - presented);
+    if(m_lastPresented >= 0 && presented > m_lastPresented)
+        m_frameInterval.Add(presented - m_lastPresented);
+    m_lastPresented = presented;
+}
+
+void CaptureStats::FrameDelivered()
+{
+    m_counters.delivered++;
+}
+
+void CaptureStats::FramesCoalesced(unsigned count)
+{
+    m_counters.coalesced += count;
+}
+
+void CaptureStats::FramesMissed(unsigned count)
+{
+    m_counters.missed += count;
+}
+
+const CaptureCounters& CaptureStats::GetCounters() const
+{
+    return m_counters;
+}
+
+unsigned CaptureStats::GetPoolSize() const
+{
+    return m_poolSize;
+}
+
+const Histogram& CaptureStats::GetLatency() const
+{
+    return m_latency;
+}
+
+const Histogram& CaptureStats::GetFrameInterval() const
+{
+    return m_frameInterval;
+}
+
+const Histogram& CaptureStats::GetPollInterval() const
+{
+    return m_pollInterval;
+}
+
+const Histogram& CaptureStats::GetOccupancy() const
+{
+    return m_occupancy;
+}
+
+} // namespace ShaderBeam
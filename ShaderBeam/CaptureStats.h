@@ -0,0 +1,91 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <array>
+#include <cstdint>
+
+namespace ShaderBeam
+{
+
+constexpr unsigned HISTOGRAM_BINS = 32;
+
+// fixed-width bins from 0, last bin also takes everything above
+class Histogram
+{
+public:
+    explicit Histogram(float binWidth = 1.0f);
+
+    void Add(float value);
+    void Reset();
+
+    uint32_t                                     GetCount() const;
+    float                                        GetBinWidth() const;
+    const std::array<uint32_t, HISTOGRAM_BINS>& GetBins() const;
+    float                                        Average() const;
+
+    // upper edge of the bin holding that share of samples
+    float Percentile(float percentile) const;
+
+private:
+    std::array<uint32_t, HISTOGRAM_BINS> m_bins {};
+    uint32_t                             m_count { 0 };
+    double                               m_sum { 0 };
+    float                                m_binWidth;
+};
+
+struct CaptureCounters
+{
+    uint32_t polls { 0 };
+    uint32_t emptyPolls { 0 }; // nothing new from capture API
+    uint32_t delivered { 0 }; // frames that made it to inputs
+    uint32_t coalesced { 0 }; // queued by capture API, superseded by a newer one in the same poll
+    uint32_t missed { 0 }; // game presents the capture API folded into one frame
+};
+
+// tells apart where stutter comes from: game cadence (frame interval), capture API (latency, missed, queue)
+// or our polling (poll interval, coalesced); times are in ticks
+class CaptureStats
+{
+public:
+    CaptureStats();
+
+    void Reset(unsigned poolSize);
+
+    // starts a new measurement window, keeps what's needed for intervals
+    void ClearWindow();
+
+    // queued = frames capture API had waiting at this poll
+    void Polled(float now, unsigned queued);
+
+    // presented = when the game presented it, by capture API clock
+    void FrameArrived(float now, float presented);
+    void FrameDelivered();
+    void FramesCoalesced(unsigned count);
+    void FramesMissed(unsigned count);
+
+    const CaptureCounters& GetCounters() const;
+    unsigned               GetPoolSize() const;
+    const Histogram&       GetLatency() const;
+    const Histogram&       GetFrameInterval() const;
+    const Histogram&       GetPollInterval() const;
+    const Histogram&       GetOccupancy() const;
+
+private:
+    CaptureCounters m_counters;
+    unsigned        m_poolSize { 0 };
+    Histogram       m_latency;
+    Histogram       m_frameInterval;
+    Histogram       m_pollInterval;
+    Histogram       m_occupancy;
+    float           m_lastPoll { -1 };
+    float           m_lastPresented { -1 };
+};
+} // namespace ShaderBeam
@@ -0,0 +1,95 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "CaptureTestPattern.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+// jitter and drops are derived from the frame number, so every run misbehaves the same way
+static uint32_t HashFrame(uint32_t frameNo, uint32_t salt)
+{
+    uint64_t h = (frameNo + ((uint64_t)salt << 32)) * 0x9e3779b97f4a7c15ull;
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ull;
+    return (uint32_t)(h >> 32);
+}
+
+CaptureTestPattern::CaptureTestPattern(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool) :
+    CaptureBase(watcher, options, workerPool, resourcePool), m_pattern(workerPool)
+{
+    m_name = "Test Pattern";
+}
+
+bool CaptureTestPattern::IsSupported()
+{
+    return true;
+}
+
+bool CaptureTestPattern::SupportsWindowCapture()
+{
+    return false;
+}
+
+bool CaptureTestPattern::IsSynthetic()
+{
+    return true;
+}
+
+void CaptureTestPattern::InternalStart()
+{
+    m_pattern.Reset(m_options.inputWidth, m_options.inputHeight, m_options.useHdr ? 8 : 4, m_options.testPattern, (float)m_options.testPatternSpeed);
+    m_frameDuration = TICKS_PER_SEC / max(m_options.testPatternRate, 1);
+    m_startTicks    = Helpers::GetTicks();
+    m_nextFrameNo   = 0;
+}
+
+void CaptureTestPattern::InternalStop() { }
+
+float CaptureTestPattern::GetDueTicks(uint32_t frameNo) const
+{
+    // shifted by up to half the jitter either way, content itself stays on the nominal timeline
+    const float jitter = std::clamp(m_options.testPatternJitter, 0, 100) / 100.0f;
+    const float shift  = (HashFrame(frameNo, 1) / 4294967296.0f - 0.5f) * jitter;
+    return m_startTicks + (frameNo + shift) * m_frameDuration;
+}
+
+bool CaptureTestPattern::IsDropped(uint32_t frameNo) const
+{
+    return HashFrame(frameNo, 2) % 100 < (uint32_t)std::clamp(m_options.testPatternDrops, 0, 100);
+}
+
+bool CaptureTestPattern::InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture)
+{
+    // find the newest frame that's due and wasn't dropped, late polls skip ahead like a real capture would
+    const auto now       = Helpers::GetTicks();
+    bool       due       = false;
+    uint32_t   frameNo   = 0;
+    float      frameTime = 0;
+    while(now >= GetDueTicks(m_nextFrameNo))
+    {
+        if(!IsDropped(m_nextFrameNo))
+        {
+            due       = true;
+            frameNo   = m_nextFrameNo;
+            frameTime = GetDueTicks(m_nextFrameNo);
+        }
+        m_nextFrameNo++;
+    }
+    if(!due)
+        return false;
+
+    m_watcher.FrameReceived(frameTime);
+    m_pattern.Render(frameNo, frameNo * (double)m_frameDuration / TICKS_PER_SEC);
+    UploadToOutput(m_pattern.GetData(), m_pattern.GetPitch(), m_options.inputWidth, m_options.inputHeight, outputTexture);
+    return true;
+}
+
+} // namespace ShaderBeam
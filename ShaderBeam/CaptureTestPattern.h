@@ -0,0 +1,41 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "CaptureBase.h"
+#include "TestPattern.h"
+#include "Watcher.h"
+
+namespace ShaderBeam
+{
+
+// generates TestUFO-style motion instead of capturing, so throughput and clarity can be checked without a game
+class CaptureTestPattern : public CaptureBase
+{
+public:
+    CaptureTestPattern(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool);
+
+    bool IsSupported();
+    bool SupportsWindowCapture();
+    bool IsSynthetic();
+
+protected:
+    void InternalStart();
+    bool InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTexture);
+    void InternalStop();
+
+private:
+    TestPattern m_pattern;
+    float       m_startTicks { 0 };
+    float       m_frameDuration { 0 };
+    uint32_t    m_nextFrameNo { 0 };
+
+    float GetDueTicks(uint32_t frameNo) const;
+    bool  IsDropped(uint32_t frameNo) const;
+};
+} // namespace ShaderBeam
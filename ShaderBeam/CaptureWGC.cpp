@@ -16,7 +16,7 @@ MIT License
 namespace ShaderBeam
 {
 
-CaptureWGC::CaptureWGC(Watcher& watcher, const Options& options) : CaptureBase(watcher, options)
+CaptureWGC::CaptureWGC(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool) : CaptureBase(watcher, options, workerPool, resourcePool)
 {
     m_name = "Windows Graphics Capture";
 }
@@ -51,6 +51,7 @@ void CaptureWGC::InternalStart()
     auto contentSize = item.Size();
 
     m_framePool = winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool::Create(CreateDirect3DDevice(m_captureDevice.get()), format, m_options.wgcBuffers, contentSize);
+    m_watcher.GetCaptureStats().Reset(m_options.wgcBuffers);
 
     if(m_options.gpuThreadPriority)
         m_captureDevice->SetGPUThreadPriority(m_options.gpuThreadPriority | 0x40000000);
@@ -90,27 +91,30 @@ bool CaptureWGC::InternalPoll(const winrt::com_ptr<ID3D11Texture2D>& outputTextu
         return false;
     }
 
-    auto frame = m_framePool.TryGetNextFrame();
-    if(frame)
+    // take everything queued, only the newest frame goes to inputs
+    const auto                                                now    = Helpers::GetTicks();
+    auto&                                                     stats  = m_watcher.GetCaptureStats();
+    unsigned                                                  queued = 0;
+    winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame frame { nullptr };
+    for(auto next = m_framePool.TryGetNextFrame(); next; next = m_framePool.TryGetNextFrame())
     {
-        // take everything queued
-        auto newerFrame = m_framePool.TryGetNextFrame();
-        while(newerFrame)
-        {
-            swap(frame, newerFrame);
-            auto timestamp = frame.SystemRelativeTime();
-            m_watcher.FrameReceived(Helpers::QPCToTicks(timestamp.count()));
-            newerFrame = m_framePool.TryGetNextFrame();
-        }
-
-        auto texture   = GetDXGIInterfaceFromObject<ID3D11Texture2D>(frame.Surface());
-        auto size      = frame.ContentSize();
-        auto timestamp = frame.SystemRelativeTime();
-        m_watcher.FrameReceived(Helpers::QPCToTicks(timestamp.count()));
-        CopyToOutput(texture, size.Width, size.Height, outputTexture);
-        return true;
+        frame          = next;
+        auto presented = Helpers::QPCToTicks(frame.SystemRelativeTime().count());
+        m_watcher.FrameReceived(presented);
+        stats.FrameArrived(now, presented);
+        queued++;
     }
-    return false;
+    stats.Polled(now, queued);
+    if(!frame)
+        return false;
+
+    if(queued > 1)
+        stats.FramesCoalesced(queued - 1);
+    stats.FrameDelivered();
+
+    auto texture = GetDXGIInterfaceFromObject<ID3D11Texture2D>(frame.Surface());
+    auto size    = frame.ContentSize();
+    return CopyToOutput(texture, size.Width, size.Height, outputTexture);
 }
 
 template <typename T>
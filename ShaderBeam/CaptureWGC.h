@@ -16,7 +16,7 @@ namespace ShaderBeam
 class CaptureWGC : public CaptureBase
 {
 public:
-    CaptureWGC(Watcher& watcher, const Options& options);
+    CaptureWGC(Watcher& watcher, const Options& options, WorkerPool& workerPool, ResourcePool& resourcePool);
 
     bool IsSupported();
     bool SupportsWindowCapture();
@@ -13,107 +13,154 @@ MIT License
 namespace ShaderBeam
 {
 
-#define CHARTS_H 256
-#define CHARTS_W (CHARTS_LEN + 1)
-#define CHART_H 128
+#define CHARTS_W (CHARTS_LEN + 1) // room for the cursor after the last column
+#define CHARTS_H (CHART_SERIES * CHART_H)
+#define CHARTS_HDR_BRIGHTNESS 2.5f // 200 nits
 
 Charts::Charts(const Options& options, Watcher& watcher) : m_options(options), m_watcher(watcher) { }
 
-void Charts::Create(winrt::com_ptr<ID3D11Device> device, winrt::com_ptr<ID3D11DeviceContext> context)
+void Charts::Create(const RenderContext& renderContext)
 {
-    m_device  = device;
-    m_context = context;
-    m_chartsBuffer.resize(CHARTS_W * CHARTS_H);
-
-    D3D11_TEXTURE2D_DESC desc {};
-    desc.Width              = CHARTS_W;
-    desc.Height             = CHARTS_H;
-    desc.ArraySize          = 1;
-    desc.Format             = DXGI_FORMAT_B8G8R8A8_UNORM;
-    desc.SampleDesc.Count   = 1;
-    desc.SampleDesc.Quality = 0;
-    desc.MipLevels          = 1;
-    desc.MiscFlags          = 0;
-    desc.Usage              = D3D11_USAGE_DEFAULT;
-    desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
-
-    D3D11_SUBRESOURCE_DATA initialData {};
-    initialData.pSysMem     = m_chartsBuffer.data();
-    initialData.SysMemPitch = CHARTS_W * 4;
-
-    THROW(m_device->CreateTexture2D(&desc, &initialData, m_chartsTexture.put()), "Unable to create charting texture");
+    auto vertexCode = Helpers::CompileShader(L"Shaders\\Charts.hlsl", nullptr, "VSmain", "vs_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreateVertexShader(vertexCode.data(), vertexCode.size(), NULL, m_vertexShader.put()), "Unable to create vertex shader");
+    auto pixelCode = Helpers::CompileShader(L"Shaders\\Charts.hlsl", nullptr, "PSmain", "ps_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreatePixelShader(pixelCode.data(), pixelCode.size(), NULL, m_pixelShader.put()), "Unable to create pixel shader");
+
+    m_samples.assign(CHARTS_LEN * CHART_SERIES, 0.0f);
+
+    D3D11_BUFFER_DESC sampleDesc {};
+    sampleDesc.ByteWidth = (UINT)(m_samples.size() * sizeof(float));
+    sampleDesc.Usage     = D3D11_USAGE_DEFAULT;
+    sampleDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    // a pooled buffer may still hold the previous session's samples
+    m_resources    = renderContext.resources;
+    m_sampleBuffer = m_resources->AcquireBuffer(renderContext.device.get(), sampleDesc);
+    renderContext.deviceContext->UpdateSubresource(m_sampleBuffer.get(), 0, nullptr, m_samples.data(), 0, 0);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc {};
+    viewDesc.Format              = DXGI_FORMAT_R32_FLOAT;
+    viewDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+    viewDesc.Buffer.FirstElement = 0;
+    viewDesc.Buffer.NumElements  = (UINT)m_samples.size();
+    THROW(renderContext.device->CreateShaderResourceView(m_sampleBuffer.get(), &viewDesc, m_sampleView.put()), "Unable to create charts view");
+
+    D3D11_BUFFER_DESC constantDesc {};
+    constantDesc.ByteWidth = sizeof(ChartConstants);
+    constantDesc.Usage     = D3D11_USAGE_DEFAULT;
+    constantDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    m_constantBuffer       = m_resources->AcquireBuffer(renderContext.device.get(), constantDesc);
+
+    // rings keep their read position across restarts, start drawing from what's there now
+    for(const auto& series : GetSeries())
+    {
+        int   index;
+        float value;
+        while(series.chart->Read(index, value)) { }
+    }
 }
 
 void Charts::Destroy()
 {
-    m_chartsTexture = nullptr;
-    m_context       = nullptr;
-    m_device        = nullptr;
-    m_chartsBuffer.clear();
-}
-
-void Charts::Render(const winrt::com_ptr<ID3D11Texture2D>& texture, int bottom)
-{
-    Update();
-
-    if(m_options.useHdr)
-        return;
-
-    D3D11_BOX box {};
-    box.top    = 0;
-    box.left   = 0;
-    box.right  = CHARTS_W;
-    box.bottom = CHARTS_H;
-    box.front  = 0;
-    box.back   = 1;
-    m_context->CopySubresourceRegion(texture.get(), 0, 0, bottom - CHARTS_H, 0, m_chartsTexture.get(), 0, &box);
+    m_sampleView = nullptr;
+    if(m_resources)
+    {
+        m_resources->Release(m_sampleBuffer);
+        m_resources->Release(m_constantBuffer);
+    }
+    m_pixelShader  = nullptr;
+    m_vertexShader = nullptr;
+    m_samples.clear();
 }
 
-int Charts::Clamp(float v, float min, float max, int resolution)
+std::vector<Charts::Series> Charts::GetSeries() const
 {
-    return (int)(std::clamp((v - min) / (max - min), 0.0f, 1.0f) * resolution);
+    // top to bottom, in ms
+    return {
+        { &m_watcher.m_receiveChart, 0.0f, 50.0f },
+        { &m_watcher.m_submitChart, 0.0f, 50.0f },
+        { &m_watcher.m_presentChart, 0.0f, 50.0f },
+        { &m_watcher.m_pollChart, 0.0f, 5.0f },
+        { &m_watcher.m_phaseChart, 0.0f, max(m_options.vsyncDuration, 1.0f) },
+    };
 }
 
-void Charts::Update(Chart& chart, int y, float min, float max)
+void Charts::Update(const RenderContext& renderContext)
 {
-    int   index;
-    float value;
-    while(chart.Read(index, value))
+    // new samples of all series as one range of columns, a ring that wrapped makes it the whole buffer
+    int        first = CHARTS_LEN;
+    int        last  = -1;
+    const auto all   = GetSeries();
+    for(int no = 0; no < CHART_SERIES; no++)
     {
-        int       height = CHART_H - Clamp(value - min, 0, max - min, CHARTS_H);
-        uint32_t* start  = m_chartsBuffer.data() + index;
-        uint32_t* ptr    = start;
-        for(int y = 0; y < height; y++)
+        const auto& series = all[no];
+        int         index;
+        float       value;
+        int         previous = -1;
+        while(series.chart->Read(index, value))
         {
-            *ptr++ = 0xffffffff;
-            *ptr   = 0xffff3333;
-            ptr += CHARTS_W - 1;
-        }
-        for(int y = 0; y < CHART_H - height; y++)
-        {
-            *ptr++ = 0xff3333ff;
-            *ptr   = 0xffff3333;
-            ptr += CHARTS_W - 1;
+            m_samples[index * CHART_SERIES + no] = value;
+            if(previous >= 0 && index < previous)
+            {
+                first = 0;
+                last  = CHARTS_LEN - 1;
+            }
+            first    = min(first, index);
+            last     = max(last, index);
+            previous = index;
         }
 
+        m_constants.series[no][0] = series.min;
+        m_constants.series[no][1] = series.max;
+        m_constants.series[no][2] = (float)series.chart->m_index;
+        m_constants.series[no][3] = 0.0f;
+    }
+
+    if(last >= first)
+    {
         D3D11_BOX box {};
-        box.top    = y;
-        box.bottom = y + CHART_H;
-        box.left   = index;
-        box.right  = box.left + 2;
+        box.left   = first * CHART_SERIES * sizeof(float);
+        box.right  = (last + 1) * CHART_SERIES * sizeof(float);
+        box.top    = 0;
+        box.bottom = 1;
         box.front  = 0;
         box.back   = 1;
-
-        m_context->UpdateSubresource(m_chartsTexture.get(), 0, &box, start, CHARTS_W * 4, 1);
+        renderContext.deviceContext->UpdateSubresource(m_sampleBuffer.get(), 0, &box, m_samples.data() + first * CHART_SERIES, 0, 0);
     }
 }
 
-void Charts::Update()
+void Charts::Render(const RenderContext& renderContext, ID3D11RenderTargetView* target, int bottom)
 {
-    if(m_options.charts)
-    {
-        Update(m_watcher.m_receiveChart, 0, 0.0f, 50.0f);
-        Update(m_watcher.m_submitChart, CHART_H, 0.0f, 50.0f);
-    }
+    Update(renderContext);
+
+    m_constants.originX    = 0.0f;
+    m_constants.originY    = (float)(bottom - CHARTS_H);
+    m_constants.rowHeight  = (float)CHART_H;
+    m_constants.brightness = m_options.useHdr ? CHARTS_HDR_BRIGHTNESS : 1.0f;
+    renderContext.deviceContext->UpdateSubresource(m_constantBuffer.get(), 0, nullptr, &m_constants, 0, 0);
+
+    UINT       numScissors = 1;
+    D3D11_RECT outputScissor;
+    renderContext.deviceContext->RSGetScissorRects(&numScissors, &outputScissor);
+
+    D3D11_RECT scissor = { 0, bottom - CHARTS_H, CHARTS_W, bottom };
+    renderContext.deviceContext->RSSetScissorRects(1, &scissor);
+    renderContext.deviceContext->OMSetRenderTargets(1, &target, NULL);
+
+    renderContext.deviceContext->VSSetShader(m_vertexShader.get(), NULL, 0);
+    renderContext.deviceContext->PSSetShader(m_pixelShader.get(), NULL, 0);
+    renderContext.deviceContext->IASetInputLayout(NULL);
+    renderContext.deviceContext->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    ID3D11Buffer* buffer[1] = { m_constantBuffer.get() };
+    renderContext.deviceContext->PSSetConstantBuffers(0, 1, buffer);
+    ID3D11ShaderResourceView* views[1] = { m_sampleView.get() };
+    renderContext.deviceContext->PSSetShaderResources(0, 1, views);
+    renderContext.deviceContext->Draw(3, 0);
+
+    ID3D11ShaderResourceView* nullv[] = { nullptr };
+    renderContext.deviceContext->PSSetShaderResources(0, 1, nullv);
+    ID3D11Buffer* nullb[] = { nullptr };
+    renderContext.deviceContext->PSSetConstantBuffers(0, 1, nullb);
+    renderContext.deviceContext->RSSetScissorRects(numScissors, &outputScissor);
 }
-} // namespace ShaderBeam
\ No newline at end of file
+} // namespace ShaderBeam
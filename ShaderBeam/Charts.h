@@ -9,32 +9,56 @@ MIT License
 
 #include "Common.h"
 #include "Watcher.h"
+#include "RenderContext.h"
 
 namespace ShaderBeam
 {
 
+#define CHART_SERIES 5 // matches Charts.hlsl
+#define CHART_H 64
+
+// sample rings mirrored into one GPU buffer and drawn by a pixel shader, see Charts.hlsl
 class Charts
 {
 public:
     Charts(const Options& options, Watcher& watcher);
 
-    void Create(winrt::com_ptr<ID3D11Device> device, winrt::com_ptr<ID3D11DeviceContext> context);
-    void Render(const winrt::com_ptr<ID3D11Texture2D>& texture, int bottom);
+    void Create(const RenderContext& renderContext);
     void Destroy();
 
+    // restores the scissor it changes
+    void Render(const RenderContext& renderContext, ID3D11RenderTargetView* target, int bottom);
+
 private:
-    const Options& m_options;
-    Watcher&       m_watcher;
+    struct ChartConstants
+    {
+        float series[CHART_SERIES][4]; // min, max, cursor column, unused
+        float originX;
+        float originY;
+        float rowHeight;
+        float brightness;
+    };
 
-    std::vector<uint32_t>           m_chartsBuffer;
-    winrt::com_ptr<ID3D11Texture2D> m_chartsTexture { nullptr };
+    struct Series
+    {
+        Chart* chart;
+        float  min;
+        float  max;
+    };
 
-    winrt::com_ptr<ID3D11Device>        m_device { nullptr };
-    winrt::com_ptr<ID3D11DeviceContext> m_context { nullptr };
+    const Options& m_options;
+    Watcher&       m_watcher;
 
-    static int Clamp(float v, float min, float max, int resolution);
+    std::vector<float>                       m_samples; // CPU copy, sample-major like the buffer
+    winrt::com_ptr<ID3D11Buffer>             m_sampleBuffer;
+    winrt::com_ptr<ID3D11ShaderResourceView> m_sampleView;
+    winrt::com_ptr<ID3D11Buffer>             m_constantBuffer;
+    winrt::com_ptr<ID3D11VertexShader>       m_vertexShader;
+    winrt::com_ptr<ID3D11PixelShader>        m_pixelShader;
+    ResourcePool*                            m_resources { nullptr };
+    ChartConstants                           m_constants {};
 
-    void Update(Chart& chart, int y, float min, float max);
-    void Update();
+    std::vector<Series> GetSeries() const;
+    void                Update(const RenderContext& renderContext);
 };
 } // namespace ShaderBeam
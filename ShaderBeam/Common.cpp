@@ -68,6 +68,45 @@ void Options::Save(const ShaderManager& shaderManager) const
             }
         }
 
+        auto& sc = ini["scheduling"];
+        SAVE_INT(sc, schedulingClass)
+        SAVE_INT(sc, renderCores)
+        SAVE_INT(sc, captureCores)
+        SAVE_INT(sc, workerCores)
+        SAVE_BOOL(sc, isolateUI)
+        SAVE_INT(sc, deadlineBudget)
+        SAVE_INT(sc, workerThreads)
+
+        auto& c = ini["capture"];
+        SAVE_INT(c, readbackDepth)
+        SAVE_BOOL(c, dirtyRegions)
+        SAVE_BOOL(c, frameHashing)
+        SAVE_BOOL(c, windowSizedInputs)
+        SAVE_STRING(c, captureFile)
+        SAVE_INT(c, fileWidth)
+        SAVE_INT(c, fileHeight)
+        SAVE_INT(c, fileFrameRate)
+        SAVE_BOOL(c, fileLoop)
+        SAVE_INT(c, testPattern)
+        SAVE_INT(c, testPatternRate)
+        SAVE_INT(c, testPatternSpeed)
+        SAVE_INT(c, testPatternJitter)
+        SAVE_INT(c, testPatternDrops)
+
+        auto& r = ini["render"];
+        SAVE_BOOL(r, compactHistory)
+        SAVE_BOOL(r, computeShaders)
+
+        auto& rec = ini["record"];
+        SAVE_STRING(rec, recordFile)
+        SAVE_INT(rec, recordEvery)
+        SAVE_INT(rec, recordDepth)
+
+        auto& at = ini["autotune"];
+        SAVE_INT(at, autoTuneWarmup)
+        SAVE_INT(at, autoTuneWindow)
+        SAVE_INT(at, autoTuneMaxQueuedFrames)
+
         file.write(ini);
     }
     catch(...)
@@ -104,6 +143,60 @@ void Options::Load(ShaderManager& shaderManager)
                 LOAD_INT(s, maxQueuedFrames)
             }
 
+            if(ini.has("scheduling"))
+            {
+                auto sc = ini.get("scheduling");
+                LOAD_INT(sc, schedulingClass)
+                LOAD_INT(sc, renderCores)
+                LOAD_INT(sc, captureCores)
+                LOAD_INT(sc, workerCores)
+                LOAD_BOOL(sc, isolateUI)
+                LOAD_INT(sc, deadlineBudget)
+                LOAD_INT(sc, workerThreads)
+            }
+
+            if(ini.has("capture"))
+            {
+                auto c = ini.get("capture");
+                LOAD_INT(c, readbackDepth)
+                LOAD_BOOL(c, dirtyRegions)
+                LOAD_BOOL(c, frameHashing)
+                LOAD_BOOL(c, windowSizedInputs)
+                LOAD_STRING(c, captureFile)
+                LOAD_INT(c, fileWidth)
+                LOAD_INT(c, fileHeight)
+                LOAD_INT(c, fileFrameRate)
+                LOAD_BOOL(c, fileLoop)
+                LOAD_INT(c, testPattern)
+                LOAD_INT(c, testPatternRate)
+                LOAD_INT(c, testPatternSpeed)
+                LOAD_INT(c, testPatternJitter)
+                LOAD_INT(c, testPatternDrops)
+            }
+
+            if(ini.has("render"))
+            {
+                auto r = ini.get("render");
+                LOAD_BOOL(r, compactHistory)
+                LOAD_BOOL(r, computeShaders)
+            }
+
+            if(ini.has("record"))
+            {
+                auto rec = ini.get("record");
+                LOAD_STRING(rec, recordFile)
+                LOAD_INT(rec, recordEvery)
+                LOAD_INT(rec, recordDepth)
+            }
+
+            if(ini.has("autotune"))
+            {
+                auto at = ini.get("autotune");
+                LOAD_INT(at, autoTuneWarmup)
+                LOAD_INT(at, autoTuneWindow)
+                LOAD_INT(at, autoTuneMaxQueuedFrames)
+            }
+
             if(ini.has("shader") && shaderProfileNo <= shaderManager.GetShaders().size())
             {
                 auto& shader = ini["shader"];
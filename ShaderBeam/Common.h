@@ -14,12 +14,14 @@ namespace ShaderBeam
 
 #define MIN_SUBFRAMES 1
 #define MAX_SUBFRAMES 16
-#define MAX_INPUTS 5
+#define MAX_INPUTS 16 // history a profile can ask for, shader resource slots t2 onwards
 #define AUTOSYNC_INTERVAL 2
 
 #define WM_USER_RESTART (WM_USER)
 #define WM_USER_BENCHMARK (WM_USER + 1)
 #define WM_USER_NOWINDOW (WM_USER + 2)
+#define WM_USER_AUTOTUNE (WM_USER + 3)
+#define WM_USER_APPLY (WM_USER + 4)
 
 #define HOTKEY_TOGGLEUI 0
 #define HOTKEY_BRINGTOFRONT 1
@@ -112,8 +114,12 @@ struct BenchmarkResult
 {
     float totalFPS { 0 };
     float copyFPS { 0 };
+    float copyGBps { 0 };
+    float cpuCopyGBps { 0 }; // dual GPU only, CopyEngine on its own without the GPU transfers
     float renderFPS { 0 };
     float presentFPS { 0 };
+    float historyPsnr { 0 }; // HDR only, CPU reference of compact history error
+    float chromaPsnr { 0 };
 };
 
 constexpr int MONITOR_LCD  = 0;
@@ -142,6 +148,49 @@ struct Options
     int  maxQueuedFrames { 0 };
     bool rememberSettings { true };
 
+    // scheduling options
+    int  schedulingClass { 1 }; // see ThreadScheduler.h
+    int  renderCores { 0 };
+    int  captureCores { 0 };
+    int  workerCores { 0 };
+    bool isolateUI { true };
+    int  deadlineBudget { 50 }; // % of vsync for SCHED_DEADLINE
+    int  workerThreads { 0 }; // cross-adapter copy and CPU-generated frame threads, 0 = auto
+
+    // capture options
+    int  readbackDepth { 2 }; // dual GPU staging slots, 1 = blocking readback
+    bool dirtyRegions { true }; // copy only changed regions when capture API reports them
+    bool frameHashing { true }; // hash tiles to drop identical frames (on the GPU on one adapter), dual GPU also copies only changed tiles
+    bool windowSizedInputs { true }; // window capture: inputs cover just the window, not the whole display
+
+    // file capture options
+    std::string captureFile; // raw frames in input format (BGRA8, RGBA16F with HDR) or Y4M, empty = no file capture
+    int         fileWidth { 0 }; // raw files only
+    int         fileHeight { 0 };
+    int         fileFrameRate { 0 }; // 0 = from Y4M header or 60
+    bool        fileLoop { true };
+
+    // test pattern capture options
+    int testPattern { 0 }; // see TestPattern.h
+    int testPatternRate { 60 }; // content frames per second
+    int testPatternSpeed { 960 }; // pixels per second
+    int testPatternJitter { 0 }; // % of frame time
+    int testPatternDrops { 0 }; // % of frames
+
+    // render options
+    bool compactHistory { false }; // HDR: keep older input frames as R11G11B10_FLOAT
+    bool computeShaders { false }; // run shaders that have one as compute writing the output directly (not with hardware sRGB)
+
+    // record options
+    std::string recordFile; // raw output subframes plus .csv metadata, empty = not recording
+    int         recordEvery { 1 }; // 1 = every subframe, N = every Nth
+    int         recordDepth { 4 }; // readback slots in flight
+
+    // auto-tune options
+    unsigned autoTuneWarmup { 2 }; // seconds ignored after each restart
+    unsigned autoTuneWindow { 5 }; // seconds measured per candidate
+    unsigned autoTuneMaxQueuedFrames { 6 };
+
     // internal options
     bool     exclusive { false };
     unsigned wgcBuffers { 16 };
@@ -153,6 +202,12 @@ struct Options
     HWND        captureWindow { 0 };
     unsigned    outputWidth { 0 };
     unsigned    outputHeight { 0 };
+    int         windowX { 0 }; // captured window position on output
+    int         windowY { 0 };
+    int         inputX { 0 }; // area of output covered by input textures
+    int         inputY { 0 };
+    unsigned    inputWidth { 0 };
+    unsigned    inputHeight { 0 };
     float       vsyncDuration { 0 };
     float       vsyncRate { 0 };
     unsigned    swapChainBuffers { 0 };
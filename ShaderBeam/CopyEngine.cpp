@@ -0,0 +1,135 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "CopyEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#    include <emmintrin.h>
+#    define COPY_ENGINE_SSE2
+#endif
+
+namespace ShaderBeam
+{
+
+CopyEngine::CopyEngine(WorkerPool& pool) : m_pool(pool) { }
+
+void CopyEngine::SetStreaming(bool streaming)
+{
+    m_streaming = streaming;
+}
+
+void CopyEngine::Copy(const CopySurface& dest, const CopySurface& source, size_t rowBytes, unsigned rows)
+{
+    if(!rows || !rowBytes)
+        return;
+
+    if(dest.pitch == source.pitch && rowBytes == source.pitch && !m_streaming && m_pool.GetNumThreads() == 0)
+    {
+        // contiguous, nothing to gain
+        memcpy(dest.data, source.data, rowBytes * rows);
+        return;
+    }
+
+    // one band per thread (including caller), but don't bother splitting small frames
+    const size_t   totalBytes = rowBytes * rows;
+    const unsigned maxBands   = (unsigned)std::max<size_t>(1, totalBytes / COPY_MIN_BAND_BYTES);
+    const unsigned numBands   = std::min({ m_pool.GetNumThreads() + 1, maxBands, rows });
+    const unsigned bandRows   = (rows + numBands - 1) / numBands;
+    const bool     streaming  = m_streaming;
+
+    m_pool.Run(numBands, [&](unsigned band) {
+        const unsigned firstRow = band * bandRows;
+        if(firstRow < rows)
+            CopyRows(dest, source, rowBytes, firstRow, std::min(bandRows, rows - firstRow), streaming);
+    });
+}
+
+void CopyEngine::CopyRows(const CopySurface& dest, const CopySurface& source, size_t rowBytes, unsigned firstRow, unsigned numRows, bool streaming)
+{
+    uint8_t*       d = dest.data + dest.pitch * firstRow;
+    const uint8_t* s = source.data + source.pitch * firstRow;
+    for(unsigned row = 0; row < numRows; row++)
+    {
+        if(streaming)
+            StreamRow(d, s, rowBytes);
+        else
+            memcpy(d, s, rowBytes);
+        d += dest.pitch;
+        s += source.pitch;
+    }
+#ifdef COPY_ENGINE_SSE2
+    if(streaming)
+        _mm_sfence(); // make streamed data visible before GPU gets the surface back
+#endif
+}
+
+void CopyEngine::StreamRow(uint8_t* dest, const uint8_t* source, size_t bytes)
+{
+#ifdef COPY_ENGINE_SSE2
+    // unaligned head with regular stores, non-temporal stores need 16-byte alignment
+    size_t head = (16 - ((uintptr_t)dest & 15)) & 15;
+    head        = std::min(head, bytes);
+    memcpy(dest, source, head);
+    dest += head;
+    source += head;
+    bytes -= head;
+
+    auto blocks = bytes / 64;
+    for(size_t b = 0; b < blocks; b++)
+    {
+        auto x0 = _mm_loadu_si128((const __m128i*)source);
+        auto x1 = _mm_loadu_si128((const __m128i*)(source + 16));
+        auto x2 = _mm_loadu_si128((const __m128i*)(source + 32));
+        auto x3 = _mm_loadu_si128((const __m128i*)(source + 48));
+        _mm_stream_si128((__m128i*)dest, x0);
+        _mm_stream_si128((__m128i*)(dest + 16), x1);
+        _mm_stream_si128((__m128i*)(dest + 32), x2);
+        _mm_stream_si128((__m128i*)(dest + 48), x3);
+        source += 64;
+        dest += 64;
+    }
+    bytes -= blocks * 64;
+
+    while(bytes >= 16)
+    {
+        _mm_stream_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)source));
+        source += 16;
+        dest += 16;
+        bytes -= 16;
+    }
+    memcpy(dest, source, bytes);
+#else
+    memcpy(dest, source, bytes);
+#endif
+}
+
+double CopyEngine::Benchmark(size_t rowBytes, unsigned rows, unsigned iterations)
+{
+    // pad pitches like drivers do so the pitch-mismatch path is exercised
+    const size_t         sourcePitch = (rowBytes + 255) & ~(size_t)255;
+    const size_t         destPitch   = (rowBytes + 63) & ~(size_t)63;
+    std::vector<uint8_t> source(sourcePitch * rows, 0x5a);
+    std::vector<uint8_t> dest(destPitch * rows);
+
+    const CopySurface sourceSurface { source.data(), sourcePitch };
+    const CopySurface destSurface { dest.data(), destPitch };
+
+    Copy(destSurface, sourceSurface, rowBytes, rows); // warm up
+    const auto start = std::chrono::steady_clock::now();
+    for(unsigned i = 0; i < iterations; i++)
+        Copy(destSurface, sourceSurface, rowBytes, rows);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() > 0 ? (double)rowBytes * rows * iterations / elapsed.count() / 1e9 : 0;
+}
+
+} // namespace ShaderBeam
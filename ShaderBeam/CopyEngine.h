@@ -0,0 +1,55 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstddef>
+#include <cstdint>
+
+#include "WorkerPool.h"
+
+namespace ShaderBeam
+{
+
+// minimum band size worth handing to another thread
+constexpr size_t COPY_MIN_BAND_BYTES = 1024 * 1024;
+
+// frames copied by Benchmark, enough to average out worker wake-ups
+constexpr unsigned COPY_BENCHMARK_ITERATIONS = 32;
+
+struct CopySurface
+{
+    uint8_t* data;
+    size_t   pitch; // bytes between rows, may be larger than row width
+};
+
+// copies between mapped surfaces with different row pitches, splitting rows into bands across the worker pool
+class CopyEngine
+{
+public:
+    explicit CopyEngine(WorkerPool& pool);
+
+    // streaming stores bypass cache, which is what we want when writing to write-combined mapped GPU memory
+    void SetStreaming(bool streaming);
+
+    void Copy(const CopySurface& dest, const CopySurface& source, size_t rowBytes, unsigned rows);
+
+    // single-threaded copy of a row band, exposed for benchmarking
+    static void CopyRows(const CopySurface& dest, const CopySurface& source, size_t rowBytes, unsigned firstRow, unsigned numRows, bool streaming);
+
+    // copies a synthetic frame repeatedly, returns throughput in GB/s
+    double Benchmark(size_t rowBytes, unsigned rows, unsigned iterations);
+
+private:
+    WorkerPool& m_pool;
+    bool        m_streaming { true };
+
+    static void StreamRow(uint8_t* dest, const uint8_t* source, size_t bytes);
+};
+} // namespace ShaderBeam
@@ -0,0 +1,195 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "DirtyRegions.h"
+
+#include <algorithm>
+
+namespace ShaderBeam
+{
+
+bool DirtyRect::IsEmpty() const
+{
+    return right <= left || bottom <= top;
+}
+
+int64_t DirtyRect::Area() const
+{
+    return IsEmpty() ? 0 : (int64_t)(right - left) * (bottom - top);
+}
+
+bool DirtyRect::Touches(const DirtyRect& other) const
+{
+    // overlapping or sharing an edge, merging those costs nothing
+    return left <= other.right && other.left <= right && top <= other.bottom && other.top <= bottom;
+}
+
+DirtyRect DirtyRect::Union(const DirtyRect& a, const DirtyRect& b)
+{
+    return { std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+}
+
+void DirtyRegions::Reset(int width, int height)
+{
+    m_width  = width;
+    m_height = height;
+    Clear();
+}
+
+void DirtyRegions::Clear()
+{
+    m_full = false;
+    m_rects.clear();
+}
+
+void DirtyRegions::SetFull()
+{
+    m_full = true;
+    m_rects.clear();
+}
+
+void DirtyRegions::Add(DirtyRect rect)
+{
+    if(m_full)
+        return;
+
+    rect.left   = std::max(rect.left, 0);
+    rect.top    = std::max(rect.top, 0);
+    rect.right  = std::min(rect.right, m_width);
+    rect.bottom = std::min(rect.bottom, m_height);
+    if(rect.IsEmpty())
+        return;
+
+    Insert(rect);
+    Coalesce();
+}
+
+void DirtyRegions::Add(const DirtyRegions& other)
+{
+    if(other.m_full)
+    {
+        SetFull();
+        return;
+    }
+    for(const auto& rect : other.m_rects)
+        Add(rect);
+}
+
+bool DirtyRegions::IsFull() const
+{
+    return m_full;
+}
+
+bool DirtyRegions::IsEmpty() const
+{
+    return !m_full && m_rects.empty();
+}
+
+float DirtyRegions::Coverage() const
+{
+    if(m_full)
+        return 1.0f;
+    if(m_width <= 0 || m_height <= 0)
+        return 0.0f;
+
+    int64_t area = 0;
+    for(const auto& rect : m_rects)
+        area += rect.Area();
+    return area / ((float)m_width * m_height);
+}
+
+std::vector<DirtyRect> DirtyRegions::GetRects() const
+{
+    if(m_full)
+        return { { 0, 0, m_width, m_height } };
+    return m_rects;
+}
+
+void DirtyRegions::Insert(DirtyRect rect)
+{
+    // absorb everything the new rect touches, growing it may make it touch more
+    bool merged = true;
+    while(merged)
+    {
+        merged = false;
+        for(auto it = m_rects.begin(); it != m_rects.end(); ++it)
+        {
+            if(rect.Touches(*it))
+            {
+                rect = DirtyRect::Union(rect, *it);
+                m_rects.erase(it);
+                merged = true;
+                break;
+            }
+        }
+    }
+    m_rects.push_back(rect);
+}
+
+void DirtyRegions::Coalesce()
+{
+    // too many rects, merge the pair that wastes least area until we're under the limit
+    while(m_rects.size() > MAX_DIRTY_RECTS)
+    {
+        size_t  bestA = 0, bestB = 1;
+        int64_t bestWaste = INT64_MAX;
+        for(size_t a = 0; a < m_rects.size(); a++)
+        {
+            for(size_t b = a + 1; b < m_rects.size(); b++)
+            {
+                auto waste = DirtyRect::Union(m_rects[a], m_rects[b]).Area() - m_rects[a].Area() - m_rects[b].Area();
+                if(waste < bestWaste)
+                {
+                    bestWaste = waste;
+                    bestA     = a;
+                    bestB     = b;
+                }
+            }
+        }
+        auto merged = DirtyRect::Union(m_rects[bestA], m_rects[bestB]);
+        m_rects.erase(m_rects.begin() + bestB);
+        m_rects.erase(m_rects.begin() + bestA);
+        Insert(merged);
+    }
+
+    if(Coverage() > DIRTY_FULL_COVERAGE)
+        SetFull();
+}
+
+void DirtyTracker::Reset(int width, int height)
+{
+    m_width  = width;
+    m_height = height;
+    m_targets.clear();
+}
+
+void DirtyTracker::MarkDirty(const DirtyRegions& changes)
+{
+    for(auto& target : m_targets)
+        target.second.Add(changes);
+}
+
+DirtyRegions DirtyTracker::Take(const void* target)
+{
+    DirtyRegions clean;
+    clean.Reset(m_width, m_height);
+
+    for(auto& t : m_targets)
+    {
+        if(t.first == target)
+            return std::exchange(t.second, clean);
+    }
+
+    // never written, needs everything
+    m_targets.emplace_back(target, clean);
+    DirtyRegions full;
+    full.Reset(m_width, m_height);
+    full.SetFull();
+    return full;
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,81 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ShaderBeam
+{
+
+// more rects than this get merged, copy calls have a fixed cost too
+constexpr unsigned MAX_DIRTY_RECTS = 8;
+
+// past this share of the frame a single full copy is cheaper
+constexpr float DIRTY_FULL_COVERAGE = 0.6f;
+
+struct DirtyRect
+{
+    int left;
+    int top;
+    int right; // exclusive
+    int bottom; // exclusive
+
+    bool    IsEmpty() const;
+    int64_t Area() const;
+    bool    Touches(const DirtyRect& other) const;
+
+    static DirtyRect Union(const DirtyRect& a, const DirtyRect& b);
+};
+
+// set of non-overlapping rectangles that changed in a frame, coalesced into a few bounding boxes
+class DirtyRegions
+{
+public:
+    void Reset(int width, int height);
+    void Clear();
+    void SetFull();
+    void Add(DirtyRect rect);
+    void Add(const DirtyRegions& other);
+
+    bool  IsFull() const;
+    bool  IsEmpty() const;
+    float Coverage() const;
+
+    // whole frame as one rect when full
+    std::vector<DirtyRect> GetRects() const;
+
+private:
+    int                    m_width { 0 };
+    int                    m_height { 0 };
+    bool                   m_full { true };
+    std::vector<DirtyRect> m_rects;
+
+    void Insert(DirtyRect rect);
+    void Coalesce();
+};
+
+// tracks what each of a rotating set of target textures is missing since it was last written
+class DirtyTracker
+{
+public:
+    void Reset(int width, int height);
+    void MarkDirty(const DirtyRegions& changes);
+
+    // regions target needs to catch up (full frame if it's new), target is considered up to date afterwards
+    DirtyRegions Take(const void* target);
+
+private:
+    int                                               m_width { 0 };
+    int                                               m_height { 0 };
+    std::vector<std::pair<const void*, DirtyRegions>> m_targets;
+};
+} // namespace ShaderBeam
@@ -0,0 +1,81 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "EmbeddedShaders.h"
+
+// generated by EmbeddedShaders.targets
+#include "EmbeddedShaderIncludes.h"
+
+namespace ShaderBeam
+{
+
+struct EmbeddedShader
+{
+    const wchar_t* filename;   // without the directory
+    const char*    entryPoint;
+    const char*    target;
+    const char*    macros;     // NAME=VALUE,NAME=VALUE in the order the profile passes them
+    const char*    sourceHash; // SHA-256 of the source it was built from, hex
+    const BYTE*    bytecode;
+    size_t         size;
+};
+
+static const EmbeddedShader EMBEDDED_SHADERS[] = {
+#include "EmbeddedShaderTable.h"
+};
+
+bool EmbeddedShaders::Find(const wchar_t* filename, const D3D_SHADER_MACRO* macros, const char* entryPoint, const char* target, std::vector<uint8_t>& bytecode)
+{
+    std::string macroList;
+    for(auto macro = macros; macro && macro->Name; macro++)
+    {
+        if(!macroList.empty())
+            macroList += ",";
+        macroList += std::string(macro->Name) + "=" + (macro->Definition ? macro->Definition : "");
+    }
+
+    const auto name = std::filesystem::path(filename).filename().wstring();
+    for(const auto& shader : EMBEDDED_SHADERS)
+    {
+        if(name != shader.filename || strcmp(entryPoint, shader.entryPoint) || strcmp(target, shader.target) || macroList != shader.macros)
+            continue;
+        if(IsModified(filename, shader.sourceHash))
+            return false;
+
+        bytecode.assign(shader.bytecode, shader.bytecode + shader.size);
+        return true;
+    }
+    return false;
+}
+
+bool EmbeddedShaders::IsModified(const wchar_t* filename, const char* sourceHash)
+{
+    std::ifstream stream(filename, std::ios::binary);
+    if(!stream)
+        return false;
+
+    std::stringstream content;
+    content << stream.rdbuf();
+    const auto text = content.str();
+
+    // read on every lookup, an edit followed by a restart has to be picked up
+    BYTE hash[32];
+    if(BCryptHash(BCRYPT_SHA256_ALG_HANDLE, NULL, 0, (PUCHAR)text.data(), (ULONG)text.size(), hash, sizeof(hash)) < 0)
+        return true;
+
+    char hex[sizeof(hash) * 2 + 1];
+    for(size_t i = 0; i < sizeof(hash); i++)
+        snprintf(hex + i * 2, 3, "%02x", hash[i]);
+    return _stricmp(hex, sourceHash) != 0;
+}
+
+} // namespace ShaderBeam
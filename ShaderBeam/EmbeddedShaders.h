@@ -0,0 +1,26 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include <vector>
+
+namespace ShaderBeam
+{
+
+// bytecode compiled at build time for every permutation the profiles use, listed in EmbeddedShaders.targets
+class EmbeddedShaders
+{
+public:
+    // false when the permutation isn't embedded or the shader file next to the exe was edited since the build,
+    // a missing file is fine, the embedded copy doesn't need it
+    static bool Find(const wchar_t* filename, const D3D_SHADER_MACRO* macros, const char* entryPoint, const char* target, std::vector<uint8_t>& bytecode);
+
+private:
+    static bool IsModified(const wchar_t* filename, const char* sourceHash);
+};
+} // namespace ShaderBeam
@@ -0,0 +1,312 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "FrameFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ShaderBeam
+{
+
+static const char Y4M_MAGIC[] = "YUV4MPEG2 ";
+
+FrameFile::~FrameFile()
+{
+    Close();
+}
+
+void FrameFile::Open(const std::string& path, unsigned width, unsigned height, unsigned bytesPerPixel)
+{
+    Close();
+    Map(path);
+
+    try
+    {
+        if(m_size >= sizeof(Y4M_MAGIC) - 1 && memcmp(m_data, Y4M_MAGIC, sizeof(Y4M_MAGIC) - 1) == 0)
+        {
+            ParseY4M();
+        }
+        else
+        {
+            if(width == 0 || height == 0 || bytesPerPixel == 0)
+                throw std::runtime_error("Raw capture file needs fileWidth and fileHeight");
+
+            // frames are back to back, a truncated last one is ignored
+            m_width     = width;
+            m_height    = height;
+            m_pitch     = (size_t)width * bytesPerPixel;
+            m_frameSize = m_pitch * height;
+            for(size_t offset = 0; offset + m_frameSize <= m_size; offset += m_frameSize)
+                m_frameOffsets.push_back(offset);
+        }
+
+        if(m_frameOffsets.empty())
+            throw std::runtime_error("Capture file doesn't contain a whole frame");
+    }
+    catch(...)
+    {
+        Close();
+        throw;
+    }
+}
+
+void FrameFile::Map(const std::string& path)
+{
+#ifdef _WIN32
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Unable to open capture file " + path);
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        throw std::runtime_error("Capture file is empty");
+    }
+
+    m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(m_mapping)
+        m_data = (const uint8_t*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!m_data)
+    {
+        Close();
+        throw std::runtime_error("Unable to map capture file");
+    }
+    m_size = (size_t)size.QuadPart;
+#else
+    m_file = open(path.c_str(), O_RDONLY);
+    if(m_file < 0)
+        throw std::runtime_error("Unable to open capture file " + path);
+
+    struct stat info;
+    if(fstat(m_file, &info) != 0 || info.st_size == 0)
+    {
+        Close();
+        throw std::runtime_error("Capture file is empty");
+    }
+
+    auto data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    if(data == MAP_FAILED)
+    {
+        Close();
+        throw std::runtime_error("Unable to map capture file");
+    }
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+    m_data = (const uint8_t*)data;
+    m_size = (size_t)info.st_size;
+#endif
+}
+
+void FrameFile::Close()
+{
+#ifdef _WIN32
+    if(m_data)
+        UnmapViewOfFile(m_data);
+    if(m_mapping)
+        CloseHandle(m_mapping);
+    if(m_file)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file    = nullptr;
+#else
+    if(m_data)
+        munmap((void*)m_data, m_size);
+    if(m_file >= 0)
+        close(m_file);
+    m_file = -1;
+#endif
+    m_data      = nullptr;
+    m_size      = 0;
+    m_width     = 0;
+    m_height    = 0;
+    m_pitch     = 0;
+    m_frameSize = 0;
+    m_frameRate = 0;
+    m_chroma    = Chroma::None;
+    m_frameOffsets.clear();
+}
+
+void FrameFile::ParseY4M()
+{
+    auto headerEnd = (const uint8_t*)memchr(m_data, '\n', m_size);
+    if(!headerEnd)
+        throw std::runtime_error("Y4M header is incomplete");
+
+    // space separated tags, each a letter followed by its value
+    std::string header((const char*)m_data + sizeof(Y4M_MAGIC) - 1, (const char*)headerEnd);
+    std::string colorSpace = "420jpeg";
+    size_t      start      = 0;
+    while(start < header.size())
+    {
+        auto end = header.find(' ', start);
+        if(end == std::string::npos)
+            end = header.size();
+        if(end > start)
+        {
+            auto value = header.substr(start + 1, end - start - 1);
+            switch(header[start])
+            {
+            case 'W':
+                m_width = (unsigned)std::stoul(value);
+                break;
+            case 'H':
+                m_height = (unsigned)std::stoul(value);
+                break;
+            case 'F': {
+                auto colon = value.find(':');
+                if(colon != std::string::npos && std::stod(value.substr(colon + 1)) > 0)
+                    m_frameRate = std::stod(value.substr(0, colon)) / std::stod(value.substr(colon + 1));
+                break;
+            }
+            case 'C':
+                colorSpace = value;
+                break;
+            }
+        }
+        start = end + 1;
+    }
+
+    if(m_width == 0 || m_height == 0)
+        throw std::runtime_error("Y4M header has no frame size");
+
+    const size_t lumaSize = (size_t)m_width * m_height;
+    if(colorSpace == "420" || colorSpace == "420jpeg" || colorSpace == "420mpeg2" || colorSpace == "420paldv")
+    {
+        // these only differ in chroma siting, which point sampling ignores
+        m_chroma    = Chroma::Yuv420;
+        m_frameSize = lumaSize + 2 * (size_t)((m_width + 1) / 2) * ((m_height + 1) / 2);
+    }
+    else if(colorSpace == "444")
+    {
+        m_chroma    = Chroma::Yuv444;
+        m_frameSize = lumaSize * 3;
+    }
+    else if(colorSpace == "mono")
+    {
+        m_chroma    = Chroma::Mono;
+        m_frameSize = lumaSize;
+    }
+    else
+    {
+        throw std::runtime_error("Unsupported Y4M colorspace " + colorSpace + ", use 8-bit 420, 444 or mono");
+    }
+    m_pitch = m_width;
+
+    // every frame has its own (usually bare) FRAME header, find them all once so seeking is free later
+    size_t offset = headerEnd - m_data + 1;
+    while(offset + 5 <= m_size && memcmp(m_data + offset, "FRAME", 5) == 0)
+    {
+        auto frameEnd = (const uint8_t*)memchr(m_data + offset, '\n', m_size - offset);
+        if(!frameEnd)
+            break;
+        offset = frameEnd - m_data + 1;
+        if(offset + m_frameSize > m_size)
+            break;
+        m_frameOffsets.push_back(offset);
+        offset += m_frameSize;
+    }
+}
+
+bool FrameFile::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+bool FrameFile::IsY4M() const
+{
+    return m_chroma != Chroma::None;
+}
+
+unsigned FrameFile::GetWidth() const
+{
+    return m_width;
+}
+
+unsigned FrameFile::GetHeight() const
+{
+    return m_height;
+}
+
+unsigned FrameFile::GetNumFrames() const
+{
+    return (unsigned)m_frameOffsets.size();
+}
+
+double FrameFile::GetFrameRate() const
+{
+    return m_frameRate;
+}
+
+const uint8_t* FrameFile::GetFrame(unsigned index) const
+{
+    return index < m_frameOffsets.size() ? m_data + m_frameOffsets[index] : nullptr;
+}
+
+size_t FrameFile::GetPitch() const
+{
+    return m_pitch;
+}
+
+void FrameFile::ConvertFrame(unsigned index, uint8_t* dest, size_t destPitch) const
+{
+    ConvertRows(index, dest, destPitch, 0, m_height);
+}
+
+void FrameFile::ConvertRows(unsigned index, uint8_t* dest, size_t destPitch, unsigned firstRow, unsigned numRows) const
+{
+    auto frame = GetFrame(index);
+    if(!frame || !IsY4M())
+        return;
+
+    const unsigned chromaWidth  = m_chroma == Chroma::Yuv420 ? (m_width + 1) / 2 : m_width;
+    const unsigned chromaHeight = m_chroma == Chroma::Yuv420 ? (m_height + 1) / 2 : m_height;
+    const uint8_t* planeY       = frame;
+    const uint8_t* planeU       = planeY + (size_t)m_width * m_height;
+    const uint8_t* planeV       = planeU + (size_t)chromaWidth * chromaHeight;
+
+    const unsigned endRow = std::min(firstRow + numRows, m_height);
+    for(unsigned y = firstRow; y < endRow; y++)
+    {
+        auto rowY = planeY + (size_t)y * m_width;
+        auto row  = dest + y * destPitch;
+        auto cy   = m_chroma == Chroma::Yuv420 ? y / 2 : y;
+        for(unsigned x = 0; x < m_width; x++)
+        {
+            int c = rowY[x] - 16;
+            int d = 0;
+            int e = 0;
+            if(m_chroma != Chroma::Mono)
+            {
+                auto cx = m_chroma == Chroma::Yuv420 ? x / 2 : x;
+                d       = planeU[(size_t)cy * chromaWidth + cx] - 128;
+                e       = planeV[(size_t)cy * chromaWidth + cx] - 128;
+            }
+
+            // 8.8 fixed point BT.601
+            row[x * 4 + 0] = (uint8_t)std::clamp((298 * c + 516 * d + 128) >> 8, 0, 255);
+            row[x * 4 + 1] = (uint8_t)std::clamp((298 * c - 100 * d - 208 * e + 128) >> 8, 0, 255);
+            row[x * 4 + 2] = (uint8_t)std::clamp((298 * c + 409 * e + 128) >> 8, 0, 255);
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+} // namespace ShaderBeam
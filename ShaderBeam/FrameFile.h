@@ -0,0 +1,78 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no D3D dependencies in here so it can be exercised on Linux too
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ShaderBeam
+{
+
+// memory-mapped clip of captured frames, either raw (width * height * bytesPerPixel per frame, no header)
+// or YUV4MPEG2 (8-bit 4:2:0, 4:4:4 or mono), detected by its header
+class FrameFile
+{
+public:
+    FrameFile() = default;
+    FrameFile(const FrameFile&)            = delete;
+    FrameFile& operator=(const FrameFile&) = delete;
+    ~FrameFile();
+
+    // raw clips need their frame size, Y4M carries its own; throws when the file can't be used
+    void Open(const std::string& path, unsigned width, unsigned height, unsigned bytesPerPixel);
+    void Close();
+
+    bool     IsOpen() const;
+    bool     IsY4M() const;
+    unsigned GetWidth() const;
+    unsigned GetHeight() const;
+    unsigned GetNumFrames() const;
+    double   GetFrameRate() const; // from Y4M header, 0 if unknown
+
+    // raw frames point straight into the mapping
+    const uint8_t* GetFrame(unsigned index) const;
+    size_t         GetPitch() const;
+
+    // Y4M frames need converting, into BGRA8 (BT.601 limited range); rows are independent so bands can
+    // be converted in parallel, dest points at the top of the whole frame
+    void ConvertFrame(unsigned index, uint8_t* dest, size_t destPitch) const;
+    void ConvertRows(unsigned index, uint8_t* dest, size_t destPitch, unsigned firstRow, unsigned numRows) const;
+
+private:
+    enum class Chroma
+    {
+        None,
+        Yuv420,
+        Yuv444,
+        Mono
+    };
+
+    const uint8_t*      m_data { nullptr };
+    size_t              m_size { 0 };
+    unsigned            m_width { 0 };
+    unsigned            m_height { 0 };
+    size_t              m_pitch { 0 };
+    size_t              m_frameSize { 0 };
+    double              m_frameRate { 0 };
+    Chroma              m_chroma { Chroma::None };
+    std::vector<size_t> m_frameOffsets;
+#ifdef _WIN32
+    void* m_file { nullptr };
+    void* m_mapping { nullptr };
+#else
+    int m_file { -1 };
+#endif
+
+    void Map(const std::string& path);
+    void ParseY4M();
+};
+} // namespace ShaderBeam
@@ -0,0 +1,207 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "FrameWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ShaderBeam
+{
+
+FrameWriter::~FrameWriter()
+{
+    Close();
+}
+
+void FrameWriter::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    auto file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Unable to create recording " + path);
+    auto metadataFile = CreateFileA((path + ".csv").c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(metadataFile == INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to create recording metadata " + path + ".csv");
+    }
+#else
+    auto file = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(file < 0)
+        throw std::runtime_error("Unable to create recording " + path);
+    auto metadataFile = open((path + ".csv").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(metadataFile < 0)
+    {
+        close(file);
+        throw std::runtime_error("Unable to create recording metadata " + path + ".csv");
+    }
+#endif
+    m_file         = file;
+    m_metadataFile = metadataFile;
+    m_batch        = new uint8_t[WRITER_BATCH_BYTES];
+    m_batchUsed    = 0;
+    m_sequence     = 0;
+    m_bytesWritten = 0;
+    m_failed       = false;
+    m_closing      = false;
+    m_metadata     = "sequence,frameNo,subFrameNo,ticks,width,height,bytesPerPixel\n";
+
+    m_thread = std::thread(&FrameWriter::Work, this);
+}
+
+void FrameWriter::Close()
+{
+    if(!IsOpen())
+        return;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_closing = true;
+    }
+    m_frameQueued.notify_all();
+    if(m_thread.joinable())
+        m_thread.join();
+
+#ifdef _WIN32
+    CloseHandle(m_file);
+    CloseHandle(m_metadataFile);
+    m_file         = nullptr;
+    m_metadataFile = nullptr;
+#else
+    close(m_file);
+    close(m_metadataFile);
+    m_file         = -1;
+    m_metadataFile = -1;
+#endif
+    delete[] m_batch;
+    m_batch = nullptr;
+}
+
+bool FrameWriter::IsOpen() const
+{
+    return m_batch != nullptr;
+}
+
+void FrameWriter::Submit(const WrittenFrame& frame)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_queue.push_back(frame);
+    }
+    m_frameQueued.notify_one();
+}
+
+uint64_t FrameWriter::GetBytesWritten() const
+{
+    return m_bytesWritten;
+}
+
+bool FrameWriter::HasFailed() const
+{
+    return m_failed;
+}
+
+void FrameWriter::Work()
+{
+    while(true)
+    {
+        WrittenFrame frame;
+        {
+            std::unique_lock lock(m_mutex);
+            m_frameQueued.wait(lock, [&] { return m_closing || !m_queue.empty(); });
+            if(m_queue.empty())
+                break;
+            frame = m_queue.front();
+            m_queue.pop_front();
+        }
+        WriteFrame(frame);
+    }
+
+    // closing, last partial batch goes out as is
+    FlushBatch();
+}
+
+void FrameWriter::WriteFrame(const WrittenFrame& frame)
+{
+    // rows are packed as they go into the batch, so pitch padding never reaches the file
+    const size_t rowBytes = (size_t)frame.width * frame.bytesPerPixel;
+    for(unsigned y = 0; y < frame.height; y++)
+    {
+        auto   row  = frame.data + y * frame.pitch;
+        size_t done = 0;
+        while(done < rowBytes)
+        {
+            const size_t chunk = std::min(rowBytes - done, WRITER_BATCH_BYTES - m_batchUsed);
+            memcpy(m_batch + m_batchUsed, row + done, chunk);
+            m_batchUsed += chunk;
+            done += chunk;
+            if(m_batchUsed == WRITER_BATCH_BYTES)
+                FlushBatch();
+        }
+    }
+    *frame.consumed = true;
+
+    m_metadata += std::to_string(m_sequence++) + ',' + std::to_string(frame.frameNo) + ',' + std::to_string(frame.subFrameNo) + ',' +
+                  std::to_string(frame.ticks) + ',' + std::to_string(frame.width) + ',' + std::to_string(frame.height) + ',' +
+                  std::to_string(frame.bytesPerPixel) + '\n';
+}
+
+void FrameWriter::FlushBatch()
+{
+    if(m_batchUsed && WriteAll(false, m_batch, m_batchUsed))
+        m_bytesWritten += m_batchUsed;
+    m_batchUsed = 0;
+
+    // metadata only follows the frames it describes
+    if(!m_metadata.empty())
+        WriteAll(true, m_metadata.data(), m_metadata.size());
+    m_metadata.clear();
+}
+
+bool FrameWriter::WriteAll(bool metadata, const void* data, size_t size)
+{
+    if(m_failed)
+        return false;
+
+    auto bytes = (const uint8_t*)data;
+    while(size)
+    {
+#ifdef _WIN32
+        DWORD written = 0;
+        if(!WriteFile(metadata ? m_metadataFile : m_file, bytes, (DWORD)std::min(size, (size_t)WRITER_BATCH_BYTES), &written, NULL) || written == 0)
+        {
+            m_failed = true; // e.g. disk full, keep consuming frames so the renderer isn't held up
+            return false;
+        }
+#else
+        auto written = write(metadata ? m_metadataFile : m_file, bytes, size);
+        if(written <= 0)
+        {
+            m_failed = true; // e.g. disk full, keep consuming frames so the renderer isn't held up
+            return false;
+        }
+#endif
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+} // namespace ShaderBeam
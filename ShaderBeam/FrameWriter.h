@@ -0,0 +1,90 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no D3D dependencies in here so it can be exercised on Linux too
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ShaderBeam
+{
+
+// writes go out in batches of this size, a few large writes rather than one per row or frame
+constexpr size_t WRITER_BATCH_BYTES = 8 * 1024 * 1024;
+
+struct WrittenFrame
+{
+    const uint8_t*     data; // stays valid until consumed is set
+    size_t             pitch;
+    unsigned           width;
+    unsigned           height;
+    unsigned           bytesPerPixel;
+    uint64_t           frameNo;
+    unsigned           subFrameNo;
+    float              ticks;
+    std::atomic<bool>* consumed;
+};
+
+// streams frames to a raw file (rows packed, back to back) plus a .csv with per-frame metadata, on its own thread
+class FrameWriter
+{
+public:
+    FrameWriter() = default;
+    FrameWriter(const FrameWriter&)            = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+    ~FrameWriter();
+
+    // throws when files can't be created
+    void Open(const std::string& path);
+
+    // writes out everything queued, then stops the thread
+    void Close();
+
+    bool IsOpen() const;
+
+    // never waits for the disk, frame is copied out on the writer thread
+    void Submit(const WrittenFrame& frame);
+
+    // raw frame bytes that reached the file so far
+    uint64_t GetBytesWritten() const;
+    // a write failed (e.g. disk full), nothing more gets written
+    bool HasFailed() const;
+
+private:
+    std::thread              m_thread;
+    std::mutex               m_mutex;
+    std::condition_variable  m_frameQueued;
+    std::deque<WrittenFrame> m_queue;
+    bool                     m_closing { false };
+    std::atomic<uint64_t>    m_bytesWritten { 0 };
+    std::atomic<bool>        m_failed { false };
+    uint8_t*                 m_batch { nullptr };
+    size_t                   m_batchUsed { 0 };
+    uint64_t                 m_sequence { 0 };
+    std::string              m_metadata;
+#ifdef _WIN32
+    void* m_file { nullptr };
+    void* m_metadataFile { nullptr };
+#else
+    int m_file { -1 };
+    int m_metadataFile { -1 };
+#endif
+
+    void Work();
+    void WriteFrame(const WrittenFrame& frame);
+    void FlushBatch();
+    bool WriteAll(bool metadata, const void* data, size_t size);
+};
+} // namespace ShaderBeam
@@ -0,0 +1,158 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "GPUTileHasher.h"
+#include "TileHasher.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+void GPUTileHasher::Start(ID3D11DeviceContext* context, ResourcePool& resourcePool, int width, int height)
+{
+    m_context.copy_from(context);
+    m_resources = &resourcePool;
+    m_tilesX    = (width + HASH_TILE_SIZE - 1) / HASH_TILE_SIZE;
+    m_tilesY    = (height + HASH_TILE_SIZE - 1) / HASH_TILE_SIZE;
+
+    winrt::com_ptr<ID3D11Device> device;
+    m_context->GetDevice(device.put());
+
+    auto computeCode = Helpers::CompileShader(L"Shaders\\TileHash.hlsl", nullptr, "CSmain", "cs_5_0");
+    THROW(device->CreateComputeShader(computeCode.data(), computeCode.size(), NULL, m_shader.put()), "Unable to create tile hash shader");
+
+    D3D11_BUFFER_DESC hashDesc {};
+    hashDesc.ByteWidth           = m_tilesX * m_tilesY * sizeof(uint64_t);
+    hashDesc.Usage               = D3D11_USAGE_DEFAULT;
+    hashDesc.BindFlags           = D3D11_BIND_UNORDERED_ACCESS;
+    hashDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    hashDesc.StructureByteStride = sizeof(uint64_t);
+    m_hashBuffer                 = m_resources->AcquireBuffer(device.get(), hashDesc);
+    THROW(device->CreateUnorderedAccessView(m_hashBuffer.get(), nullptr, m_hashView.put()), "Unable to create tile hash view");
+
+    D3D11_BUFFER_DESC readbackDesc {};
+    readbackDesc.ByteWidth      = hashDesc.ByteWidth;
+    readbackDesc.Usage          = D3D11_USAGE_STAGING;
+    readbackDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+    D3D11_QUERY_DESC queryDesc {};
+    queryDesc.Query = D3D11_QUERY_EVENT;
+    for(auto& readback : m_readbacks)
+    {
+        readback.buffer  = m_resources->AcquireBuffer(device.get(), readbackDesc);
+        readback.pending = false;
+        THROW(device->CreateQuery(&queryDesc, readback.query.put()), "Unable to create tile hash query");
+    }
+    m_nextReadback   = 0;
+    m_oldestReadback = 0;
+}
+
+void GPUTileHasher::Stop()
+{
+    m_views.clear();
+    m_hashView = nullptr;
+    m_shader   = nullptr;
+    m_context  = nullptr;
+    for(auto& readback : m_readbacks)
+    {
+        readback.query   = nullptr;
+        readback.pending = false;
+        if(m_resources)
+            m_resources->Release(readback.buffer);
+    }
+    if(m_resources)
+        m_resources->Release(m_hashBuffer);
+}
+
+bool GPUTileHasher::IsStarted() const
+{
+    return m_shader != nullptr;
+}
+
+bool GPUTileHasher::Dispatch(ID3D11Texture2D* texture)
+{
+    auto& readback = m_readbacks[m_nextReadback];
+    if(readback.pending)
+        return false;
+
+    ID3D11ShaderResourceView*  views[]  = { GetView(texture) };
+    ID3D11UnorderedAccessView* hashes[] = { m_hashView.get() };
+    m_context->CSSetShader(m_shader.get(), NULL, 0);
+    m_context->CSSetShaderResources(0, 1, views);
+    m_context->CSSetUnorderedAccessViews(0, 1, hashes, nullptr);
+
+    m_context->Dispatch(m_tilesX, m_tilesY, 1);
+
+    ID3D11UnorderedAccessView* nullu[] = { nullptr };
+    m_context->CSSetUnorderedAccessViews(0, 1, nullu, nullptr);
+    ID3D11ShaderResourceView* nullv[] = { nullptr };
+    m_context->CSSetShaderResources(0, 1, nullv);
+    m_context->CSSetShader(NULL, NULL, 0);
+
+    // GPU starts on it right away rather than when the frame gets rendered
+    m_context->CopyResource(readback.buffer.get(), m_hashBuffer.get());
+    m_context->End(readback.query.get());
+    m_context->Flush();
+    readback.pending = true;
+    m_nextReadback   = (m_nextReadback + 1) % GPU_HASH_DEPTH;
+    return true;
+}
+
+bool GPUTileHasher::Read(std::vector<uint64_t>& hashes)
+{
+    auto& readback = m_readbacks[m_oldestReadback];
+    if(!readback.pending || m_context->GetData(readback.query.get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        return false;
+
+    // query has signalled so the copy should be done, still never block on it
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    auto                     hr = m_context->Map(readback.buffer.get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+    if(hr == DXGI_ERROR_WAS_STILL_DRAWING)
+        return false;
+    THROW(hr, "Unable to map tile hashes");
+    hashes.resize((size_t)m_tilesX * m_tilesY);
+    memcpy(hashes.data(), mapped.pData, hashes.size() * sizeof(uint64_t));
+    m_context->Unmap(readback.buffer.get(), 0);
+
+    readback.pending = false;
+    m_oldestReadback = (m_oldestReadback + 1) % GPU_HASH_DEPTH;
+    return true;
+}
+
+void GPUTileHasher::Discard()
+{
+    // GPU may still be copying into them, D3D orders that before any later use
+    for(auto& readback : m_readbacks)
+        readback.pending = false;
+    m_oldestReadback = m_nextReadback;
+}
+
+ID3D11ShaderResourceView* GPUTileHasher::GetView(ID3D11Texture2D* texture)
+{
+    for(const auto& cached : m_views)
+    {
+        if(cached.texture.get() == texture)
+            return cached.view.get();
+    }
+
+    // inputs were re-created, views of the old ones keep them alive
+    if(m_views.size() >= MAX_INPUTS)
+        m_views.clear();
+
+    winrt::com_ptr<ID3D11Device> device;
+    m_context->GetDevice(device.put());
+
+    CachedView cached;
+    cached.texture.copy_from(texture);
+    THROW(device->CreateShaderResourceView(texture, nullptr, cached.view.put()), "Unable to create tile hash input view");
+    m_views.push_back(cached);
+    return m_views.back().view.get();
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,64 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+#include "ResourcePool.h"
+
+namespace ShaderBeam
+{
+
+// readbacks in flight, results come back a poll or two later at most
+#define GPU_HASH_DEPTH 3
+
+// TileHasher's tile grid hashed on the GPU that already holds the frame, only 8 bytes per tile come back to the CPU
+class GPUTileHasher
+{
+public:
+    void Start(ID3D11DeviceContext* context, ResourcePool& resourcePool, int width, int height);
+    void Stop();
+    bool IsStarted() const;
+
+    // queues hashing of texture, false if every readback is still in flight
+    bool Dispatch(ID3D11Texture2D* texture);
+    // oldest result if the GPU has finished it, never waits; results come back in dispatch order
+    bool Read(std::vector<uint64_t>& hashes);
+    // drops results still in flight
+    void Discard();
+
+private:
+    struct Readback
+    {
+        winrt::com_ptr<ID3D11Buffer> buffer;
+        winrt::com_ptr<ID3D11Query>  query;
+        bool                         pending { false };
+    };
+
+    struct CachedView
+    {
+        winrt::com_ptr<ID3D11Texture2D>          texture;
+        winrt::com_ptr<ID3D11ShaderResourceView> view;
+    };
+
+    winrt::com_ptr<ID3D11DeviceContext>       m_context;
+    winrt::com_ptr<ID3D11ComputeShader>       m_shader;
+    winrt::com_ptr<ID3D11Buffer>              m_hashBuffer;
+    winrt::com_ptr<ID3D11UnorderedAccessView> m_hashView;
+    // ring, dispatched into at next and read back from oldest
+    Readback                                  m_readbacks[GPU_HASH_DEPTH];
+    unsigned                                  m_nextReadback { 0 };
+    unsigned                                  m_oldestReadback { 0 };
+    std::vector<CachedView>                   m_views; // one per input slot
+    ResourcePool*                             m_resources { nullptr };
+    unsigned                                  m_tilesX { 0 };
+    unsigned                                  m_tilesY { 0 };
+
+    ID3D11ShaderResourceView* GetView(ID3D11Texture2D* texture);
+};
+
+} // namespace ShaderBeam
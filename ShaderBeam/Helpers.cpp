@@ -8,6 +8,8 @@ MIT License
 #include "stdafx.h"
 
 #include "Helpers.h"
+#include "ShaderCache.h"
+#include "EmbeddedShaders.h"
 
 namespace ShaderBeam
 {
@@ -131,10 +133,67 @@ void Helpers::Throw(HRESULT hr, const char* action)
     {
         _com_error err(hr);
         auto       error = err.ErrorMessage();        
-        throw std::runtime_error(action + std::string("\r\n") + Helpers::WCharToString(error));
+        throw HResultError(hr, action + std::string("\r\n") + Helpers::WCharToString(error));
     }
 }
 
+bool Helpers::IsDeviceLost(HRESULT hr)
+{
+    return hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET || hr == DXGI_ERROR_DEVICE_HUNG || hr == DXGI_ERROR_DRIVER_INTERNAL_ERROR;
+}
+
+std::vector<uint8_t> Helpers::CompileShader(const wchar_t* filename, const D3D_SHADER_MACRO* macros, const char* entryPoint, const char* target, ShaderCache* cache)
+{
+    // shipped permutations don't need the compiler at all, only edited sources do
+    std::vector<uint8_t> bytecode;
+    if(EmbeddedShaders::Find(filename, macros, entryPoint, target, bytecode))
+        return bytecode;
+
+    UINT flags = D3DCOMPILE_OPTIMIZATION_LEVEL3 | D3DCOMPILE_ENABLE_STRICTNESS;
+
+    auto compile = [&]() {
+        winrt::com_ptr<ID3DBlob> blob;
+        winrt::com_ptr<ID3DBlob> errorBlob;
+        auto hr = D3DCompileFromFile(filename, macros, D3D_COMPILE_STANDARD_FILE_INCLUDE, entryPoint, target, flags, 0, blob.put(), errorBlob.put());
+        if(FAILED(hr))
+        {
+            char* msg = NULL;
+            if(errorBlob)
+            {
+                msg = (char*)errorBlob->GetBufferPointer();
+                OutputDebugStringA(msg);
+            }
+            throw std::runtime_error(std::string("Unable to compile ") + (target[0] == 'v' ? "vertex" : target[0] == 'c' ? "compute" : "pixel") + " shader from\n" +
+                                     WCharToString(filename) + "\n" + (msg ? msg : ""));
+        }
+        auto data = (const uint8_t*)blob->GetBufferPointer();
+        return std::vector<uint8_t>(data, data + blob->GetBufferSize());
+    };
+
+    if(!cache)
+        return compile();
+
+    // the compiler DLL comes with Windows and changes with its updates, its timestamp stands in for a version
+    static const std::string compilerVersion = [flags]() {
+        std::string version = std::to_string(D3D_COMPILER_VERSION) + " " + std::to_string(flags);
+        wchar_t     path[MAX_PATH];
+        if(GetModuleFileNameW(GetModuleHandleW(D3DCOMPILER_DLL_W), path, MAX_PATH))
+        {
+            std::error_code error;
+            auto            written = std::filesystem::last_write_time(path, error);
+            if(!error)
+                version += " " + std::to_string(written.time_since_epoch().count());
+        }
+        return version;
+    }();
+
+    ShaderMacros shaderMacros;
+    for(auto macro = macros; macro && macro->Name; macro++)
+        shaderMacros.emplace_back(macro->Name, macro->Definition ? macro->Definition : "");
+
+    return cache->Get(filename, shaderMacros, entryPoint, target, compilerVersion, compile);
+}
+
 std::string Helpers::WCharToString(const wchar_t* text)
 {
     char utfString[256];
@@ -14,6 +14,23 @@ MIT License
 namespace ShaderBeam
 {
 
+class ShaderCache;
+
+// thrown by THROW, keeps the HRESULT so callers can tell device loss from transient failures
+class HResultError : public std::runtime_error
+{
+public:
+    HResultError(HRESULT hr, const std::string& message) : std::runtime_error(message), m_hr(hr) { }
+
+    HRESULT GetResult() const
+    {
+        return m_hr;
+    }
+
+private:
+    HRESULT m_hr;
+};
+
 class Helpers
 {
 public:
@@ -27,7 +44,9 @@ public:
     static float                        QPCToTicks(ULONGLONG qpc);
     static float                        QPCToDeltaMs(ULONGLONG qpc);
     static void                         Throw(HRESULT hr, const char* action);
+    static bool                         IsDeviceLost(HRESULT hr);
     static std::string                  WCharToString(const wchar_t* text);
+    static std::vector<uint8_t>         CompileShader(const wchar_t* filename, const D3D_SHADER_MACRO* macros, const char* entryPoint, const char* target, ShaderCache* cache = nullptr);
 
 private:
     static HRESULT CreateD3DDevice(D3D_DRIVER_TYPE const type, winrt::com_ptr<ID3D11Device>& device);
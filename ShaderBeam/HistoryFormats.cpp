@@ -0,0 +1,165 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "HistoryFormats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ShaderBeam
+{
+
+// unsigned small float with 5-bit exponent (bias 15), rounded to nearest even like D3D conversions
+static uint32_t PackSmallFloat(float value, int mantissaBits)
+{
+    if(!(value > 0))
+        return 0; // negative, zero or NaN
+
+    const uint32_t maxFinite = (30u << mantissaBits) | ((1u << mantissaBits) - 1);
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int      exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+    if(exponent >= 31)
+        return maxFinite;
+
+    int shift = 23 - mantissaBits;
+    if(exponent <= 0)
+    {
+        // denormal, implicit bit becomes explicit
+        if(exponent < -mantissaBits)
+            return 0;
+        mantissa |= 0x800000;
+        shift += 1 - exponent;
+        exponent = 0;
+    }
+
+    uint32_t result    = ((uint32_t)exponent << mantissaBits) + (mantissa >> shift);
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t half      = 1u << (shift - 1);
+    if(remainder > half || (remainder == half && (result & 1)))
+        result++; // may carry into exponent, which is still correct
+    return std::min(result, maxFinite);
+}
+
+static float UnpackSmallFloat(uint32_t value, int mantissaBits)
+{
+    const int      exponent = (int)(value >> mantissaBits);
+    const uint32_t mantissa = value & ((1u << mantissaBits) - 1);
+    if(exponent == 0)
+        return std::ldexp((float)mantissa, -14 - mantissaBits);
+    return std::ldexp((float)((1u << mantissaBits) | mantissa), exponent - 15 - mantissaBits);
+}
+
+uint32_t PackR11G11B10(float r, float g, float b)
+{
+    return PackSmallFloat(r, 6) | (PackSmallFloat(g, 6) << 11) | (PackSmallFloat(b, 5) << 22);
+}
+
+void UnpackR11G11B10(uint32_t packed, float& r, float& g, float& b)
+{
+    r = UnpackSmallFloat(packed & 0x7ff, 6);
+    g = UnpackSmallFloat((packed >> 11) & 0x7ff, 6);
+    b = UnpackSmallFloat(packed >> 22, 5);
+}
+
+std::vector<float> CreateReferenceFrame(unsigned width, unsigned height, float peak)
+{
+    std::vector<float> rgb(width * height * 3);
+    uint32_t           seed = 0x2545f491;
+    for(unsigned y = 0; y < height; y++)
+    {
+        for(unsigned x = 0; x < width; x++)
+        {
+            auto  pixel = &rgb[(y * width + x) * 3];
+            float u     = width > 1 ? x / (float)(width - 1) : 0;
+            if(y < height / 2)
+            {
+                // smooth ramps, one per channel, cover the whole range
+                pixel[0] = peak * u;
+                pixel[1] = peak * u * u;
+                pixel[2] = peak * (1.0f - u);
+            }
+            else
+            {
+                // saturated bars with hard edges (where chroma subsampling hurts) plus noise
+                seed           = seed * 1664525u + 1013904223u;
+                float    noise = (seed >> 8) / (float)(1 << 24) * 0.05f * peak;
+                unsigned bar   = (x * 8 / width) + 1;
+                pixel[0]       = (bar & 1 ? peak : 0.0f) * 0.9f + noise;
+                pixel[1]       = (bar & 2 ? peak : 0.0f) * 0.9f + noise;
+                pixel[2]       = (bar & 4 ? peak : 0.0f) * 0.9f + noise;
+            }
+        }
+    }
+    return rgb;
+}
+
+static QuantizationError Compare(const std::vector<float>& reference, const std::vector<float>& stored, float peak)
+{
+    QuantizationError error;
+    double            sumSquares = 0;
+    for(size_t i = 0; i < reference.size(); i++)
+    {
+        double diff = std::fabs((double)reference[i] - stored[i]);
+        sumSquares += diff * diff;
+        error.max = std::max(error.max, diff);
+    }
+    error.rms  = reference.empty() ? 0 : std::sqrt(sumSquares / reference.size());
+    error.psnr = error.rms > 0 ? 20.0 * std::log10(peak / error.rms) : 0;
+    return error;
+}
+
+QuantizationError MeasureR11G11B10(const std::vector<float>& rgb, float peak)
+{
+    std::vector<float> stored(rgb.size());
+    for(size_t i = 0; i + 2 < rgb.size(); i += 3)
+        UnpackR11G11B10(PackR11G11B10(rgb[i], rgb[i + 1], rgb[i + 2]), stored[i], stored[i + 1], stored[i + 2]);
+    return Compare(rgb, stored, peak);
+}
+
+QuantizationError MeasureHalfChroma(const std::vector<float>& rgb, unsigned width, unsigned height, float peak)
+{
+    // full resolution luma, 2x2 averaged chroma, point-sampled back like the input sampler does
+    const unsigned     chromaWidth  = (width + 1) / 2;
+    const unsigned     chromaHeight = (height + 1) / 2;
+    std::vector<float> co(chromaWidth * chromaHeight), cg(chromaWidth * chromaHeight), weight(chromaWidth * chromaHeight);
+    for(unsigned y = 0; y < height; y++)
+    {
+        for(unsigned x = 0; x < width; x++)
+        {
+            auto pixel = &rgb[(y * width + x) * 3];
+            auto c     = (y / 2) * chromaWidth + x / 2;
+            co[c] += 0.5f * pixel[0] - 0.5f * pixel[2];
+            cg[c] += -0.25f * pixel[0] + 0.5f * pixel[1] - 0.25f * pixel[2];
+            weight[c] += 1;
+        }
+    }
+
+    std::vector<float> stored(rgb.size());
+    for(unsigned y = 0; y < height; y++)
+    {
+        for(unsigned x = 0; x < width; x++)
+        {
+            auto  pixel = &rgb[(y * width + x) * 3];
+            auto  c     = (y / 2) * chromaWidth + x / 2;
+            float luma  = 0.25f * pixel[0] + 0.5f * pixel[1] + 0.25f * pixel[2];
+            float pCo   = co[c] / weight[c];
+            float pCg   = cg[c] / weight[c];
+            float tmp   = luma - pCg;
+            auto  out   = &stored[(y * width + x) * 3];
+            out[0]      = tmp + pCo;
+            out[1]      = luma + pCg;
+            out[2]      = tmp - pCo;
+        }
+    }
+    return Compare(rgb, stored, peak);
+}
+
+} // namespace ShaderBeam
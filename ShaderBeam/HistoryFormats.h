@@ -0,0 +1,39 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstdint>
+#include <vector>
+
+namespace ShaderBeam
+{
+
+// CPU reference for compact history storage, tells how much precision older frames lose
+
+struct QuantizationError
+{
+    double rms { 0 };
+    double max { 0 };
+    double psnr { 0 }; // dB relative to peak, 0 if lossless
+};
+
+// same layout and rounding as DXGI_FORMAT_R11G11B10_FLOAT, negatives become 0
+uint32_t PackR11G11B10(float r, float g, float b);
+void     UnpackR11G11B10(uint32_t packed, float& r, float& g, float& b);
+
+// linear RGB test frame with ramps, hard edges and noise up to peak
+std::vector<float> CreateReferenceFrame(unsigned width, unsigned height, float peak);
+
+// error of storing rgb (3 floats per pixel) as R11G11B10_FLOAT
+QuantizationError MeasureR11G11B10(const std::vector<float>& rgb, float peak);
+
+// error of storing rgb as YCoCg with chroma at half resolution in both directions
+QuantizationError MeasureHalfChroma(const std::vector<float>& rgb, unsigned width, unsigned height, float peak);
+} // namespace ShaderBeam
@@ -0,0 +1,113 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "HistoryRing.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+void HistoryRing::Create(const RenderContext& renderContext, int numFrames, unsigned width, unsigned height)
+{
+    auto vertexCode = Helpers::CompileShader(L"Shaders\\History.hlsl", nullptr, "VSmain", "vs_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreateVertexShader(vertexCode.data(), vertexCode.size(), NULL, m_vertexShader.put()), "Unable to create vertex shader");
+    auto pixelCode = Helpers::CompileShader(L"Shaders\\History.hlsl", nullptr, "PSmain", "ps_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreatePixelShader(pixelCode.data(), pixelCode.size(), NULL, m_pixelShader.put()), "Unable to create pixel shader");
+
+    D3D11_TEXTURE2D_DESC desc {};
+    desc.Width              = width;
+    desc.Height             = height;
+    desc.ArraySize          = 1;
+    desc.Format             = HISTORY_FORMAT;
+    desc.SampleDesc.Count   = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.MipLevels          = 1;
+    desc.MiscFlags          = 0;
+    desc.CPUAccessFlags     = 0;
+    desc.Usage              = D3D11_USAGE_DEFAULT;
+    desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+
+    static const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    m_resources = renderContext.resources;
+    m_frames.resize(numFrames);
+    for(auto& frame : m_frames)
+    {
+        frame.texture = m_resources->AcquireTexture(renderContext.device.get(), desc);
+        THROW(renderContext.device->CreateShaderResourceView(frame.texture.get(), nullptr, frame.view.put()), "Unable to create history view");
+        THROW(renderContext.device->CreateRenderTargetView(frame.texture.get(), nullptr, frame.target.put()), "Unable to create history target");
+        renderContext.deviceContext->ClearRenderTargetView(frame.target.get(), black);
+    }
+
+    m_width  = width;
+    m_height = height;
+    m_newest = 0;
+    m_views.resize(numFrames);
+    for(int age = 0; age < numFrames; age++)
+        m_views[age] = m_frames[age].view.get();
+}
+
+void HistoryRing::Destroy()
+{
+    m_views.clear();
+    for(auto& frame : m_frames)
+    {
+        frame.target = nullptr;
+        frame.view   = nullptr;
+        m_resources->Release(frame.texture);
+    }
+    m_frames.clear();
+    m_pixelShader  = nullptr;
+    m_vertexShader = nullptr;
+}
+
+bool HistoryRing::IsEnabled() const
+{
+    return !m_frames.empty();
+}
+
+void HistoryRing::Push(const RenderContext& renderContext, ID3D11ShaderResourceView* input)
+{
+    if(m_frames.empty())
+        return;
+
+    const auto numFrames = (unsigned)m_frames.size();
+    m_newest             = (m_newest + numFrames - 1) % numFrames;
+    const auto& frame    = m_frames[m_newest];
+
+    // caller restores viewport, scissor and targets for the main pass
+    D3D11_VIEWPORT viewport = { 0.0f, 0.0f, (float)m_width, (float)m_height, 0.0f, 1.0f };
+    D3D11_RECT     scissor  = { 0, 0, (LONG)m_width, (LONG)m_height };
+    renderContext.deviceContext->RSSetViewports(1, &viewport);
+    renderContext.deviceContext->RSSetScissorRects(1, &scissor);
+
+    ID3D11RenderTargetView* targets[1] = { frame.target.get() };
+    renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
+
+    renderContext.deviceContext->VSSetShader(m_vertexShader.get(), NULL, 0);
+    renderContext.deviceContext->PSSetShader(m_pixelShader.get(), NULL, 0);
+    renderContext.deviceContext->IASetInputLayout(NULL);
+    renderContext.deviceContext->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    renderContext.deviceContext->PSSetShaderResources(0, 1, &input);
+    renderContext.deviceContext->Draw(3, 0);
+
+    ID3D11ShaderResourceView* nullv[] = { nullptr };
+    renderContext.deviceContext->PSSetShaderResources(0, 1, nullv);
+    ID3D11RenderTargetView* null[] = { nullptr };
+    renderContext.deviceContext->OMSetRenderTargets(1, null, NULL);
+
+    for(unsigned age = 0; age < numFrames; age++)
+        m_views[age] = m_frames[(m_newest + age) % numFrames].view.get();
+}
+
+const std::vector<ID3D11ShaderResourceView*>& HistoryRing::GetViews() const
+{
+    return m_views;
+}
+
+} // namespace ShaderBeam
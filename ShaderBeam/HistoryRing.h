@@ -0,0 +1,49 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+#include "RenderContext.h"
+
+namespace ShaderBeam
+{
+
+#define HISTORY_FORMAT DXGI_FORMAT_R11G11B10_FLOAT
+
+// older input frames kept in a compact format, converted from full precision input as they leave slot 0
+class HistoryRing
+{
+public:
+    void Create(const RenderContext& renderContext, int numFrames, unsigned width, unsigned height);
+    void Destroy();
+    bool IsEnabled() const;
+
+    // converts input into the oldest history frame, which becomes the newest
+    void Push(const RenderContext& renderContext, ID3D11ShaderResourceView* input);
+
+    // newest first
+    const std::vector<ID3D11ShaderResourceView*>& GetViews() const;
+
+private:
+    struct HistoryFrame
+    {
+        winrt::com_ptr<ID3D11Texture2D>          texture;
+        winrt::com_ptr<ID3D11ShaderResourceView> view;
+        winrt::com_ptr<ID3D11RenderTargetView>   target;
+    };
+
+    std::vector<HistoryFrame>              m_frames;
+    std::vector<ID3D11ShaderResourceView*> m_views;
+    unsigned                               m_newest { 0 };
+    unsigned                               m_width { 0 };
+    unsigned                               m_height { 0 };
+    winrt::com_ptr<ID3D11VertexShader>     m_vertexShader;
+    winrt::com_ptr<ID3D11PixelShader>      m_pixelShader;
+    ResourcePool*                          m_resources { nullptr };
+};
+} // namespace ShaderBeam
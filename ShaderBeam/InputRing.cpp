@@ -0,0 +1,128 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "InputRing.h"
+
+#include <stdexcept>
+
+namespace ShaderBeam
+{
+
+void InputRing::Reset(int depth, int numHeld, int numSlots)
+{
+    if(numHeld > depth || numHeld > numSlots)
+        throw std::runtime_error("Not enough input textures for history");
+
+    // every frame starts out as a different (blank) texture, as many as are held
+    m_frames.assign(depth, InputFrame {});
+    m_slotHolders.assign(numSlots, 0);
+    m_slotGenerations.assign(numSlots, 0);
+    m_newest  = 0;
+    m_numHeld = numHeld;
+    for(int age = 0; age < numHeld; age++)
+    {
+        m_frames[age].slot = age;
+        m_slotHolders[age]++;
+    }
+}
+
+int InputRing::GetNextSlot() const
+{
+    for(int slot = 0; slot < (int)m_slotHolders.size(); slot++)
+        if(m_slotHolders[slot] == 0)
+            return slot;
+
+    // all in use, overwrite the oldest
+    return m_numHeld ? GetSlot(m_numHeld - 1) : 0;
+}
+
+void InputRing::Push(float arrived, FrameContent content, const std::vector<uint8_t>* changedTiles)
+{
+    if(m_frames.empty())
+        return;
+
+    const int slot = GetNextSlot();
+    Advance();
+
+    auto& frame      = m_frames[m_newest];
+    frame.slot       = slot;
+    frame.generation = m_nextGeneration++;
+    frame.arrived    = arrived;
+    frame.content    = content;
+    if(changedTiles)
+        frame.changedTiles.assign(changedTiles->begin(), changedTiles->end());
+    else
+        frame.changedTiles.clear();
+
+    m_slotHolders[slot]++;
+    m_slotGenerations[slot] = frame.generation;
+}
+
+void InputRing::Repeat()
+{
+    if(m_frames.size() < 2)
+        return;
+
+    const int previous = m_newest;
+    Advance();
+
+    auto& frame      = m_frames[m_newest];
+    frame.slot       = m_frames[previous].slot;
+    frame.generation = m_frames[previous].generation;
+    frame.arrived    = m_frames[previous].arrived;
+    frame.content    = FrameContent::Identical;
+    frame.changedTiles.clear();
+
+    m_slotHolders[frame.slot]++;
+}
+
+int InputRing::GetDepth() const
+{
+    return (int)m_frames.size();
+}
+
+int InputRing::GetNumHeld() const
+{
+    return m_numHeld;
+}
+
+const InputFrame& InputRing::Get(int age) const
+{
+    return m_frames[GetIndex(age)];
+}
+
+int InputRing::GetSlot(int age) const
+{
+    return m_frames[GetIndex(age)].slot;
+}
+
+uint64_t InputRing::GetGeneration(int age) const
+{
+    return m_frames[GetIndex(age)].generation;
+}
+
+bool InputRing::IsCurrent(int slot, uint64_t generation) const
+{
+    return slot >= 0 && slot < (int)m_slotGenerations.size() && m_slotGenerations[slot] == generation;
+}
+
+int InputRing::GetIndex(int age) const
+{
+    return (m_newest + age) % (int)m_frames.size();
+}
+
+void InputRing::Advance()
+{
+    // frame aging out of the held ones lets go of its texture
+    if(m_numHeld > 0)
+        m_slotHolders[GetSlot(m_numHeld - 1)]--;
+
+    const auto depth = (int)m_frames.size();
+    m_newest         = (m_newest + depth - 1) % depth;
+}
+
+} // namespace ShaderBeam
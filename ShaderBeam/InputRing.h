@@ -0,0 +1,67 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstdint>
+#include <vector>
+
+#include "TileHasher.h"
+
+namespace ShaderBeam
+{
+
+// one frame in input history; repeats of the same captured frame share its generation
+struct InputFrame
+{
+    int                  slot { -1 };       // input texture, only meaningful for the newest held ones
+    uint64_t             generation { 0 };  // 0 until a frame arrives
+    float                arrived { 0.0f };  // ticks when renderer received it
+    FrameContent         content { FrameContent::New };
+    std::vector<uint8_t> changedTiles;      // per tile as found by tile hashing, empty when unknown
+};
+
+// input history newest first with a fixed depth, backed by a fixed set of input textures;
+// the newest few frames hold their texture, older ones may live elsewhere (e.g. compact history)
+class InputRing
+{
+public:
+    // numHeld newest frames keep their texture, numSlots textures to rotate through
+    void Reset(int depth, int numHeld, int numSlots);
+
+    // texture capture should write the next frame into, one nothing holds or the oldest held one
+    int GetNextSlot() const;
+
+    // frame just written into GetNextSlot becomes the newest
+    void Push(float arrived, FrameContent content, const std::vector<uint8_t>* changedTiles);
+
+    // nothing arrived, newest frame is shown again and everything else ages
+    void Repeat();
+
+    int               GetDepth() const;
+    int               GetNumHeld() const;
+    const InputFrame& Get(int age) const;
+    int               GetSlot(int age) const;
+    uint64_t          GetGeneration(int age) const;
+
+    // false once the slot has been written again, e.g. something cached from it is stale
+    bool IsCurrent(int slot, uint64_t generation) const;
+
+private:
+    std::vector<InputFrame> m_frames; // ring, m_newest is age 0
+    std::vector<int>        m_slotHolders;
+    std::vector<uint64_t>   m_slotGenerations;
+    int                     m_newest { 0 };
+    int                     m_numHeld { 0 };
+    uint64_t                m_nextGeneration { 1 };
+
+    int  GetIndex(int age) const;
+    void Advance();
+};
+} // namespace ShaderBeam
@@ -0,0 +1,265 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "MultiPassShaderProfile.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+int MultiPassShaderProfile::AddTarget(DXGI_FORMAT format, int divisor)
+{
+    // sized once inputs are known, they can change without the profile being re-created
+    m_targetFormats.push_back({ format, divisor });
+    return m_graph.AddTarget({ .format = (unsigned)format, .bytesPerPixel = ResourcePool::GetBytesPerPixel(format) });
+}
+
+int MultiPassShaderProfile::AddPass(const wchar_t*          filename,
+                                    const D3D_SHADER_MACRO* macros,
+                                    const char*             entryPoint,
+                                    const std::vector<int>& inputs,
+                                    int                     target,
+                                    int                     rate,
+                                    const RenderContext&    renderContext)
+{
+    for(auto input : inputs)
+        if(IsPassSource(input) && GetSourceAge(input) >= m_numInputs)
+            throw std::runtime_error("Pass reads more inputs than the profile requests");
+
+    auto& pass  = m_passes.emplace_back();
+    pass.inputs = inputs;
+    pass.target = target;
+
+    auto& vertexShader = m_vertexShaders[filename];
+    if(!vertexShader)
+    {
+        auto vertexCode = Helpers::CompileShader(filename, macros, "VSmain", "vs_5_0", renderContext.shaderCache);
+        THROW(renderContext.device->CreateVertexShader(vertexCode.data(), vertexCode.size(), NULL, vertexShader.put()), "Unable to create vertex shader");
+    }
+    pass.vertexShader = vertexShader;
+
+    auto pixelCode = Helpers::CompileShader(filename, macros, entryPoint, "ps_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreatePixelShader(pixelCode.data(), pixelCode.size(), NULL, pass.pixelShader.put()), "Unable to create pixel shader");
+
+    return m_graph.AddPass(inputs, target, rate);
+}
+
+void MultiPassShaderProfile::SetParameterBuffer(void* data, int size, const RenderContext& renderContext)
+{
+    m_parametersBuffer = data;
+    m_parametersSize   = size;
+    m_cachedParameters.assign((uint8_t*)data, (uint8_t*)data + size);
+
+    D3D11_BUFFER_DESC constantBufferDesc {};
+    constantBufferDesc.ByteWidth      = (size + 0xf) & 0xfffffff0;
+    constantBufferDesc.Usage          = D3D11_USAGE_DYNAMIC;
+    constantBufferDesc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+    constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    THROW(renderContext.device->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.put()), "Unable to create constant buffer");
+}
+
+void MultiPassShaderProfile::CreatePipeline(const RenderContext& renderContext)
+{
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter             = D3D11_FILTER_MIN_MAG_MIP_POINT;
+    samplerDesc.AddressU           = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.AddressV           = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.AddressW           = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.BorderColor[0]     = 0.0f;
+    samplerDesc.BorderColor[1]     = 0.0f;
+    samplerDesc.BorderColor[2]     = 0.0f;
+    samplerDesc.BorderColor[3]     = 0.0f;
+    samplerDesc.ComparisonFunc     = D3D11_COMPARISON_NEVER;
+    THROW(renderContext.device->CreateSamplerState(&samplerDesc, m_pointSampler.put()), "Unable to create sampler");
+
+    // for resampling between input and intermediates of a different size
+    samplerDesc.Filter   = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+    THROW(renderContext.device->CreateSamplerState(&samplerDesc, m_linearSampler.put()), "Unable to create sampler");
+
+    D3D11_BUFFER_DESC passBufferDesc {};
+    passBufferDesc.ByteWidth = sizeof(PassConstants);
+    passBufferDesc.Usage     = D3D11_USAGE_DEFAULT;
+    passBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    THROW(renderContext.device->CreateBuffer(&passBufferDesc, nullptr, m_passBuffer.put()), "Unable to create pass buffer");
+
+    m_targetsWidth  = 0;
+    m_targetsHeight = 0;
+    m_invalid       = true;
+}
+
+void MultiPassShaderProfile::AllocateTargets(const RenderContext& renderContext)
+{
+    const auto& options = renderContext.options;
+    for(int target = 0; target < (int)m_targetFormats.size(); target++)
+    {
+        const auto& format = m_targetFormats[target];
+        m_graph.SetTargetDesc(target,
+                              { .width         = max(1u, options.inputWidth / format.divisor),
+                                .height        = max(1u, options.inputHeight / format.divisor),
+                                .format        = (unsigned)format.format,
+                                .bytesPerPixel = ResourcePool::GetBytesPerPixel(format.format) });
+    }
+
+    m_graph.Compile();
+    m_pool.Allocate(renderContext, m_graph.GetSlots());
+    m_targetsWidth  = options.inputWidth;
+    m_targetsHeight = options.inputHeight;
+    m_invalid       = true;
+}
+
+void MultiPassShaderProfile::RenderPipeline(const RenderContext& renderContext)
+{
+    const auto& options = renderContext.options;
+    if(m_targetsWidth != options.inputWidth || m_targetsHeight != options.inputHeight)
+        AllocateTargets(renderContext);
+
+    // per-input passes are cached for as long as the frames they read stay the same (even if written into the same texture)
+    bool sourcesChanged = m_invalid;
+    for(int age = 0; age < m_graph.GetNumSourcesCached(); age++)
+    {
+        auto generation = renderContext.inputs.GetGeneration(age);
+        if(m_cachedGenerations[age] != generation)
+        {
+            m_cachedGenerations[age] = generation;
+            sourcesChanged           = true;
+        }
+    }
+    m_invalid = false;
+
+    // Renderer set these up for the output, intermediates change them
+    UINT           numViewports = 1;
+    UINT           numScissors  = 1;
+    D3D11_VIEWPORT outputViewport {};
+    D3D11_RECT     outputScissor {};
+    renderContext.deviceContext->RSGetViewports(&numViewports, &outputViewport);
+    renderContext.deviceContext->RSGetScissorRects(&numScissors, &outputScissor);
+
+    renderContext.deviceContext->IASetInputLayout(NULL);
+    renderContext.deviceContext->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    ID3D11Buffer* buffer[1] = { m_constantBuffer.get() };
+    renderContext.deviceContext->VSSetConstantBuffers(0, 1, buffer);
+    renderContext.deviceContext->PSSetConstantBuffers(0, 1, buffer);
+    buffer[0] = m_passBuffer.get();
+    renderContext.deviceContext->VSSetConstantBuffers(2, 1, buffer);
+    renderContext.deviceContext->PSSetConstantBuffers(2, 1, buffer);
+
+    ID3D11SamplerState* samplers[2] = { m_pointSampler.get(), m_linearSampler.get() };
+    renderContext.deviceContext->PSSetSamplers(2, 2, samplers);
+
+    for(auto pass : m_graph.Schedule(sourcesChanged))
+        RunPass(renderContext, m_passes[pass], outputViewport, outputScissor);
+
+    ID3D11RenderTargetView* targets[1] = { renderContext.outputTargetView.get() };
+    renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
+    renderContext.deviceContext->RSSetViewports(1, &outputViewport);
+    renderContext.deviceContext->RSSetScissorRects(1, &outputScissor);
+
+    ID3D11Buffer* nullb[1] = { nullptr };
+    renderContext.deviceContext->VSSetConstantBuffers(0, 1, nullb);
+    renderContext.deviceContext->PSSetConstantBuffers(0, 1, nullb);
+    renderContext.deviceContext->VSSetConstantBuffers(2, 1, nullb);
+    renderContext.deviceContext->PSSetConstantBuffers(2, 1, nullb);
+
+    ID3D11SamplerState* nulls[2] = { nullptr, nullptr };
+    renderContext.deviceContext->PSSetSamplers(2, 2, nulls);
+}
+
+void MultiPassShaderProfile::RunPass(const RenderContext& renderContext, const Pass& pass, const D3D11_VIEWPORT& outputViewport, const D3D11_RECT& outputScissor)
+{
+    PassConstants constants {};
+    constants.subFrameNo = renderContext.subFrameNo;
+    constants.subFrames  = renderContext.options.subFrames;
+    constants.frameNo    = renderContext.frameNo;
+
+    ID3D11RenderTargetView* targets[1];
+    if(pass.target == PASS_OUTPUT)
+    {
+        targets[0]              = renderContext.outputTargetView.get();
+        constants.targetSize[0] = outputViewport.Width;
+        constants.targetSize[1] = outputViewport.Height;
+        renderContext.deviceContext->RSSetViewports(1, &outputViewport);
+        renderContext.deviceContext->RSSetScissorRects(1, &outputScissor);
+    }
+    else
+    {
+        const auto& desc        = m_graph.GetSlots()[m_graph.GetSlot(pass.target)];
+        targets[0]              = m_pool.GetTarget(m_graph.GetSlot(pass.target));
+        constants.targetSize[0] = (float)desc.width;
+        constants.targetSize[1] = (float)desc.height;
+
+        D3D11_VIEWPORT viewport = { 0.0f, 0.0f, (float)desc.width, (float)desc.height, 0.0f, 1.0f };
+        D3D11_RECT     scissor  = { 0, 0, (LONG)desc.width, (LONG)desc.height };
+        renderContext.deviceContext->RSSetViewports(1, &viewport);
+        renderContext.deviceContext->RSSetScissorRects(1, &scissor);
+    }
+    constants.texelSize[0] = 1.0f / constants.targetSize[0];
+    constants.texelSize[1] = 1.0f / constants.targetSize[1];
+    renderContext.deviceContext->UpdateSubresource(m_passBuffer.get(), 0, nullptr, &constants, 0, 0);
+
+    renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
+    renderContext.deviceContext->VSSetShader(pass.vertexShader.get(), NULL, 0);
+    renderContext.deviceContext->PSSetShader(pass.pixelShader.get(), NULL, 0);
+
+    const auto                numInputs = (UINT)pass.inputs.size();
+    ID3D11ShaderResourceView* shaderInputs[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT - 2];
+    for(UINT slot = 0; slot < numInputs; slot++)
+    {
+        const auto input   = pass.inputs[slot];
+        shaderInputs[slot] = IsPassSource(input) ? renderContext.GetInputView(GetSourceAge(input)) : m_pool.GetView(m_graph.GetSlot(input));
+    }
+    renderContext.deviceContext->PSSetShaderResources(2, numInputs, shaderInputs);
+
+    renderContext.deviceContext->Draw(3, 0);
+
+    // next pass may write what this one read
+    ID3D11RenderTargetView* null[] = { nullptr };
+    renderContext.deviceContext->OMSetRenderTargets(1, null, NULL);
+    for(UINT slot = 0; slot < numInputs; slot++)
+        shaderInputs[slot] = nullptr;
+    renderContext.deviceContext->PSSetShaderResources(2, numInputs, shaderInputs);
+}
+
+void MultiPassShaderProfile::UpdateParameters(const RenderContext& renderContext)
+{
+    if(memcmp(m_cachedParameters.data(), m_parametersBuffer, m_parametersSize) != 0)
+    {
+        memcpy(m_cachedParameters.data(), m_parametersBuffer, m_parametersSize);
+        m_invalid = true;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+    renderContext.deviceContext->Map(m_constantBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+    memcpy(mappedSubresource.pData, m_parametersBuffer, m_parametersSize);
+    renderContext.deviceContext->Unmap(m_constantBuffer.get(), 0);
+}
+
+void MultiPassShaderProfile::Invalidate()
+{
+    m_invalid = true;
+}
+
+void MultiPassShaderProfile::Destroy()
+{
+    m_pool.Destroy();
+    m_graph.Clear();
+    m_passes.clear();
+    m_targetFormats.clear();
+    m_vertexShaders.clear();
+    std::fill(std::begin(m_cachedGenerations), std::end(m_cachedGenerations), 0);
+
+    m_passBuffer     = nullptr;
+    m_constantBuffer = nullptr;
+    m_linearSampler  = nullptr;
+    m_pointSampler   = nullptr;
+}
+} // namespace ShaderBeam
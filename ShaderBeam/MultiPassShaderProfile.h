@@ -0,0 +1,96 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "ShaderProfile.h"
+#include "PassGraph.h"
+#include "TransientTargetPool.h"
+
+namespace ShaderBeam
+{
+
+// constants set for every pass at b2, params at b0 and input area at b1 as in single pass profiles
+struct PassConstants
+{
+    float    targetSize[2];
+    float    texelSize[2];
+    unsigned subFrameNo;
+    unsigned subFrames;
+    unsigned frameNo;
+    unsigned padding;
+};
+
+// profile built from a chain of passes, each reading inputs and earlier intermediates from t2 onwards;
+// per-input passes are only re-run when source frames or params change, their results are reused on other subframes
+class MultiPassShaderProfile : public ShaderProfile
+{
+public:
+    virtual void Destroy();
+
+protected:
+    // intermediate at input resolution divided by divisor
+    int AddTarget(DXGI_FORMAT format, int divisor);
+
+    // pixel shader entryPoint and VSmain from filename; inputs are PassSource(age) or targets, target is one of ours or PASS_OUTPUT
+    int AddPass(const wchar_t*          filename,
+                const D3D_SHADER_MACRO* macros,
+                const char*             entryPoint,
+                const std::vector<int>& inputs,
+                int                     target,
+                int                     rate,
+                const RenderContext&    renderContext);
+
+    void SetParameterBuffer(void* data, int size, const RenderContext& renderContext);
+    void CreatePipeline(const RenderContext& renderContext);
+    void RenderPipeline(const RenderContext& renderContext);
+
+    // any change to params re-runs every pass, values that change each subframe belong in the shader (see PassConstants)
+    void UpdateParameters(const RenderContext& renderContext);
+
+    // e.g. after a setting outside params changed
+    void Invalidate();
+
+private:
+    struct TargetFormat
+    {
+        DXGI_FORMAT format;
+        int         divisor;
+    };
+
+    struct Pass
+    {
+        winrt::com_ptr<ID3D11VertexShader> vertexShader;
+        winrt::com_ptr<ID3D11PixelShader>  pixelShader;
+        std::vector<int>                   inputs;
+        int                                target;
+    };
+
+    void AllocateTargets(const RenderContext& renderContext);
+    void RunPass(const RenderContext& renderContext, const Pass& pass, const D3D11_VIEWPORT& outputViewport, const D3D11_RECT& outputScissor);
+
+    PassGraph                 m_graph;
+    TransientTargetPool       m_pool;
+    std::vector<TargetFormat> m_targetFormats;
+    std::vector<Pass>         m_passes;
+    unsigned                  m_targetsWidth { 0 };
+    unsigned                  m_targetsHeight { 0 };
+    bool                      m_invalid { true };
+    uint64_t                  m_cachedGenerations[MAX_INPUTS] {};
+
+    void*                m_parametersBuffer { nullptr };
+    int                  m_parametersSize { 0 };
+    std::vector<uint8_t> m_cachedParameters;
+
+    std::map<std::wstring, winrt::com_ptr<ID3D11VertexShader>> m_vertexShaders;
+
+    winrt::com_ptr<ID3D11SamplerState> m_pointSampler;
+    winrt::com_ptr<ID3D11SamplerState> m_linearSampler;
+    winrt::com_ptr<ID3D11Buffer>       m_constantBuffer;
+    winrt::com_ptr<ID3D11Buffer>       m_passBuffer;
+};
+} // namespace ShaderBeam
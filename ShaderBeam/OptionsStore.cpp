@@ -0,0 +1,36 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "OptionsStore.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+uint64_t OptionsStore::Publish(const Options& options)
+{
+    auto version = m_version.load() + 1;
+    m_snapshot.store(std::make_shared<const OptionsSnapshot>(OptionsSnapshot { version, Helpers::GetTicks(), options }));
+
+    // version goes out last so whoever sees it is guaranteed to load this snapshot (or a newer one)
+    m_version.store(version);
+    return version;
+}
+
+std::shared_ptr<const OptionsSnapshot> OptionsStore::Acquire() const
+{
+    return m_snapshot.load();
+}
+
+uint64_t OptionsStore::GetVersion() const
+{
+    return m_version.load();
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,38 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "Common.h"
+
+namespace ShaderBeam
+{
+
+struct OptionsSnapshot
+{
+    uint64_t version;
+    float    published; // ticks
+    Options  options;
+};
+
+// single-writer (message thread) store of immutable Options snapshots;
+// readers grab the current snapshot with an atomic load and never see a half-written struct
+class OptionsStore
+{
+public:
+    uint64_t                               Publish(const Options& options);
+    std::shared_ptr<const OptionsSnapshot> Acquire() const;
+    uint64_t                               GetVersion() const;
+
+private:
+    std::atomic<std::shared_ptr<const OptionsSnapshot>> m_snapshot;
+    std::atomic<uint64_t>                               m_version { 0 };
+};
+} // namespace ShaderBeam
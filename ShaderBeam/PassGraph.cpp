@@ -0,0 +1,210 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "PassGraph.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ShaderBeam
+{
+
+void PassGraph::Clear()
+{
+    m_passes.clear();
+    m_targets.clear();
+    m_slots.clear();
+    m_schedule.clear();
+    m_compiled = false;
+    m_primed   = false;
+}
+
+int PassGraph::AddTarget(const TargetDesc& desc)
+{
+    m_targets.push_back({ .desc = desc });
+    m_compiled = false;
+    return (int)m_targets.size() - 1;
+}
+
+void PassGraph::SetTargetDesc(int target, const TargetDesc& desc)
+{
+    if(m_targets[target].desc != desc)
+    {
+        m_targets[target].desc = desc;
+        m_compiled             = false;
+    }
+}
+
+int PassGraph::AddPass(const std::vector<int>& inputs, int target, int rate)
+{
+    const int pass = (int)m_passes.size();
+    if(target == PASS_OUTPUT)
+        rate = PASS_PER_SUBFRAME; // output is a new buffer every subframe
+    else if(target < 0 || target >= (int)m_targets.size())
+        throw std::runtime_error("Pass writes an unknown target");
+    else if(m_targets[target].writer != -1)
+        throw std::runtime_error("Target is written by more than one pass");
+
+    for(auto input : inputs)
+    {
+        if(IsPassSource(input))
+            continue;
+        if(input < 0 || input >= (int)m_targets.size() || m_targets[input].writer == -1)
+            throw std::runtime_error("Pass reads a target no earlier pass writes");
+        if(input == target)
+            throw std::runtime_error("Pass reads its own target");
+
+        // results that change every subframe make the reader change every subframe
+        if(m_passes[m_targets[input].writer].rate == PASS_PER_SUBFRAME)
+            rate = PASS_PER_SUBFRAME;
+        m_targets[input].lastReader = pass;
+    }
+
+    if(target != PASS_OUTPUT)
+        m_targets[target].writer = pass;
+    m_passes.push_back({ inputs, target, rate });
+    m_compiled = false;
+    return pass;
+}
+
+void PassGraph::Compile()
+{
+    for(auto& target : m_targets)
+    {
+        if(target.writer == -1)
+            throw std::runtime_error("Target is never written");
+        target.persistent = false;
+        target.slot       = -1;
+    }
+
+    // a per-input result read every subframe has to survive until the next input
+    for(const auto& pass : m_passes)
+    {
+        if(pass.rate != PASS_PER_SUBFRAME)
+            continue;
+        for(auto input : pass.inputs)
+            if(!IsPassSource(input) && m_passes[m_targets[input].writer].rate == PASS_PER_INPUT)
+                m_targets[input].persistent = true;
+    }
+
+    // targets are written in pass order, first fit into a slot of the same desc whose other targets are all dead
+    m_slots.clear();
+    for(const auto& pass : m_passes)
+    {
+        if(pass.target == PASS_OUTPUT)
+            continue;
+
+        auto& target = m_targets[pass.target];
+        for(int slot = 0; slot < (int)m_slots.size() && target.slot == -1; slot++)
+        {
+            if(m_slots[slot] != target.desc)
+                continue;
+
+            bool free = true;
+            for(const auto& other : m_targets)
+                if(other.slot == slot && Conflicts(target, other))
+                    free = false;
+            if(free)
+                target.slot = slot;
+        }
+        if(target.slot == -1)
+        {
+            target.slot = (int)m_slots.size();
+            m_slots.push_back(target.desc);
+        }
+    }
+
+    m_compiled = true;
+    m_primed   = false;
+}
+
+bool PassGraph::Conflicts(const Target& a, const Target& b) const
+{
+    // persistent targets stay live from their writer until the graph runs again, through every subframe
+    if(a.persistent && b.persistent)
+        return true;
+    if((a.persistent && m_passes[b.writer].rate == PASS_PER_SUBFRAME) || (b.persistent && m_passes[a.writer].rate == PASS_PER_SUBFRAME))
+        return true;
+
+    const int end   = (int)m_passes.size();
+    const int aLast = a.persistent ? end : std::max(a.writer, a.lastReader);
+    const int bLast = b.persistent ? end : std::max(b.writer, b.lastReader);
+    return a.writer <= bLast && b.writer <= aLast;
+}
+
+const std::vector<int>& PassGraph::Schedule(bool sourcesChanged)
+{
+    if(!m_compiled)
+        throw std::runtime_error("Pass graph is not compiled");
+
+    // nothing is cached right after compiling, slots may hold anything
+    const bool all = sourcesChanged || !m_primed;
+    m_primed       = true;
+
+    m_schedule.clear();
+    for(int pass = 0; pass < (int)m_passes.size(); pass++)
+        if(all || m_passes[pass].rate == PASS_PER_SUBFRAME)
+            m_schedule.push_back(pass);
+    return m_schedule;
+}
+
+int PassGraph::GetRate(int pass) const
+{
+    return m_passes[pass].rate;
+}
+
+bool PassGraph::IsPersistent(int target) const
+{
+    return m_targets[target].persistent;
+}
+
+int PassGraph::GetSlot(int target) const
+{
+    return m_targets[target].slot;
+}
+
+const std::vector<TargetDesc>& PassGraph::GetSlots() const
+{
+    return m_slots;
+}
+
+int PassGraph::GetNumPasses() const
+{
+    return (int)m_passes.size();
+}
+
+int PassGraph::GetNumSourcesCached() const
+{
+    int numSources = 0;
+    for(const auto& pass : m_passes)
+    {
+        if(pass.rate != PASS_PER_INPUT)
+            continue;
+        for(auto input : pass.inputs)
+            if(IsPassSource(input))
+                numSources = std::max(numSources, GetSourceAge(input) + 1);
+    }
+    return numSources;
+}
+
+size_t PassGraph::GetRequestedBytes() const
+{
+    size_t bytes = 0;
+    for(const auto& target : m_targets)
+        bytes += target.desc.GetBytes();
+    return bytes;
+}
+
+size_t PassGraph::GetAllocatedBytes() const
+{
+    size_t bytes = 0;
+    for(const auto& slot : m_slots)
+        bytes += slot.GetBytes();
+    return bytes;
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,108 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstddef>
+#include <vector>
+
+namespace ShaderBeam
+{
+
+constexpr int PASS_PER_INPUT    = 0; // runs when source frames or parameters change
+constexpr int PASS_PER_SUBFRAME = 1; // runs on every subframe
+
+// resources are intermediate targets (0 and up), the output or input frames by age
+constexpr int PASS_OUTPUT = -1;
+
+constexpr int PassSource(int age)
+{
+    return -2 - age;
+}
+
+constexpr bool IsPassSource(int resource)
+{
+    return resource <= -2;
+}
+
+constexpr int GetSourceAge(int resource)
+{
+    return -2 - resource;
+}
+
+struct TargetDesc
+{
+    unsigned width { 0 };
+    unsigned height { 0 };
+    unsigned format { 0 };
+    unsigned bytesPerPixel { 0 };
+
+    bool operator==(const TargetDesc& other) const = default;
+
+    size_t GetBytes() const
+    {
+        return (size_t)width * height * bytesPerPixel;
+    }
+};
+
+// passes in the order they execute, each reading earlier results and writing one resource;
+// works out which passes need to run and which intermediates can share a texture
+class PassGraph
+{
+public:
+    void Clear();
+
+    int  AddTarget(const TargetDesc& desc);
+    void SetTargetDesc(int target, const TargetDesc& desc);
+
+    // inputs have to be written by earlier passes, throws otherwise; passes writing the output always run per subframe
+    int AddPass(const std::vector<int>& inputs, int target, int rate);
+
+    // assigns targets to slots, needed after adding passes or changing target descs
+    void Compile();
+
+    // passes to run this subframe, in order; per-input ones only when sources changed (or after Compile)
+    const std::vector<int>& Schedule(bool sourcesChanged);
+
+    int                            GetRate(int pass) const; // effective, a pass reading per-subframe results is per-subframe too
+    bool                           IsPersistent(int target) const;
+    int                            GetSlot(int target) const;
+    const std::vector<TargetDesc>& GetSlots() const;
+    int                            GetNumPasses() const;
+    int                            GetNumSourcesCached() const; // newest frames per-input passes read
+    size_t                         GetRequestedBytes() const;   // all targets in their own textures
+    size_t                         GetAllocatedBytes() const;   // after sharing
+
+private:
+    struct Pass
+    {
+        std::vector<int> inputs;
+        int              target;
+        int              rate;
+    };
+
+    struct Target
+    {
+        TargetDesc desc;
+        int        writer { -1 };
+        int        lastReader { -1 };
+        bool       persistent { false };
+        int        slot { -1 };
+    };
+
+    std::vector<Pass>       m_passes;
+    std::vector<Target>     m_targets;
+    std::vector<TargetDesc> m_slots;
+    std::vector<int>        m_schedule;
+    bool                    m_compiled { false };
+    bool                    m_primed { false };
+
+    bool Conflicts(const Target& a, const Target& b) const;
+};
+} // namespace ShaderBeam
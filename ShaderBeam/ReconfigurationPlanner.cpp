@@ -0,0 +1,88 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "ReconfigurationPlanner.h"
+
+namespace ShaderBeam
+{
+
+unsigned ReconfigurationPlanner::Plan(const Options& from, const Options& to)
+{
+    unsigned flags = 0;
+
+    // anything that changes the device, swapchain, input textures or compiled shaders (GPU thread priority is set on both devices at creation)
+    if(from.captureAdapterNo != to.captureAdapterNo || from.shaderAdapterNo != to.shaderAdapterNo ||
+       from.shaderDisplayNo != to.shaderDisplayNo || from.hardwareSrgb != to.hardwareSrgb || from.useHdr != to.useHdr || from.maxQueuedFrames != to.maxQueuedFrames ||
+       from.schedulingClass != to.schedulingClass || from.renderCores != to.renderCores || from.captureCores != to.captureCores || from.workerCores != to.workerCores ||
+       from.isolateUI != to.isolateUI || from.deadlineBudget != to.deadlineBudget || from.workerThreads != to.workerThreads ||
+       from.compactHistory != to.compactHistory || from.computeShaders != to.computeShaders || from.recordFile != to.recordFile || from.recordEvery != to.recordEvery || from.recordDepth != to.recordDepth ||
+       from.exclusive != to.exclusive || from.gpuThreadPriority != to.gpuThreadPriority)
+        flags |= ReconfigureFlag(RECONFIGURE_FULL);
+
+    if(from.captureMethod != to.captureMethod || from.captureDisplayNo != to.captureDisplayNo || from.captureWindow != to.captureWindow ||
+       from.readbackDepth != to.readbackDepth || from.dirtyRegions != to.dirtyRegions || from.frameHashing != to.frameHashing ||
+       from.windowSizedInputs != to.windowSizedInputs || from.inputX != to.inputX || from.inputY != to.inputY || from.inputWidth != to.inputWidth ||
+       from.inputHeight != to.inputHeight || from.captureFile != to.captureFile || from.fileWidth != to.fileWidth || from.fileHeight != to.fileHeight ||
+       from.fileFrameRate != to.fileFrameRate || from.fileLoop != to.fileLoop || from.testPattern != to.testPattern || from.testPatternRate != to.testPatternRate ||
+       from.testPatternSpeed != to.testPatternSpeed || from.testPatternJitter != to.testPatternJitter || from.testPatternDrops != to.testPatternDrops ||
+       from.wgcBuffers != to.wgcBuffers)
+        flags |= ReconfigureFlag(RECONFIGURE_CAPTURE);
+
+    // every profile is built when the renderer starts
+    if(from.shaderProfileNo != to.shaderProfileNo)
+        flags |= ReconfigureFlag(RECONFIGURE_PROFILE);
+
+    if(from.splitScreen != to.splitScreen)
+        flags |= ReconfigureFlag(RECONFIGURE_SCISSOR);
+
+    if(from.subFrames != to.subFrames)
+        flags |= ReconfigureFlag(RECONFIGURE_SCHEDULE);
+
+    if(!flags)
+        flags = ReconfigureFlag(RECONFIGURE_LIVE);
+
+    return flags;
+}
+
+int ReconfigurationPlanner::MostExpensive(unsigned flags)
+{
+    for(int kind = RECONFIGURE_KINDS - 1; kind > RECONFIGURE_LIVE; kind--)
+    {
+        if(Requires(flags, kind))
+            return kind;
+    }
+    return RECONFIGURE_LIVE;
+}
+
+bool ReconfigurationPlanner::Requires(unsigned flags, int kind)
+{
+    return (flags & ReconfigureFlag(kind)) != 0;
+}
+
+const char* ReconfigurationPlanner::KindName(int kind)
+{
+    switch(kind)
+    {
+    case RECONFIGURE_LIVE:
+        return "Live";
+    case RECONFIGURE_SCHEDULE:
+        return "Schedule";
+    case RECONFIGURE_SCISSOR:
+        return "Scissor";
+    case RECONFIGURE_PROFILE:
+        return "Profile";
+    case RECONFIGURE_CAPTURE:
+        return "Capture";
+    case RECONFIGURE_FULL:
+        return "Full";
+    }
+    return "";
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,39 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+
+namespace ShaderBeam
+{
+
+// reconfiguration kinds, cheapest first
+constexpr int RECONFIGURE_LIVE     = 0; // picked up from the options snapshot, nothing to rebuild
+constexpr int RECONFIGURE_SCHEDULE = 1; // subframe schedule and shader constants
+constexpr int RECONFIGURE_SCISSOR  = 2; // split-screen scissor
+constexpr int RECONFIGURE_PROFILE  = 3; // switch to another prewarmed shader profile at its next cycle
+constexpr int RECONFIGURE_CAPTURE  = 4; // capture restarted, renderer kept
+constexpr int RECONFIGURE_FULL     = 5; // device, swapchain, shaders, UI and capture re-created
+constexpr int RECONFIGURE_KINDS    = 6;
+
+constexpr unsigned ReconfigureFlag(int kind)
+{
+    return 1u << kind;
+}
+
+class ReconfigurationPlanner
+{
+public:
+    // returns flags of all reconfiguration kinds needed to go from one set of options to another
+    static unsigned Plan(const Options& from, const Options& to);
+    static int      MostExpensive(unsigned flags);
+    static bool     Requires(unsigned flags, int kind);
+
+    static const char* KindName(int kind);
+};
+} // namespace ShaderBeam
@@ -0,0 +1,142 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "Recorder.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+Recorder::Recorder(Watcher& watcher) : m_watcher(watcher) { }
+
+void Recorder::Start(const RenderContext& renderContext, const std::string& path, int depth, int every)
+{
+    D3D11_TEXTURE2D_DESC desc;
+    renderContext.outputTexture->GetDesc(&desc);
+    desc.MipLevels      = 1;
+    desc.ArraySize      = 1;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    desc.Usage          = D3D11_USAGE_STAGING;
+    desc.BindFlags      = 0;
+    desc.MiscFlags      = 0;
+
+    D3D11_QUERY_DESC queryDesc {};
+    queryDesc.Query = D3D11_QUERY_EVENT;
+
+    m_slots = std::vector<RecordSlot>(std::clamp(depth, 1, MAX_RECORD_DEPTH));
+    for(auto& slot : m_slots)
+    {
+        slot.texture = renderContext.resources->AcquireTexture(renderContext.device.get(), desc);
+        THROW(renderContext.device->CreateQuery(&queryDesc, slot.query.put()), "Unable to create recording query");
+    }
+
+    m_width         = desc.Width;
+    m_height        = desc.Height;
+    m_bytesPerPixel = desc.Format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 8 : 4;
+    m_every         = max(every, 1);
+    m_subFrames     = 0;
+    m_fill          = 0;
+    m_submit        = 0;
+    m_release       = 0;
+    m_path          = path;
+    m_writer.Open(path);
+}
+
+void Recorder::Stop(const RenderContext& renderContext)
+{
+    // writer finishes with whatever is mapped before we unmap it
+    m_writer.Close();
+    for(auto& slot : m_slots)
+    {
+        if(slot.state == SlotState::Writing)
+            renderContext.deviceContext->Unmap(slot.texture.get(), 0);
+        renderContext.resources->Release(slot.texture);
+    }
+    m_slots.clear();
+}
+
+bool Recorder::IsRecording() const
+{
+    return m_writer.IsOpen();
+}
+
+void Recorder::Record(const RenderContext& renderContext)
+{
+    Progress(renderContext);
+    if(!IsRecording())
+        return;
+
+    if(m_subFrames++ % m_every)
+        return;
+
+    auto& slot = m_slots[m_fill];
+    if(slot.state != SlotState::Free)
+    {
+        m_watcher.SubframeRecorded(false);
+        return;
+    }
+
+    renderContext.deviceContext->CopyResource(slot.texture.get(), renderContext.outputTexture.get());
+    renderContext.deviceContext->End(slot.query.get());
+    slot.state      = SlotState::Copying;
+    slot.frameNo    = renderContext.frameNo;
+    slot.subFrameNo = renderContext.subFrameNo;
+    slot.ticks      = Helpers::GetTicks();
+    m_fill          = (m_fill + 1) % m_slots.size();
+}
+
+void Recorder::Progress(const RenderContext& renderContext)
+{
+    // give back slots the writer has copied out, they only count as recorded while the file still takes them
+    while(m_slots[m_release].state == SlotState::Writing && m_slots[m_release].consumed)
+    {
+        renderContext.deviceContext->Unmap(m_slots[m_release].texture.get(), 0);
+        m_slots[m_release].state = SlotState::Free;
+        m_release                = (m_release + 1) % m_slots.size();
+        m_watcher.SubframeRecorded(!m_writer.HasFailed());
+    }
+
+    // e.g. disk full, no point reading back anything more
+    m_watcher.RecordingProgress(m_writer.GetBytesWritten());
+    if(m_writer.HasFailed())
+    {
+        m_watcher.RecordingFailed(m_path);
+        Stop(renderContext);
+        return;
+    }
+
+    // hand over finished copies in order, GPU completes them in order too
+    while(m_slots[m_submit].state == SlotState::Copying)
+    {
+        auto& slot = m_slots[m_submit];
+        if(renderContext.deviceContext->GetData(slot.query.get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            break;
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        auto                     hr = renderContext.deviceContext->Map(slot.texture.get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if(hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            break;
+        THROW(hr, "Unable to map recording texture");
+
+        slot.consumed = false;
+        slot.state    = SlotState::Writing;
+        m_writer.Submit({ .data          = (const uint8_t*)mapped.pData,
+                          .pitch         = mapped.RowPitch,
+                          .width         = m_width,
+                          .height        = m_height,
+                          .bytesPerPixel = m_bytesPerPixel,
+                          .frameNo       = slot.frameNo,
+                          .subFrameNo    = slot.subFrameNo,
+                          .ticks         = slot.ticks,
+                          .consumed      = &slot.consumed });
+        m_submit = (m_submit + 1) % m_slots.size();
+    }
+}
+
+} // namespace ShaderBeam
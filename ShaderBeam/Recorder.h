@@ -0,0 +1,68 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+#include "RenderContext.h"
+#include "FrameWriter.h"
+#include "Watcher.h"
+
+namespace ShaderBeam
+{
+
+#define MAX_RECORD_DEPTH 8
+
+// reads back shaded subframes through a ring of staging textures and hands them to a writer thread,
+// when either falls behind subframes are dropped rather than holding up rendering
+class Recorder
+{
+public:
+    explicit Recorder(Watcher& watcher);
+
+    void Start(const RenderContext& renderContext, const std::string& path, int depth, int every);
+    void Stop(const RenderContext& renderContext);
+    bool IsRecording() const;
+
+    // call once output is shaded, before overlays; never waits on GPU or disk
+    void Record(const RenderContext& renderContext);
+
+private:
+    enum class SlotState
+    {
+        Free,
+        Copying, // GPU copy in flight
+        Writing // mapped, writer thread reading
+    };
+
+    struct RecordSlot
+    {
+        winrt::com_ptr<ID3D11Texture2D> texture;
+        winrt::com_ptr<ID3D11Query>     query;
+        SlotState                       state { SlotState::Free };
+        std::atomic<bool>               consumed { false };
+        uint64_t                        frameNo { 0 };
+        unsigned                        subFrameNo { 0 };
+        float                           ticks { 0 };
+    };
+
+    Watcher&                m_watcher;
+    FrameWriter             m_writer;
+    std::string             m_path;
+    std::vector<RecordSlot> m_slots;
+    unsigned                m_fill { 0 }; // slots change state in ring order
+    unsigned                m_submit { 0 };
+    unsigned                m_release { 0 };
+    unsigned                m_width { 0 };
+    unsigned                m_height { 0 };
+    unsigned                m_bytesPerPixel { 4 };
+    unsigned                m_every { 1 };
+    uint64_t                m_subFrames { 0 };
+
+    void Progress(const RenderContext& renderContext);
+};
+} // namespace ShaderBeam
@@ -8,6 +8,9 @@ MIT License
 #pragma once
 
 #include "Common.h"
+#include "ResourcePool.h"
+#include "InputRing.h"
+#include "ShaderCache.h"
 
 namespace ShaderBeam
 {
@@ -22,10 +25,30 @@ struct RenderContext
     winrt::com_ptr<ID3D11DeviceContext>                   deviceContext;
     std::vector<winrt::com_ptr<ID3D11Texture2D>>          inputTextures;
     std::vector<winrt::com_ptr<ID3D11ShaderResourceView>> inputTextureViews;
-    std::vector<int>                                      inputSlots;
+    InputRing                                             inputs;
+    std::vector<ID3D11ShaderResourceView*>                historyViews; // compact older frames (newest first), replace inputs beyond the held ones
     winrt::com_ptr<ID3D11Texture2D>                       outputTexture;
     winrt::com_ptr<ID3D11RenderTargetView>                outputTargetView;
+    winrt::com_ptr<ID3D11UnorderedAccessView>             outputUnorderedView; // only with computeShaders, when the output format allows it
+    ResourcePool*                                         resources { nullptr }; // outlives the device, see ShaderBeam::Start
+    ShaderCache*                                          shaderCache { nullptr };
 
     const Options& options;
+
+    size_t NumInputs() const
+    {
+        return inputs.GetDepth();
+    }
+
+    ID3D11ShaderResourceView* GetInputView(size_t age) const
+    {
+        const auto numHeld = (size_t)inputs.GetNumHeld();
+        return age < numHeld ? inputTextureViews[inputs.GetSlot((int)age)].get() : historyViews[age - numHeld];
+    }
+
+    const winrt::com_ptr<ID3D11Texture2D>& GetNewestInput() const
+    {
+        return inputTextures[inputs.GetSlot(0)];
+    }
 };
 } // namespace ShaderBeam
@@ -7,53 +7,240 @@ MIT License
 
 #include "stdafx.h"
 
+#include <chrono>
+
 #include "RenderThread.h"
 #include "Helpers.h"
+#include "ReconfigurationPlanner.h"
 
 namespace ShaderBeam
 {
 
+// wait between retries after a transient error, doubles each time
+constexpr float BACKOFF_MIN_MS = 1.0f;
+constexpr float BACKOFF_MAX_MS = 500.0f;
+
 static DWORD WINAPI ThreadProc(LPVOID lpParameter)
 {
     ((RenderThread*)lpParameter)->Run();
     return 0;
 }
 
-RenderThread::RenderThread(const Options& options, const UI& ui, Renderer& renderer) : m_options(options), m_ui(ui), m_renderer(renderer), m_handle(NULL) { }
+RenderThread::RenderThread(Options& options, const OptionsStore& optionsStore, UI& ui, Renderer& renderer, ThreadScheduler& scheduler) :
+    m_handle(NULL), m_options(options), m_optionsStore(optionsStore), m_ui(ui), m_renderer(renderer), m_scheduler(scheduler)
+{ }
 
 void RenderThread::Start(const std::shared_ptr<CaptureBase>& capture)
 {
     m_capture    = capture;
     m_nextResync = 0;
-    m_stop       = false;
-    m_stopped    = false;
-    m_handle     = CreateThread(NULL, 0, ThreadProc, this, 0, NULL);
+    m_backoff    = 0;
+    m_faulted    = false;
+    {
+        std::lock_guard lock(m_mutex);
+        m_commands.clear();
+        m_commandsPending = false;
+        m_doneSeq         = m_lastSeq;
+        m_running         = true;
+    }
+    m_handle = CreateThread(NULL, 0, ThreadProc, this, 0, NULL);
     if(m_handle == NULL)
     {
+        m_running = false;
         throw std::runtime_error("Unable to create render thread.");
     }
-    SetThreadPriority(m_handle, THREAD_PRIORITY_TIME_CRITICAL);
 }
 
 void RenderThread::Stop()
 {
-    m_stop = true;
-    if(m_handle)
+    if(!m_handle)
+        return;
+
+    // thread exits at the next subframe boundary (at most one vsync)
+    Post({ .type = RenderCommandType::Stop }, false);
+    WaitForSingleObject(m_handle, INFINITE);
+    CloseHandle(m_handle);
+    m_handle = NULL;
+}
+
+void RenderThread::Benchmark()
+{
+    Post({ .type = RenderCommandType::Benchmark }, false);
+}
+
+void RenderThread::Skip(int frames)
+{
+    Post({ .type = RenderCommandType::Skip, .frames = frames }, false);
+}
+
+void RenderThread::Reconfigure(bool wait)
+{
+    Post({ .type = RenderCommandType::Reconfigure }, wait);
+}
+
+void RenderThread::ChangeCapture(const std::shared_ptr<CaptureBase>& capture)
+{
+    Post({ .type = RenderCommandType::CaptureChanged, .capture = capture }, true);
+}
+
+void RenderThread::Post(RenderCommand command, bool wait)
+{
+    std::unique_lock lock(m_mutex);
+    if(!m_running)
+        return;
+
+    command.seq = ++m_lastSeq;
+    auto seq    = command.seq;
+    m_commands.push_back(std::move(command));
+    m_commandsPending = true;
+    m_commandPosted.notify_one();
+
+    if(wait)
+        m_commandDone.wait(lock, [&] { return m_doneSeq >= seq || !m_running; });
+}
+
+// returns false when asked to stop
+bool RenderThread::ProcessCommands()
+{
+    while(true)
     {
-        while(!m_stopped)
+        RenderCommand command;
         {
-            Sleep(5);
+            std::lock_guard lock(m_mutex);
+            if(m_commands.empty())
+            {
+                m_commandsPending = false;
+                return true;
+            }
+            command = std::move(m_commands.front());
+            m_commands.pop_front();
         }
+
+        try
+        {
+            Execute(command);
+        }
+        catch(...)
+        {
+            // don't leave the sender waiting, rest of the queue is picked up on the next pass
+            Done(command.seq);
+            throw;
+        }
+        Done(command.seq);
+
+        if(command.type == RenderCommandType::Stop)
+            return false;
     }
 }
 
+void RenderThread::Execute(const RenderCommand& command)
+{
+    switch(command.type)
+    {
+    case RenderCommandType::Stop:
+        break;
+    case RenderCommandType::Benchmark:
+        if(!m_faulted)
+            m_renderer.Benchmark(m_capture);
+        break;
+    case RenderCommandType::Skip:
+        m_renderer.Skip(command.frames);
+        break;
+    case RenderCommandType::Reconfigure:
+        if(auto flags = AdoptOptions())
+        {
+            try
+            {
+                ApplyReconfiguration(flags);
+            }
+            catch(...)
+            {
+                // options are adopted already but resources don't match them, have the message thread re-create everything
+                m_faulted = true;
+                PostMessage(m_options.outputWindow, WM_USER_RESTART, 0, 0);
+            }
+        }
+        break;
+    case RenderCommandType::CaptureChanged:
+        m_capture    = command.capture;
+        m_nextResync = 0;
+        break;
+    }
+}
+
+void RenderThread::Done(uint64_t seq)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_doneSeq = seq;
+    }
+    m_commandDone.notify_all();
+}
+
+void RenderThread::WaitForCommands(float timeoutMs)
+{
+    std::unique_lock lock(m_mutex);
+    auto             posted = [this] { return !m_commands.empty(); };
+    if(timeoutMs < 0)
+        m_commandPosted.wait(lock, posted);
+    else
+        m_commandPosted.wait_for(lock, std::chrono::microseconds((long long)(timeoutMs * 1000.0f)), posted);
+}
+
+void RenderThread::HandleError(HRESULT hr)
+{
+    if(Helpers::IsDeviceLost(hr))
+    {
+        // nothing will work on this device any more, have the message thread re-create everything
+        m_faulted = true;
+        PostMessage(m_options.outputWindow, WM_USER_RESTART, 0, 0);
+        return;
+    }
+
+    // transient (capture source busy, mapping failed etc.), retry with exponential backoff
+    m_backoff = std::clamp(m_backoff * 2.0f, BACKOFF_MIN_MS, BACKOFF_MAX_MS);
+    WaitForCommands(m_backoff);
+}
+
+// returns reconfiguration flags if options changed, 0 otherwise
+unsigned RenderThread::AdoptOptions()
+{
+    if(m_optionsStore.GetVersion() == m_optionsVersion)
+        return 0;
+
+    const auto snapshot = m_optionsStore.Acquire();
+    const auto flags    = ReconfigurationPlanner::Plan(m_options, snapshot->options);
+    m_options           = snapshot->options;
+    m_optionsVersion    = snapshot->version;
+    m_optionsPublished  = snapshot->published;
+    return flags;
+}
+
+void RenderThread::ApplyReconfiguration(unsigned flags)
+{
+    m_renderer.Reconfigure(flags);
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_SCHEDULE))
+        m_nextResync = 0;
+
+    // time from publishing on the message thread till applied here
+    m_ui.SetReconfigured(ReconfigurationPlanner::MostExpensive(flags), Helpers::GetTicks() - m_optionsPublished);
+}
+
 void RenderThread::PollCapture()
 {
 #ifdef RGB_TEST
     m_renderer.RollInput(true);
 #else
-    bool newFrame = m_capture->Poll(m_renderer.GetNextInput());
-    m_renderer.RollInput(newFrame);
+    if(!m_capture)
+    {
+        // capture is being switched, keep showing the last frame
+        m_renderer.RollInput(false);
+        return;
+    }
+
+    auto pollStart = Helpers::GetTicks();
+    bool newFrame  = m_capture->Poll(m_renderer.GetNextInput());
+    m_renderer.RollInput(newFrame, m_capture.get(), Helpers::GetTicks() - pollStart);
     if(newFrame && m_options.autoSync && m_renderer.SupportsResync())
     {
         if(m_nextResync-- == 0)
@@ -72,32 +259,47 @@ void RenderThread::PollCapture()
 
 void RenderThread::Run()
 {
-    while(!m_stop && !m_stopped)
+    m_scheduler.Apply(ThreadRole::Render);
+
+    while(true)
     {
         try
         {
-            if(m_benchmark)
+            // subframe boundary, safe to act on commands
+            if(m_commandsPending && !ProcessCommands())
+                break;
+
+            if(m_faulted)
             {
-                m_benchmark = false;
-                m_renderer.Benchmark(m_capture);
+                // device lost, restart was requested; sleep till we're told to stop
+                WaitForCommands(-1);
+                continue;
             }
+
             if(m_renderer.NewInputRequired())
             {
                 PollCapture();
             }
             m_renderer.Render(true); // waits till vsync
+            m_backoff = 0;
+        }
+        catch(const HResultError& ex)
+        {
+            HandleError(ex.GetResult());
         }
         catch(...)
-        { }
+        {
+            HandleError(E_FAIL);
+        }
     }
     m_capture.reset();
-    m_stopped = true;
-    m_handle  = NULL;
-}
-
-void RenderThread::Benchmark()
-{
-    m_benchmark = true;
+    m_scheduler.Release();
+    {
+        std::lock_guard lock(m_mutex);
+        m_running = false;
+        m_commands.clear();
+    }
+    m_commandDone.notify_all();
 }
 
-} // namespace ShaderBeam
\ No newline at end of file
+} // namespace ShaderBeam
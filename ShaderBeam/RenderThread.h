@@ -7,18 +7,42 @@ MIT License
 
 #pragma once
 
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
 #include "Renderer.h"
 #include "CaptureBase.h"
+#include "ThreadScheduler.h"
+#include "OptionsStore.h"
 
 namespace ShaderBeam
 {
 
 class UI;
 
+enum class RenderCommandType
+{
+    Stop,
+    Benchmark,
+    Skip,
+    Reconfigure,
+    CaptureChanged
+};
+
+struct RenderCommand
+{
+    RenderCommandType            type { RenderCommandType::Stop };
+    uint64_t                     seq { 0 };
+    int                          frames { 0 };
+    std::shared_ptr<CaptureBase> capture;
+};
+
 class RenderThread
 {
 public:
-    RenderThread(const Options& options, const UI& ui, Renderer& renderer);
+    RenderThread(Options& options, const OptionsStore& optionsStore, UI& ui, Renderer& renderer, ThreadScheduler& scheduler);
 
     void Start(const std::shared_ptr<CaptureBase>& capture);
 
@@ -26,21 +50,50 @@ public:
 
     void Benchmark();
 
+    void Skip(int frames);
+
+    // adopt latest published options, optionally waiting till the render thread has done so
+    void Reconfigure(bool wait);
+
+    // swap capture source, returns once the render thread no longer uses the previous one
+    void ChangeCapture(const std::shared_ptr<CaptureBase>& capture);
+
     void Stop();
 
+    unsigned AdoptOptions();
+
 private:
     HANDLE                       m_handle;
-    const Options&               m_options;
-    const UI&                    m_ui;
+    Options&                     m_options; // render-side copy, only written by AdoptOptions
+    const OptionsStore&          m_optionsStore;
+    uint64_t                     m_optionsVersion { 0 };
+    float                        m_optionsPublished { 0 };
+    UI&                          m_ui;
     Renderer&                    m_renderer;
+    ThreadScheduler&             m_scheduler;
     std::shared_ptr<CaptureBase> m_capture;
 
     void PollCapture();
+    void ApplyReconfiguration(unsigned flags);
+    void Post(RenderCommand command, bool wait);
+    bool ProcessCommands();
+    void Execute(const RenderCommand& command);
+    void Done(uint64_t seq);
+    void WaitForCommands(float timeoutMs);
+    void HandleError(HRESULT hr);
 
-    int m_nextResync { 0 };
+    int   m_nextResync { 0 };
+    float m_backoff { 0 };
+    bool  m_faulted { false };
 
-    volatile bool m_stop { false };
-    volatile bool m_stopped { false };
-    volatile bool m_benchmark { false };
+    // control plane, commands are executed at subframe boundaries
+    std::mutex                m_mutex;
+    std::condition_variable   m_commandPosted;
+    std::condition_variable   m_commandDone;
+    std::deque<RenderCommand> m_commands;
+    std::atomic<bool>         m_commandsPending { false };
+    std::atomic<bool>         m_running { false };
+    uint64_t                  m_lastSeq { 0 };
+    uint64_t                  m_doneSeq { 0 };
 };
 } // namespace ShaderBeam
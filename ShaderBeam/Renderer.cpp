@@ -9,13 +9,19 @@ MIT License
 #include "Renderer.h"
 #include "Helpers.h"
 #include "CaptureBase.h"
+#include "ReconfigurationPlanner.h"
+#include "HistoryFormats.h"
 
 namespace ShaderBeam
 {
 
-Renderer::Renderer(const Options& options, UI& ui, Watcher& watcher, ShaderManager& shaderManager) :
-    m_options(options), m_ui(ui), m_watcher(watcher), m_shaderManager(shaderManager), m_charts(m_options, m_watcher), m_renderContext(m_options)
-{ }
+Renderer::Renderer(const Options& options, UI& ui, Watcher& watcher, ShaderManager& shaderManager, ResourcePool& resourcePool, ShaderCache& shaderCache) :
+    m_options(options), m_ui(ui), m_watcher(watcher), m_shaderManager(shaderManager), m_charts(m_options, m_watcher), m_renderContext(m_options),
+    m_recorder(m_watcher), m_overlay(ui)
+{
+    m_renderContext.resources   = &resourcePool;
+    m_renderContext.shaderCache = &shaderCache;
+}
 
 void Renderer::Start(winrt::com_ptr<ID3D11Device> device, winrt::com_ptr<ID3D11DeviceContext> context)
 {
@@ -23,13 +29,18 @@ void Renderer::Start(winrt::com_ptr<ID3D11Device> device, winrt::com_ptr<ID3D11D
     m_renderContext.deviceContext = context;
 
     Create();
-    m_charts.Create(m_renderContext.device, m_renderContext.deviceContext);
+    m_charts.Create(m_renderContext);
     m_shaderManager.Create(m_renderContext, m_options.shaderProfileNo);
+    m_pendingProfile = -1;
     CreateInputs();
+
+    if(!m_options.recordFile.empty())
+        m_recorder.Start(m_renderContext, m_options.recordFile, m_options.recordDepth, m_options.recordEvery);
 }
 
 void Renderer::Stop()
 {
+    m_recorder.Stop(m_renderContext);
     m_shaderManager.Destroy();
     m_charts.Destroy();
     Destroy();
@@ -43,31 +54,61 @@ void Renderer::Render(bool present, bool ui)
     ID3D11RenderTargetView* targets[1] = { m_renderContext.outputTargetView.get() };
     m_renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
 
+    if(!InputsCoverOutput())
+    {
+        // shader is scissored to the captured window, everything around it is just black
+        static const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        m_renderContext.deviceContext->ClearRenderTargetView(m_renderContext.outputTargetView.get(), black);
+    }
+
+    ID3D11Buffer* inputArea[1] = { m_inputAreaBuffer.get() };
+    m_renderContext.deviceContext->VSSetConstantBuffers(1, 1, inputArea);
+    m_renderContext.deviceContext->PSSetConstantBuffers(1, 1, inputArea);
+
+    // only where the active profile would take a new input anyway, so neither gets cut mid-cycle
+    if(m_pendingProfile >= 0 && m_shaderManager.NewInputRequired(m_renderContext))
+    {
+        m_shaderManager.Switch(m_renderContext, m_pendingProfile);
+        m_pendingProfile           = -1;
+        m_renderContext.frameNo    = 0;
+        m_renderContext.subFrameNo = 0;
+    }
+
     m_shaderManager.Render(m_renderContext);
 
     if(m_options.splitScreen)
     {
-        D3D11_BOX box {};
-        UINT      destX = m_options.splitScreen == 1 ? m_options.outputWidth / 2 : 0;
-        UINT      destY = m_options.splitScreen == 2 ? m_options.outputHeight / 2 : 0;
-        box.left        = destX;
-        box.top         = destY;
-        box.right       = m_options.outputWidth;
-        box.bottom      = m_options.outputHeight;
-        box.front       = 0;
-        box.back        = 1;
-        m_renderContext.deviceContext->CopySubresourceRegion(
-            m_renderContext.outputTexture.get(), 0, destX, destY, 0, m_renderContext.inputTextures[m_renderContext.inputSlots[0]].get(), 0, &box);
+        // other half shows the input as is, wherever inputs reach
+        int left   = max(m_options.splitScreen == 1 ? (int)m_options.outputWidth / 2 : 0, m_options.inputX);
+        int top    = max(m_options.splitScreen == 2 ? (int)m_options.outputHeight / 2 : 0, m_options.inputY);
+        int right  = m_options.inputX + (int)m_options.inputWidth;
+        int bottom = m_options.inputY + (int)m_options.inputHeight;
+        if(right > left && bottom > top)
+        {
+            D3D11_BOX box {};
+            box.left   = left - m_options.inputX;
+            box.top    = top - m_options.inputY;
+            box.right  = right - m_options.inputX;
+            box.bottom = bottom - m_options.inputY;
+            box.front  = 0;
+            box.back   = 1;
+            m_renderContext.deviceContext->CopySubresourceRegion(
+                m_renderContext.outputTexture.get(), 0, left, top, 0, m_renderContext.GetNewestInput().get(), 0, &box);
+        }
     }
 
+    // what the shader produced, without overlays
+    if(m_recorder.IsRecording())
+        m_recorder.Record(m_renderContext);
+
     if(ui && m_options.charts)
-        m_charts.Render(m_renderContext.outputTexture, m_options.outputHeight);
+        m_charts.Render(m_renderContext, m_uiTargetView.get(), m_options.outputHeight);
 
     if(ui && m_ui.RenderRequired())
     {
-        targets[0] = m_uiTargetView.get();
-        m_renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
-        m_ui.Render();
+        m_overlay.Render(m_renderContext, m_uiTargetView.get());
+        m_renderContext.deviceContext->OMSetBlendState(NULL, NULL, 1);
+        SetScissor();
     }
 
     ID3D11RenderTargetView* null[] = { nullptr };
@@ -90,29 +131,16 @@ void Renderer::Render(bool present, bool ui)
 void Renderer::Present(bool vsync)
 {
     DXGI_PRESENT_PARAMETERS pp {};
-    m_swapChain->Present1(vsync ? 1 : 0, 0, &pp);
-}
+    THROW(m_swapChain->Present1(vsync ? 1 : 0, 0, &pp), "Unable to present");
 
-int Renderer::GetNextSlot() const
-{
-    // return either a free slot, or the oldest one to receive new input
-    bool inputUsed[MAX_INPUTS];
-    ZeroMemory(inputUsed, sizeof(inputUsed));
-    for(auto slot : m_renderContext.inputSlots)
-    {
-        inputUsed[slot] = true;
-    }
-    for(auto t = 0; t < m_renderContext.inputTextures.size(); t++)
-    {
-        if(!inputUsed[t])
-            return t;
-    }
-    return m_renderContext.inputSlots.back();
+    DXGI_FRAME_STATISTICS stats;
+    if(m_options.charts && SUCCEEDED(m_swapChain->GetFrameStatistics(&stats)))
+        m_watcher.FramePresented(stats.PresentCount, stats.SyncQPCTime.QuadPart);
 }
 
 const winrt::com_ptr<ID3D11Texture2D>& Renderer::GetNextInput() const
 {
-    return m_renderContext.inputTextures[GetNextSlot()];
+    return m_renderContext.inputTextures[m_renderContext.inputs.GetNextSlot()];
 }
 
 bool Renderer::NewInputRequired() const
@@ -125,19 +153,26 @@ bool Renderer::SupportsResync() const
     return m_shaderManager.SupportsResync(m_renderContext);
 }
 
-void Renderer::RollInput(bool newFrame)
+void Renderer::RollInput(bool newFrame, const CaptureBase* capture, float pollMs)
 {
-    auto numInputs = m_renderContext.inputSlots.size();
-    if(numInputs == 1)
-        return;
+    if(capture)
+        m_watcher.CapturePolled(pollMs);
 
-    // if we didn't get a new frame, duplicate slot of the latest frame we have
-    auto latestInput = newFrame ? GetNextSlot() : m_renderContext.inputSlots.front();
+    // frame leaving the newest position goes into compact history (again if it's repeated), only newest stays full precision
+    if(m_history.IsEnabled() && m_shaderManager.UsesHistory(m_renderContext))
+    {
+        m_history.Push(m_renderContext, m_renderContext.GetInputView(0));
+        m_renderContext.historyViews = m_history.GetViews();
+        SetScissor();
+    }
 
-    // roll input slots and add latest to front
-    for(auto i = numInputs - 1; i > 0; i--)
-        m_renderContext.inputSlots[i] = m_renderContext.inputSlots[i - 1];
-    m_renderContext.inputSlots[0] = latestInput;
+    // if we didn't get a new frame the latest one we have is repeated
+    if(!newFrame)
+        m_renderContext.inputs.Repeat();
+    else if(capture)
+        m_renderContext.inputs.Push(Helpers::GetTicks(), capture->GetFrameContent(), &capture->GetChangedTiles());
+    else
+        m_renderContext.inputs.Push(Helpers::GetTicks(), FrameContent::New, nullptr);
 }
 
 void Renderer::Skip(int numFrames)
@@ -146,6 +181,35 @@ void Renderer::Skip(int numFrames)
     m_renderContext.subFrameNo %= m_options.subFrames;
 }
 
+void Renderer::Reconfigure(unsigned flags)
+{
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_SCHEDULE))
+    {
+        m_shaderManager.Reconfigure(m_renderContext);
+        m_renderContext.frameNo    = 0;
+        m_renderContext.subFrameNo = 0;
+    }
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_PROFILE))
+    {
+        m_pendingProfile = m_options.shaderProfileNo != m_shaderManager.GetActiveProfile() ? m_options.shaderProfileNo : -1;
+    }
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_CAPTURE))
+    {
+        // captured window may cover a different area now
+        if(m_inputWidth != m_options.inputWidth || m_inputHeight != m_options.inputHeight)
+        {
+            DestroyInputs();
+            CreateInputs();
+        }
+        SetInputArea();
+        SetScissor();
+    }
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_SCISSOR))
+    {
+        SetScissor();
+    }
+}
+
 void Renderer::Benchmark(const std::shared_ptr<CaptureBase>& capture)
 {
     const float benchmarkDuration = 4 * TICKS_PER_SEC;
@@ -153,6 +217,7 @@ void Renderer::Benchmark(const std::shared_ptr<CaptureBase>& capture)
     auto  input       = GetNextInput();
     auto  start       = Helpers::GetTicks();
     float copyTime    = 0.0f;
+    int   copies      = 0;
     float renderTime  = 0.0f;
     float presentTime = 0.0f;
     float now         = start;
@@ -162,11 +227,12 @@ void Renderer::Benchmark(const std::shared_ptr<CaptureBase>& capture)
     {
         auto pctComplete           = (now - start) / benchmarkDuration;
         m_renderContext.subFrameNo = ((int)(m_options.subFrames * pctComplete)) % m_options.subFrames;
-        if(m_options.crossAdapter && (frames % m_options.subFrames == 0))
+        if(capture && m_options.crossAdapter && (frames % m_options.subFrames == 0))
         {
             capture->BenchmarkCopy(input);
             m_renderContext.deviceContext->Flush();
             WaitTillIdle();
+            copies++;
             auto now = Helpers::GetTicks();
             copyTime += now - prev;
             prev = now;
@@ -187,11 +253,34 @@ void Renderer::Benchmark(const std::shared_ptr<CaptureBase>& capture)
         prev = now;
     } while(now < start + benchmarkDuration);
     auto totalTime = now - start;
+    auto copyBytes = (float)m_options.inputWidth * m_options.inputHeight * (m_options.useHdr ? 8 : 4) * copies;
+
+    // how much of the copy time the CPU side alone accounts for
+    float cpuCopyGBps = 0.0f;
+    if(capture && m_options.crossAdapter)
+        cpuCopyGBps = (float)capture->BenchmarkCPUCopy();
+
+    // CPU reference of what compact history would cost in precision, on a synthetic HDR frame
+    float historyPsnr = 0.0f;
+    float chromaPsnr  = 0.0f;
+    if(m_options.useHdr)
+    {
+        const unsigned referenceSize = 256;
+        const float    referencePeak = 12.5f; // 1000 nits in scRGB
+        auto           reference     = CreateReferenceFrame(referenceSize, referenceSize, referencePeak);
+        historyPsnr                  = (float)MeasureR11G11B10(reference, referencePeak).psnr;
+        chromaPsnr                   = (float)MeasureHalfChroma(reference, referenceSize, referenceSize, referencePeak).psnr;
+    }
+
     m_ui.SetBenchmark({
-        .totalFPS   = totalTime != 0 ? frames / (totalTime / TICKS_PER_SEC) : 0,
-        .copyFPS    = copyTime != 0 ? frames / (copyTime / TICKS_PER_SEC) : 0,
-        .renderFPS  = renderTime != 0 ? frames / (renderTime / TICKS_PER_SEC) : 0,
-        .presentFPS = presentTime != 0 ? frames / (presentTime / TICKS_PER_SEC) : 0,
+        .totalFPS    = totalTime != 0 ? frames / (totalTime / TICKS_PER_SEC) : 0,
+        .copyFPS     = copyTime != 0 ? frames / (copyTime / TICKS_PER_SEC) : 0,
+        .copyGBps    = copyTime != 0 ? copyBytes / (copyTime / TICKS_PER_SEC) / 1e9f : 0,
+        .cpuCopyGBps = cpuCopyGBps,
+        .renderFPS   = renderTime != 0 ? frames / (renderTime / TICKS_PER_SEC) : 0,
+        .presentFPS  = presentTime != 0 ? frames / (presentTime / TICKS_PER_SEC) : 0,
+        .historyPsnr = historyPsnr,
+        .chromaPsnr  = chromaPsnr,
     });
 }
 
@@ -211,13 +300,22 @@ void Renderer::Create()
     winrt::com_ptr<IDXGIFactory2> dxgiFactory;
     THROW(dxgiAdapter->GetParent(__uuidof(IDXGIFactory2), (void**)dxgiFactory.put()), "Unable to get DXGI factory");
 
+    // compute shaders write the output through a UAV, which can't be sRGB and needs typed stores in the output format
+    bool outputUnordered = false;
+    if(m_options.computeShaders && !m_options.hardwareSrgb)
+    {
+        D3D11_FEATURE_DATA_FORMAT_SUPPORT2 formatSupport { m_options.format };
+        outputUnordered = SUCCEEDED(m_renderContext.device->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &formatSupport, sizeof(formatSupport))) &&
+                          (formatSupport.OutFormatSupport2 & D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE);
+    }
+
     DXGI_SWAP_CHAIN_DESC1 d3d11SwapChainDesc = {};
     d3d11SwapChainDesc.Width                 = 0;
     d3d11SwapChainDesc.Height                = 0;
     d3d11SwapChainDesc.Format                = m_options.format;
     d3d11SwapChainDesc.SampleDesc.Count      = 1;
     d3d11SwapChainDesc.SampleDesc.Quality    = 0;
-    d3d11SwapChainDesc.BufferUsage           = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    d3d11SwapChainDesc.BufferUsage           = DXGI_USAGE_RENDER_TARGET_OUTPUT | (outputUnordered ? DXGI_USAGE_UNORDERED_ACCESS : 0);
     d3d11SwapChainDesc.BufferCount           = m_options.swapChainBuffers;
     d3d11SwapChainDesc.Scaling               = DXGI_SCALING_NONE;
     d3d11SwapChainDesc.SwapEffect            = DXGI_SWAP_EFFECT_FLIP_DISCARD;
@@ -258,11 +356,19 @@ void Renderer::Create()
     rtv.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
     THROW(m_renderContext.device->CreateRenderTargetView(m_renderContext.outputTexture.get(), &rtv, m_renderContext.outputTargetView.put()), "Unable to create render target");
 
+    if(outputUnordered)
+        THROW(m_renderContext.device->CreateUnorderedAccessView(m_renderContext.outputTexture.get(), nullptr, m_renderContext.outputUnorderedView.put()),
+              "Unable to create output UAV");
+
     D3D11_RENDER_TARGET_VIEW_DESC uitv {};
     uitv.Format        = m_options.format;
     uitv.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
     THROW(m_renderContext.device->CreateRenderTargetView(m_renderContext.outputTexture.get(), &uitv, m_uiTargetView.put()), "Unable to create render target");
 
+    D3D11_TEXTURE2D_DESC outputDesc;
+    m_renderContext.outputTexture->GetDesc(&outputDesc);
+    m_overlay.Create(m_renderContext, uitv.Format, outputDesc.Width, outputDesc.Height);
+
     D3D11_RASTERIZER_DESC rsDesc {};
     rsDesc.CullMode          = D3D11_CULL_NONE;
     rsDesc.FillMode          = D3D11_FILL_SOLID;
@@ -276,84 +382,119 @@ void Renderer::Create()
     dsDesc.StencilEnable = false;
     THROW(m_renderContext.device->CreateDepthStencilState(&dsDesc, m_depthStencilState.put()), "Unable to create depth/stencil state");
 
-    D3D11_RECT scissor {};
-    scissor.left   = 0;
-    scissor.top    = 0;
-    scissor.right  = m_options.splitScreen == 1 ? m_options.outputWidth / 2 : m_options.outputWidth;
-    scissor.bottom = m_options.splitScreen == 2 ? m_options.outputHeight / 2 : m_options.outputHeight;
+    D3D11_BUFFER_DESC inputAreaDesc {};
+    inputAreaDesc.ByteWidth = sizeof(float) * 4;
+    inputAreaDesc.Usage     = D3D11_USAGE_DEFAULT;
+    inputAreaDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+
+    m_inputAreaBuffer = m_renderContext.resources->AcquireBuffer(m_renderContext.device.get(), inputAreaDesc);
 
     m_renderContext.deviceContext->RSSetState(m_rasterizerState.get());
     m_renderContext.deviceContext->OMSetDepthStencilState(m_depthStencilState.get(), 0);
     m_renderContext.deviceContext->OMSetBlendState(NULL, NULL, 1);
-    m_renderContext.deviceContext->RSSetScissorRects(1, &scissor);
+    SetScissor();
 
     m_renderContext.frameNo    = 0;
     m_renderContext.subFrameNo = 0;
 }
 
+void Renderer::SetScissor()
+{
+    // no point running the shader where there is no input
+    D3D11_RECT scissor {};
+    scissor.left   = m_options.inputX;
+    scissor.top    = m_options.inputY;
+    scissor.right  = min(m_options.splitScreen == 1 ? (int)m_options.outputWidth / 2 : (int)m_options.outputWidth, m_options.inputX + (int)m_options.inputWidth);
+    scissor.bottom = min(m_options.splitScreen == 2 ? (int)m_options.outputHeight / 2 : (int)m_options.outputHeight, m_options.inputY + (int)m_options.inputHeight);
+
+    m_renderContext.deviceContext->RSSetScissorRects(1, &scissor);
+}
+
+bool Renderer::InputsCoverOutput() const
+{
+    return m_options.inputWidth == m_options.outputWidth && m_options.inputHeight == m_options.outputHeight;
+}
+
+void Renderer::SetInputArea()
+{
+    // shaders get uv over the whole output (so CRT scan follows the display), this maps it onto input textures
+    float inputArea[4] = {
+        m_options.inputX / (float)m_options.outputWidth,
+        m_options.inputY / (float)m_options.outputHeight,
+        m_options.outputWidth / (float)m_options.inputWidth,
+        m_options.outputHeight / (float)m_options.inputHeight,
+    };
+    m_renderContext.deviceContext->UpdateSubresource(m_inputAreaBuffer.get(), 0, nullptr, inputArea, 0, 0);
+}
+
 void Renderer::CreateInputs()
 {
     auto inputsRequired = m_shaderManager.NumInputsRequired();
-    if(inputsRequired > MAX_INPUTS)
+    if(inputsRequired < 1 || inputsRequired > MAX_INPUTS)
         THROW(E_FAIL, "Too many inputs");
 
+    // HDR inputs are 8 bytes per pixel, older frames can live in 4
+    int inputSlots = inputsRequired;
+    if(m_options.compactHistory && m_options.useHdr && inputsRequired > 1)
+    {
+        m_history.Create(m_renderContext, inputsRequired - 1, m_options.inputWidth, m_options.inputHeight);
+        m_renderContext.historyViews = m_history.GetViews();
+        inputSlots                   = 1;
+    }
+
+    // with window capture inputs may only cover the window
+    m_inputWidth  = m_options.inputWidth;
+    m_inputHeight = m_options.inputHeight;
+    SetInputArea();
+
     D3D11_TEXTURE2D_DESC desc {};
-    desc.Width              = m_options.outputWidth;
-    desc.Height             = m_options.outputHeight;
+    desc.Width              = m_inputWidth;
+    desc.Height             = m_inputHeight;
     desc.ArraySize          = 1;
     desc.Format             = m_options.hardwareSrgb ? DXGI_FORMAT_B8G8R8A8_UNORM_SRGB : m_options.format;
     desc.SampleDesc.Count   = 1;
     desc.SampleDesc.Quality = 0;
     desc.MipLevels          = 1;
     desc.MiscFlags          = 0;
-    desc.CPUAccessFlags     = m_options.crossAdapter ? D3D11_CPU_ACCESS_WRITE : 0;
-    desc.Usage              = m_options.crossAdapter ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
-    desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
-
-    D3D11_SUBRESOURCE_DATA data {};
-    auto                   formatWidth = m_options.useHdr ? 2 : 1;
-    std::vector<uint32_t>  initialData;
-    initialData.resize(m_options.outputWidth * m_options.outputHeight * formatWidth);
-    data.pSysMem          = initialData.data();
-    data.SysMemPitch      = m_options.outputWidth * sizeof(uint32_t) * formatWidth;
-    data.SysMemSlicePitch = m_options.outputWidth * m_options.outputHeight * sizeof(uint32_t) * formatWidth;
-    for(int i = 0; i < inputsRequired; i++)
+    desc.CPUAccessFlags     = 0;
+    desc.Usage              = D3D11_USAGE_DEFAULT;
+    desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET; // render target only so it can be cleared on the GPU
+
+    // with compact history one extra full input is enough for capture to write into
+    const int inputTextures = inputSlots == inputsRequired ? inputsRequired : inputSlots + 1;
+    for(int i = 0; i < inputTextures; i++)
     {
+        float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 #ifdef RGB_TEST
-        uint32_t color;
-        switch(i)
-        {
-        case 2:
-            color = 0xff0000ff;
-            break;
-        case 1:
-            color = 0xff00ff00;
-            break;
-        case 0:
-            color = 0xffff0000;
-            break;
-        }
-        for(auto& d : initialData)
-            d = color;
+        color[3] = 1.0f;
+        if(i < 3)
+            color[i] = 1.0f;
 #endif
-        m_renderContext.inputSlots.push_back(i);
-        auto& inputTexture     = m_renderContext.inputTextures.emplace_back(nullptr);
+        auto& inputTexture     = m_renderContext.inputTextures.emplace_back(m_renderContext.resources->AcquireTexture(m_renderContext.device.get(), desc));
         auto& inputTextureView = m_renderContext.inputTextureViews.emplace_back(nullptr);
-        THROW(m_renderContext.device->CreateTexture2D(&desc, &data, inputTexture.put()), "Unable to create texture");
         THROW(m_renderContext.device->CreateShaderResourceView(inputTexture.get(), nullptr, inputTextureView.put()), "Unable to create input view");
+
+        // pooled textures still hold whatever the last session left in them
+        winrt::com_ptr<ID3D11RenderTargetView> clearView;
+        THROW(m_renderContext.device->CreateRenderTargetView(inputTexture.get(), nullptr, clearView.put()), "Unable to create input target");
+        m_renderContext.deviceContext->ClearRenderTargetView(clearView.get(), color);
     }
+    m_renderContext.inputs.Reset(inputsRequired, inputSlots, inputTextures);
 }
 
 void Renderer::Destroy()
 {
-    m_depthStencilState              = nullptr;
-    m_rasterizerState                = nullptr;
-    m_swapChain                      = nullptr;
-    m_uiTargetView                   = nullptr;
-    m_renderContext.frameNo          = 0;
-    m_renderContext.subFrameNo       = 0;
-    m_renderContext.outputTargetView = nullptr;
-    m_renderContext.outputTexture    = nullptr;
+    m_depthStencilState                 = nullptr;
+    m_rasterizerState                   = nullptr;
+    m_swapChain                         = nullptr;
+    m_uiTargetView                      = nullptr;
+    m_renderContext.frameNo             = 0;
+    m_renderContext.subFrameNo          = 0;
+    m_renderContext.outputTargetView    = nullptr;
+    m_renderContext.outputUnorderedView = nullptr;
+    m_renderContext.outputTexture       = nullptr;
+    m_renderContext.resources->Release(m_inputAreaBuffer);
+    m_overlay.Destroy();
     DestroyInputs();
     if(m_renderContext.deviceContext)
     {
@@ -375,9 +516,11 @@ void Renderer::DestroyInputs()
         m_renderContext.inputTextureViews[i] = nullptr;
     m_renderContext.inputTextureViews.clear();
     for(int i = 0; i < m_renderContext.inputTextures.size(); i++)
-        m_renderContext.inputTextures[i] = nullptr;
+        m_renderContext.resources->Release(m_renderContext.inputTextures[i]);
     m_renderContext.inputTextures.clear();
-    m_renderContext.inputSlots.clear();
+    m_renderContext.inputs.Reset(0, 0, 0);
+    m_renderContext.historyViews.clear();
+    m_history.Destroy();
 }
 
 void Renderer::WaitTillIdle()
@@ -12,6 +12,9 @@ MIT License
 #include "Charts.h"
 #include "RenderContext.h"
 #include "ShaderManager.h"
+#include "HistoryRing.h"
+#include "Recorder.h"
+#include "UIOverlay.h"
 
 namespace ShaderBeam
 {
@@ -21,7 +24,7 @@ class CaptureBase;
 class Renderer
 {
 public:
-    Renderer(const Options& options, UI& ui, Watcher& watcher, ShaderManager& shaderManager);
+    Renderer(const Options& options, UI& ui, Watcher& watcher, ShaderManager& shaderManager, ResourcePool& resourcePool, ShaderCache& shaderCache);
 
     void Start(winrt::com_ptr<ID3D11Device> device, winrt::com_ptr<ID3D11DeviceContext> context);
     void Stop();
@@ -31,8 +34,9 @@ public:
     const winrt::com_ptr<ID3D11Texture2D>& GetNextInput() const;
     bool                                   NewInputRequired() const;
     bool                                   SupportsResync() const;
-    void                                   RollInput(bool newFrame);
+    void                                   RollInput(bool newFrame, const CaptureBase* capture = nullptr, float pollMs = 0);
     void                                   Skip(int numFrames);
+    void                                   Reconfigure(unsigned flags);
 
     void Benchmark(const std::shared_ptr<CaptureBase>& capture);
 
@@ -43,18 +47,27 @@ private:
     Charts         m_charts;
     RenderContext  m_renderContext;
     ShaderManager& m_shaderManager;
+    HistoryRing    m_history;
+    Recorder       m_recorder;
+    UIOverlay      m_overlay;
 
     void Create();
+    void SetScissor();
+    void SetInputArea();
+    bool InputsCoverOutput() const;
     void CreateInputs();
     void Destroy();
     void DestroyInputs();
     void WaitTillIdle();
-    int  GetNextSlot() const;
 
     winrt::com_ptr<IDXGISwapChain1>         m_swapChain { nullptr };
     winrt::com_ptr<ID3D11RasterizerState>   m_rasterizerState { nullptr };
     winrt::com_ptr<ID3D11DepthStencilState> m_depthStencilState { nullptr };
     winrt::com_ptr<ID3D11RenderTargetView>  m_uiTargetView { nullptr };
+    winrt::com_ptr<ID3D11Buffer>            m_inputAreaBuffer { nullptr };
+    unsigned                                m_inputWidth { 0 };
+    unsigned                                m_inputHeight { 0 };
+    int                                     m_pendingProfile { -1 }; // switched to at the start of the active one's next cycle
 #if _DEBUG
     winrt::com_ptr<ID3D11Debug> m_debug { nullptr };
 #endif
@@ -0,0 +1,177 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "ResourcePool.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+winrt::com_ptr<ID3D11Texture2D> ResourcePool::AcquireTexture(ID3D11Device* device, const D3D11_TEXTURE2D_DESC& desc)
+{
+    winrt::com_ptr<ID3D11Texture2D> texture;
+    auto                            idle = TakeIdle(device, &desc, nullptr);
+    if(idle)
+    {
+        texture = idle.as<ID3D11Texture2D>();
+    }
+    else
+    {
+        THROW(device->CreateTexture2D(&desc, nullptr, texture.put()), "Unable to create texture");
+        std::lock_guard lock(m_mutex);
+        m_stats.allocations++;
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_stats.liveCount++;
+    m_stats.liveBytes += GetBytes(desc);
+    return texture;
+}
+
+winrt::com_ptr<ID3D11Buffer> ResourcePool::AcquireBuffer(ID3D11Device* device, const D3D11_BUFFER_DESC& desc)
+{
+    winrt::com_ptr<ID3D11Buffer> buffer;
+    auto                         idle = TakeIdle(device, nullptr, &desc);
+    if(idle)
+    {
+        buffer = idle.as<ID3D11Buffer>();
+    }
+    else
+    {
+        THROW(device->CreateBuffer(&desc, nullptr, buffer.put()), "Unable to create buffer");
+        std::lock_guard lock(m_mutex);
+        m_stats.allocations++;
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_stats.liveCount++;
+    m_stats.liveBytes += desc.ByteWidth;
+    return buffer;
+}
+
+void ResourcePool::Release(winrt::com_ptr<ID3D11Texture2D>& texture)
+{
+    if(!texture)
+        return;
+
+    IdleResource idle {};
+    texture->GetDevice(&idle.device);
+    idle.device->Release(); // texture holds the reference
+    texture->GetDesc(&idle.textureDesc);
+    idle.resource = texture.as<ID3D11Resource>();
+    idle.bytes    = GetBytes(idle.textureDesc);
+    texture       = nullptr;
+    PutIdle(std::move(idle));
+}
+
+void ResourcePool::Release(winrt::com_ptr<ID3D11Buffer>& buffer)
+{
+    if(!buffer)
+        return;
+
+    IdleResource idle {};
+    buffer->GetDevice(&idle.device);
+    idle.device->Release(); // buffer holds the reference
+    buffer->GetDesc(&idle.bufferDesc);
+    idle.resource = buffer.as<ID3D11Resource>();
+    idle.bytes    = idle.bufferDesc.ByteWidth;
+    buffer        = nullptr;
+    PutIdle(std::move(idle));
+}
+
+void ResourcePool::Clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_idle.clear();
+    m_stats.idleCount = 0;
+    m_stats.idleBytes = 0;
+}
+
+ResourcePoolStats ResourcePool::GetStats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
+winrt::com_ptr<ID3D11Resource> ResourcePool::TakeIdle(ID3D11Device* device, const D3D11_TEXTURE2D_DESC* textureDesc, const D3D11_BUFFER_DESC* bufferDesc)
+{
+    std::lock_guard lock(m_mutex);
+    for(auto it = m_idle.begin(); it != m_idle.end(); it++)
+    {
+        // descs are plain structs of UINTs, no padding to trip memcmp
+        if(it->device != device)
+            continue;
+        if(textureDesc && memcmp(&it->textureDesc, textureDesc, sizeof(D3D11_TEXTURE2D_DESC)) != 0)
+            continue;
+        if(bufferDesc && memcmp(&it->bufferDesc, bufferDesc, sizeof(D3D11_BUFFER_DESC)) != 0)
+            continue;
+
+        auto resource = std::move(it->resource);
+        m_stats.idleCount--;
+        m_stats.idleBytes -= it->bytes;
+        m_stats.reuses++;
+        m_idle.erase(it);
+        return resource;
+    }
+    return nullptr;
+}
+
+void ResourcePool::PutIdle(IdleResource&& idle)
+{
+    std::lock_guard lock(m_mutex);
+    m_stats.liveCount--;
+    m_stats.liveBytes -= idle.bytes;
+    m_stats.idleCount++;
+    m_stats.idleBytes += idle.bytes;
+    m_idle.push_back(std::move(idle));
+
+    // e.g. after many window resizes, keep what's most likely to be asked for again
+    while(m_stats.idleBytes > RESOURCE_POOL_IDLE_BUDGET && m_idle.size() > 1)
+    {
+        m_stats.idleCount--;
+        m_stats.idleBytes -= m_idle.front().bytes;
+        m_idle.pop_front();
+    }
+}
+
+size_t ResourcePool::GetBytes(const D3D11_TEXTURE2D_DESC& desc)
+{
+    return (size_t)desc.Width * desc.Height * desc.ArraySize * GetBytesPerPixel(desc.Format);
+}
+
+unsigned ResourcePool::GetBytesPerPixel(DXGI_FORMAT format)
+{
+    switch(format)
+    {
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        return 16;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R32G32_FLOAT:
+        return 8;
+    case DXGI_FORMAT_R16G16_FLOAT:
+    case DXGI_FORMAT_R32_FLOAT:
+    case DXGI_FORMAT_R11G11B10_FLOAT:
+    case DXGI_FORMAT_R10G10B10A2_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        return 4;
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_R8G8_UNORM:
+        return 2;
+    case DXGI_FORMAT_R8_UNORM:
+        return 1;
+    default:
+        return 4; // only used for accounting
+    }
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,69 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include <mutex>
+#include <deque>
+
+#include "Common.h"
+
+namespace ShaderBeam
+{
+
+// idle resources beyond this are released, oldest first
+#define RESOURCE_POOL_IDLE_BUDGET (512ull * 1024 * 1024)
+
+struct ResourcePoolStats
+{
+    unsigned allocations { 0 }; // resources actually created
+    unsigned reuses { 0 };      // requests served from the pool
+    unsigned liveCount { 0 };
+    size_t   liveBytes { 0 };
+    unsigned idleCount { 0 };
+    size_t   idleBytes { 0 };
+};
+
+// textures and buffers handed back on Stop are kept by device and descriptor, so restarts with the same settings
+// get them back instead of creating new ones; contents are whatever was left in them
+class ResourcePool
+{
+public:
+    winrt::com_ptr<ID3D11Texture2D> AcquireTexture(ID3D11Device* device, const D3D11_TEXTURE2D_DESC& desc);
+    winrt::com_ptr<ID3D11Buffer>    AcquireBuffer(ID3D11Device* device, const D3D11_BUFFER_DESC& desc);
+
+    // back to the pool (and nulled), fine to call with nullptr
+    void Release(winrt::com_ptr<ID3D11Texture2D>& texture);
+    void Release(winrt::com_ptr<ID3D11Buffer>& buffer);
+
+    // drops idle resources, e.g. when devices are re-created
+    void Clear();
+
+    ResourcePoolStats GetStats() const;
+
+    static unsigned GetBytesPerPixel(DXGI_FORMAT format);
+
+private:
+    struct IdleResource
+    {
+        ID3D11Device*                  device; // kept alive by the resource
+        D3D11_TEXTURE2D_DESC           textureDesc;
+        D3D11_BUFFER_DESC              bufferDesc;
+        winrt::com_ptr<ID3D11Resource> resource;
+        size_t                         bytes;
+    };
+
+    mutable std::mutex       m_mutex;
+    std::deque<IdleResource> m_idle; // oldest first
+    ResourcePoolStats        m_stats;
+
+    winrt::com_ptr<ID3D11Resource> TakeIdle(ID3D11Device* device, const D3D11_TEXTURE2D_DESC* textureDesc, const D3D11_BUFFER_DESC* bufferDesc);
+    void                           PutIdle(IdleResource&& idle);
+
+    static size_t GetBytes(const D3D11_TEXTURE2D_DESC& desc);
+};
+} // namespace ShaderBeam
@@ -11,12 +11,16 @@ MIT License
 #include "Helpers.h"
 #include "CaptureDD.h"
 #include "CaptureWGC.h"
+#include "CaptureFile.h"
+#include "CaptureTestPattern.h"
 
 namespace ShaderBeam
 {
 
 ShaderBeam::ShaderBeam() :
-    m_options(), m_ui(m_options, m_shaderManager), m_watcher(m_ui), m_renderer(m_options, m_ui, m_watcher, m_shaderManager), m_renderThread(m_options, m_ui, m_renderer)
+    m_options(), m_ui(m_options, m_shaderManager), m_watcher(m_ui, m_renderOptions, m_resourcePool),
+    m_renderer(m_renderOptions, m_ui, m_watcher, m_shaderManager, m_resourcePool, m_shaderCache),
+    m_renderThread(m_renderOptions, m_optionsStore, m_ui, m_renderer, m_scheduler)
 { }
 
 void ShaderBeam::Create(HWND window)
@@ -29,16 +33,21 @@ void ShaderBeam::Create(HWND window)
     RegisterHotKey(m_options.outputWindow, HOTKEY_RESTART, MOD_CONTROL | MOD_SHIFT, HOTKEY_RESTART_KEY);
     RegisterHotKey(m_options.outputWindow, HOTKEY_QUIT, MOD_CONTROL | MOD_SHIFT, HOTKEY_QUIT_KEY);
 
+    // next to ShaderBeam.ini, shaders are loaded relative to the working directory too
+    m_shaderCache.SetDirectory("ShaderCache");
+
     m_ui.m_adapters = GetAdapters();
     m_ui.m_displays = GetDisplays();
     m_ui.m_shaders  = m_shaderManager.GetShaders();
 
-    auto wgc = std::make_shared<CaptureWGC>(m_watcher, m_options);
+    auto wgc = std::make_shared<CaptureWGC>(m_watcher, m_renderOptions, m_workerPool, m_resourcePool);
     if(wgc->IsSupported())
         m_ui.m_captures.emplace_back((int)m_ui.m_captures.size(), wgc->m_name, wgc);
-    auto dd = std::make_shared<CaptureDD>(m_watcher, m_options);
+    auto dd = std::make_shared<CaptureDD>(m_watcher, m_renderOptions, m_workerPool, m_resourcePool);
     if(dd->IsSupported())
         m_ui.m_captures.emplace_back((int)m_ui.m_captures.size(), dd->m_name, dd);
+    auto testPattern = std::make_shared<CaptureTestPattern>(m_watcher, m_renderOptions, m_workerPool, m_resourcePool);
+    m_ui.m_captures.emplace_back((int)m_ui.m_captures.size(), testPattern->m_name, testPattern);
 
     m_ui.m_monitorTypes.push_back("LCD");
     m_ui.m_monitorTypes.push_back("OLED");
@@ -56,6 +65,13 @@ void ShaderBeam::Create(HWND window)
 
     m_options.Load(m_shaderManager);
 
+    // file playback is only offered once one has been set up in the ini
+    if(!m_options.captureFile.empty())
+    {
+        auto file = std::make_shared<CaptureFile>(m_watcher, m_renderOptions, m_workerPool, m_resourcePool);
+        m_ui.m_captures.emplace_back((int)m_ui.m_captures.size(), file->m_name, file);
+    }
+
     DefaultOptions();
 }
 
@@ -67,6 +83,10 @@ void ShaderBeam::Destroy()
     UnregisterHotKey(m_options.outputWindow, HOTKEY_RESTART);
     UnregisterHotKey(m_options.outputWindow, HOTKEY_QUIT);
 
+    m_resourcePool.Clear();
+    m_shaderDevice  = nullptr;
+    m_captureDevice = nullptr;
+
     timeEndPeriod(1);
 }
 
@@ -75,14 +95,259 @@ void ShaderBeam::RunBenchmark()
     m_renderThread.Benchmark();
 }
 
+void ShaderBeam::StartAutoTune()
+{
+    if(m_autoTuner.IsRunning())
+    {
+        // cancelled, go back to where we were
+        m_autoTuner.Stop();
+        ApplyAutoTuneCandidate(m_autoTuner.GetOriginal());
+        m_options.Save(m_shaderManager);
+        m_ui.SetAutoTuneStatus(false, "Auto-tune cancelled");
+        return;
+    }
+
+    std::vector<AutoTuneCandidate> candidates;
+    for(const auto& adapter : m_ui.m_adapters)
+    {
+        for(const auto& capture : m_ui.m_captures)
+        {
+            if(m_options.captureWindow && !capture.api->SupportsWindowCapture())
+                continue;
+            if(capture.api->IsSynthetic())
+                continue;
+
+            for(int queuedFrames = 1; queuedFrames <= (int)m_options.autoTuneMaxQueuedFrames && queuedFrames < (int)m_ui.m_queuedFrames.size(); queuedFrames++)
+                candidates.push_back({ .maxQueuedFrames = queuedFrames, .shaderAdapterNo = (int)adapter.no, .captureMethod = (int)capture.no });
+        }
+    }
+
+    AutoTuneCandidate original { .maxQueuedFrames = m_options.maxQueuedFrames, .shaderAdapterNo = m_options.shaderAdapterNo, .captureMethod = m_options.captureMethod };
+    m_autoTuner.Start(candidates, original, m_options.autoTuneWarmup, m_options.autoTuneWindow);
+    if(m_autoTuner.IsRunning())
+    {
+        if(ApplyAutoTuneCandidate(m_autoTuner.GetCandidate()))
+            UpdateAutoTuneStatus();
+        else
+            NextAutoTuneCandidate();
+    }
+}
+
+void ShaderBeam::UpdateAutoTune()
+{
+    if(!m_autoTuner.IsRunning() || !m_active)
+        return;
+
+    AutoTuneSample sample { .missedVsyncRate = m_ui.m_missedVsyncRate, .submitP99 = m_ui.m_submitP99, .captureLag = m_ui.m_captureLag };
+    if(!m_autoTuner.Tick(sample, m_options.vsyncDuration))
+        return;
+
+    NextAutoTuneCandidate();
+}
+
+void ShaderBeam::NextAutoTuneCandidate()
+{
+    // candidates that fail to start are left without samples, GetBest skips them
+    while(m_autoTuner.NextCandidate())
+    {
+        if(ApplyAutoTuneCandidate(m_autoTuner.GetCandidate()))
+        {
+            UpdateAutoTuneStatus();
+            return;
+        }
+    }
+
+    // all measured, keep the best one and only now save it
+    const auto best = m_autoTuner.GetBest();
+    ApplyAutoTuneCandidate(best ? best->candidate : m_autoTuner.GetOriginal());
+    if(best)
+    {
+        char status[128];
+        snprintf(status,
+                 sizeof(status),
+                 "Auto-tune picked GPU #%d, %s, %d queued (%.1f%% missed)",
+                 best->candidate.shaderAdapterNo + 1,
+                 m_ui.m_captures[best->candidate.captureMethod].name.c_str(),
+                 best->candidate.maxQueuedFrames,
+                 best->missedVsyncRate * 100.0f);
+        m_ui.SetAutoTuneStatus(false, status);
+    }
+    else
+    {
+        m_ui.SetAutoTuneStatus(false, "Auto-tune failed");
+    }
+    m_options.Save(m_shaderManager);
+}
+
+bool ShaderBeam::ApplyAutoTuneCandidate(const AutoTuneCandidate& candidate)
+{
+    // trial configurations never reach the ini, callers save once one is chosen
+    if(m_active)
+        Stop(false);
+
+    m_options.maxQueuedFrames = candidate.maxQueuedFrames;
+    m_options.shaderAdapterNo = candidate.shaderAdapterNo;
+    m_options.captureMethod   = candidate.captureMethod;
+
+    return Start();
+}
+
+void ShaderBeam::UpdateAutoTuneStatus()
+{
+    const auto& candidate = m_autoTuner.GetCandidate();
+    char        status[128];
+    snprintf(status,
+             sizeof(status),
+             "Auto-tuning %d/%d: GPU #%d, %s, %d queued",
+             m_autoTuner.GetCandidateNo() + 1,
+             m_autoTuner.GetNumCandidates(),
+             candidate.shaderAdapterNo + 1,
+             m_ui.m_captures[candidate.captureMethod].name.c_str(),
+             candidate.maxQueuedFrames);
+    m_ui.SetAutoTuneStatus(true, status);
+}
+
+void ShaderBeam::ApplySchedulingPolicy()
+{
+    SchedulingPolicy policy {
+        .schedulingClass   = m_options.schedulingClass,
+        .renderCores       = (uint64_t)(unsigned)m_options.renderCores,
+        .captureCores      = (uint64_t)(unsigned)m_options.captureCores,
+        .workerCores       = (uint64_t)(unsigned)m_options.workerCores,
+        .isolateUI         = m_options.isolateUI,
+        .deadlinePeriodUs  = (unsigned)(m_options.vsyncDuration * 1000.0f),
+        .deadlineRuntimeUs = (unsigned)(m_options.vsyncDuration * 10.0f * std::clamp(m_options.deadlineBudget, 1, 100)),
+    };
+    m_scheduler.SetPolicy(policy);
+
+    // we're on the message thread here
+    if(!m_scheduler.Apply(ThreadRole::UI))
+        OutputDebugStringA(m_scheduler.GetLastError().c_str());
+}
+
 void ShaderBeam::UpdateVsyncRate()
 {
     // get VSync duration from DWM (should match fastest display)
     DWM_TIMING_INFO dwmInfo {};
     dwmInfo.cbSize = sizeof(dwmInfo);
     DwmGetCompositionTimingInfo(NULL, &dwmInfo);
-    m_options.vsyncDuration = Helpers::QPCToDeltaMs(dwmInfo.qpcRefreshPeriod);
+    auto vsyncDuration = Helpers::QPCToDeltaMs(dwmInfo.qpcRefreshPeriod);
+    if(vsyncDuration == m_options.vsyncDuration)
+        return;
+
+    m_options.vsyncDuration = vsyncDuration;
     m_options.vsyncRate     = 1000.0f / m_options.vsyncDuration;
+    if(m_active)
+        ApplyOptions();
+}
+
+// returns false if a full restart is required to apply options
+bool ShaderBeam::ApplyOptions()
+{
+    if(!m_active)
+    {
+        m_optionsStore.Publish(m_options);
+        return true;
+    }
+
+    const auto flags = ReconfigurationPlanner::Plan(m_optionsStore.Acquire()->options, m_options);
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_FULL))
+        return false;
+
+    if(ReconfigurationPlanner::Requires(flags, RECONFIGURE_CAPTURE))
+    {
+        RestartCapture();
+        return true;
+    }
+
+    // render thread picks it up at the next subframe and rebuilds what's needed
+    m_optionsStore.Publish(m_options);
+    m_renderThread.Reconfigure(false);
+    return true;
+}
+
+void ShaderBeam::RestartCapture()
+{
+    auto start = Helpers::GetTicks();
+
+    // render thread keeps presenting the last frame while capture is switched
+    m_renderThread.ChangeCapture(nullptr);
+    m_ui.m_captures[m_renderOptions.captureMethod].api->Stop();
+
+    m_options.captureMonitor = m_ui.m_displays.at(m_options.captureDisplayNo).monitor;
+    const auto& capture      = m_ui.m_captures[m_options.captureMethod].api;
+    if(m_options.captureWindow && !capture->SupportsWindowCapture())
+        m_options.captureWindow = NULL;
+    UpdateInputArea();
+    UpdateWorkerPool(*capture);
+
+    // capture reads render-side options, so wait till they're adopted (may also carry schedule/scissor changes)
+    m_optionsStore.Publish(m_options);
+    m_renderThread.Reconfigure(true);
+
+    try
+    {
+        capture->Start(m_captureDevice.as<IDXGIDevice>(), m_deviceContext);
+    }
+    catch(std::exception& ex)
+    {
+        m_ui.SetError(ex.what());
+    }
+
+    m_renderThread.ChangeCapture(capture);
+    m_ui.SetReconfigured(RECONFIGURE_CAPTURE, Helpers::GetTicks() - start);
+}
+
+void ShaderBeam::UpdateWorkerPool(CaptureBase& capture)
+{
+    // CPU copies between adapters and frames generated on the CPU are split across these, nothing else needs them
+    if(!m_options.crossAdapter && !capture.IsSynthetic())
+    {
+        m_workerPool.Stop();
+        return;
+    }
+
+    auto workerThreads = m_options.workerThreads > 0 ? (unsigned)m_options.workerThreads : WorkerPool::DefaultThreads();
+    if(m_workerPool.GetNumThreads() != workerThreads)
+        m_workerPool.Start(workerThreads, [this]() { m_scheduler.Apply(ThreadRole::Worker); });
+}
+
+void ShaderBeam::UpdateInputArea()
+{
+    m_options.windowX     = 0;
+    m_options.windowY     = 0;
+    m_options.inputX      = 0;
+    m_options.inputY      = 0;
+    m_options.inputWidth  = m_options.outputWidth;
+    m_options.inputHeight = m_options.outputHeight;
+
+    RECT captureRect;
+    if(!m_options.captureWindow || DwmGetWindowAttribute(m_options.captureWindow, DWMWA_EXTENDED_FRAME_BOUNDS, &captureRect, sizeof(RECT)) != S_OK)
+        return;
+
+    auto        monitor = MonitorFromWindow(m_options.captureWindow, MONITOR_DEFAULTTONEAREST);
+    MONITORINFO monitorInfo;
+    monitorInfo.cbSize = sizeof(monitorInfo);
+    if(!GetMonitorInfo(monitor, &monitorInfo))
+        return;
+
+    m_options.windowX = captureRect.left - monitorInfo.rcMonitor.left;
+    m_options.windowY = captureRect.top - monitorInfo.rcMonitor.top;
+    if(!m_options.windowSizedInputs)
+        return;
+
+    // inputs only need to hold the part of the window that is on screen
+    auto left   = std::clamp(m_options.windowX, 0, (int)m_options.outputWidth);
+    auto top    = std::clamp(m_options.windowY, 0, (int)m_options.outputHeight);
+    auto right  = std::clamp((int)(captureRect.right - monitorInfo.rcMonitor.left), left, (int)m_options.outputWidth);
+    auto bottom = std::clamp((int)(captureRect.bottom - monitorInfo.rcMonitor.top), top, (int)m_options.outputHeight);
+    if(right > left && bottom > top)
+    {
+        m_options.inputX      = left;
+        m_options.inputY      = top;
+        m_options.inputWidth  = right - left;
+        m_options.inputHeight = bottom - top;
+    }
 }
 
 void ShaderBeam::DefaultOptions()
@@ -111,15 +376,36 @@ void ShaderBeam::DefaultOptions()
         m_options.shaderProfileNo = 0;
 }
 
-void ShaderBeam::Start()
+bool ShaderBeam::Start()
 {
-    m_options.crossAdapter     = m_options.shaderAdapterNo != m_options.captureAdapterNo;
-    const auto& captureAdapter = m_ui.m_adapters.at(m_options.captureAdapterNo);
-    const auto& shaderAdapter  = m_ui.m_adapters.at(m_options.shaderAdapterNo);
-    auto        captureDevice  = Helpers::CreateD3DDevice(captureAdapter.adapter.get());
-    auto        shaderDevice   = m_options.crossAdapter ? Helpers::CreateD3DDevice(shaderAdapter.adapter.get()) : captureDevice;
+    m_options.crossAdapter = m_options.shaderAdapterNo != m_options.captureAdapterNo;
+    if(!DevicesReusable())
+    {
+        // whatever the pool holds belongs to the old devices
+        m_resourcePool.Clear();
+        m_captureDevice = nullptr;
+        m_shaderDevice  = nullptr;
+        try
+        {
+            const auto& captureAdapter = m_ui.m_adapters.at(m_options.captureAdapterNo);
+            const auto& shaderAdapter  = m_ui.m_adapters.at(m_options.shaderAdapterNo);
+            m_captureDevice            = Helpers::CreateD3DDevice(captureAdapter.adapter.get());
+            m_shaderDevice             = m_options.crossAdapter ? Helpers::CreateD3DDevice(shaderAdapter.adapter.get()) : m_captureDevice;
+        }
+        catch(std::exception& ex)
+        {
+            m_captureDevice = nullptr;
+            m_shaderDevice  = nullptr;
+            return StartFailed(ex.what());
+        }
+        m_captureDeviceAdapterNo = m_options.captureAdapterNo;
+        m_shaderDeviceAdapterNo  = m_options.shaderAdapterNo;
+    }
+    auto captureDevice = m_captureDevice;
+    auto shaderDevice  = m_shaderDevice;
 
     UpdateVsyncRate();
+    ApplySchedulingPolicy();
 
     const auto& captureDisplay = m_ui.m_displays.at(m_options.captureDisplayNo);
     const auto& shaderDisplay  = m_ui.m_displays.at(m_options.shaderDisplayNo);
@@ -137,6 +423,12 @@ void ShaderBeam::Start()
     const auto& capture = m_ui.m_captures[m_options.captureMethod].api;
     if(m_options.captureWindow && !capture->SupportsWindowCapture())
         m_options.captureWindow = NULL;
+    UpdateInputArea();
+    UpdateWorkerPool(*capture);
+
+    // render thread is not running yet, adopt directly
+    m_optionsStore.Publish(m_options);
+    m_renderThread.AdoptOptions();
 
     try
     {
@@ -147,22 +439,34 @@ void ShaderBeam::Start()
     {
         MessageBoxA(m_options.outputWindow, ex.what(), SHADERBEAM_TITLE, MB_ICONERROR | MB_OK);
         PostMessage(m_options.outputWindow, WM_DESTROY, 0, 0);
-        return;
+        return false;
     }
 
+    const auto shadersBefore = m_shaderCache.GetStats();
     try
     {
         m_renderer.Start(shaderDevice, deviceContext);
     }
     catch(std::exception& ex)
     {
-        MessageBoxA(m_options.outputWindow, ex.what(), SHADERBEAM_TITLE, MB_ICONERROR | MB_OK);
-        PostMessage(m_options.outputWindow, WM_DESTROY, 0, 0);
-        return;
+        // undo what did start so another configuration can be tried
+        m_renderer.Stop();
+        m_ui.Stop();
+        return StartFailed(ex.what());
     }
 
+    // cold (compiled) vs warm (cached) start
+    const auto shadersAfter        = m_shaderCache.GetStats();
+    m_ui.m_shaderStartup.compiled  = shadersAfter.compiled - shadersBefore.compiled;
+    m_ui.m_shaderStartup.loaded    = shadersAfter.loaded - shadersBefore.loaded;
+    m_ui.m_shaderStartup.rejected  = shadersAfter.rejected - shadersBefore.rejected;
+    m_ui.m_shaderStartup.compileMs = shadersAfter.compileMs - shadersBefore.compileMs;
+    m_ui.m_shaderStartup.loadMs    = shadersAfter.loadMs - shadersBefore.loadMs;
+
     m_watcher.Start();
 
+    UpdateWorkerPool(*capture);
+
     try
     {
         capture->Start(captureDevice.as<IDXGIDevice>(), deviceContext);
@@ -174,20 +478,61 @@ void ShaderBeam::Start()
 
     m_renderThread.Start(capture);
 
-    m_active = true;
+    m_deviceContext = deviceContext;
+    m_active        = true;
+
+    if(m_restartTicks)
+    {
+        m_ui.SetReconfigured(RECONFIGURE_FULL, Helpers::GetTicks() - m_restartTicks);
+        m_restartTicks = 0;
+    }
+    return true;
 }
 
-void ShaderBeam::Stop()
+bool ShaderBeam::StartFailed(const char* error)
 {
-    m_options.Save(m_shaderManager);
+    // auto-tune just rejects the candidate, otherwise there's nothing to fall back to
+    if(m_autoTuner.IsRunning())
+    {
+        OutputDebugStringA(error);
+        return false;
+    }
+
+    MessageBoxA(m_options.outputWindow, error, SHADERBEAM_TITLE, MB_ICONERROR | MB_OK);
+    PostMessage(m_options.outputWindow, WM_DESTROY, 0, 0);
+    return false;
+}
+
+void ShaderBeam::Stop(bool saveOptions)
+{
+    m_restartTicks = Helpers::GetTicks();
 
     m_renderThread.Stop();
-    m_ui.m_captures[m_options.captureMethod].api->Stop();
+    // mid auto-tune the options hold a trial, the ini keeps what was there until one is picked
+    if(saveOptions && !m_autoTuner.IsRunning())
+        m_options.Save(m_shaderManager);
+
+    // stop the capture that's actually running, UI may have changed the selection already
+    m_ui.m_captures[m_renderOptions.captureMethod].api->Stop();
+    m_workerPool.Stop();
     m_watcher.Stop();
     m_renderer.Stop();
     m_ui.Stop();
 
-    m_active = false;
+    // devices stay around (with resources pooled on them) so the next Start can pick them up
+    m_deviceContext = nullptr;
+    m_active        = false;
+}
+
+bool ShaderBeam::DevicesReusable() const
+{
+    if(!m_captureDevice || !m_shaderDevice)
+        return false;
+    if(m_captureDeviceAdapterNo != m_options.captureAdapterNo || m_shaderDeviceAdapterNo != m_options.shaderAdapterNo)
+        return false;
+
+    // restarts after device loss need new ones
+    return m_captureDevice->GetDeviceRemovedReason() == S_OK && m_shaderDevice->GetDeviceRemovedReason() == S_OK;
 }
 
 std::vector<winrt::com_ptr<IDXGIAdapter2>> ShaderBeam::EnumerateAdapters()
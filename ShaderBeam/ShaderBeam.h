@@ -12,6 +12,13 @@ MIT License
 #include "ShaderManager.h"
 #include "Watcher.h"
 #include "RenderThread.h"
+#include "AutoTuner.h"
+#include "ThreadScheduler.h"
+#include "OptionsStore.h"
+#include "ReconfigurationPlanner.h"
+#include "WorkerPool.h"
+#include "ResourcePool.h"
+#include "ShaderCache.h"
 
 namespace ShaderBeam
 {
@@ -22,26 +29,52 @@ public:
     ShaderBeam();
 
     void Create(HWND window);
-    void Start();
-    void Stop();
+    bool Start();
+    void Stop(bool saveOptions = true);
     void Destroy();
 
     void RunBenchmark();
     void UpdateVsyncRate();
+    bool ApplyOptions();
+    void StartAutoTune();
+    void UpdateAutoTune();
 
     UI      m_ui;
     Options m_options;
     bool    m_active { false };
 
 private:
-    Watcher       m_watcher;
-    Renderer      m_renderer;
-    RenderThread  m_renderThread;
-    ShaderManager m_shaderManager;
+    OptionsStore    m_optionsStore;
+    Options         m_renderOptions; // copy owned by the render thread, see RenderThread::AdoptOptions
+    ResourcePool    m_resourcePool;
+    ShaderCache     m_shaderCache;
+    Watcher         m_watcher;
+    Renderer        m_renderer;
+    ThreadScheduler m_scheduler;
+    WorkerPool      m_workerPool;
+    RenderThread    m_renderThread;
+    ShaderManager   m_shaderManager;
+    AutoTuner       m_autoTuner;
+
+    winrt::com_ptr<ID3D11Device>        m_captureDevice;
+    winrt::com_ptr<ID3D11Device>        m_shaderDevice;
+    winrt::com_ptr<ID3D11DeviceContext> m_deviceContext;
+    int                                 m_captureDeviceAdapterNo { -1 };
+    int                                 m_shaderDeviceAdapterNo { -1 };
+    float                               m_restartTicks { 0 };
 
     std::vector<AdapterInfo> GetAdapters();
     std::vector<DisplayInfo> GetDisplays();
     void                     DefaultOptions();
+    bool                     ApplyAutoTuneCandidate(const AutoTuneCandidate& candidate);
+    void                     NextAutoTuneCandidate();
+    void                     ApplySchedulingPolicy();
+    void                     RestartCapture();
+    void                     UpdateWorkerPool(CaptureBase& capture);
+    void                     UpdateInputArea();
+    void                     UpdateAutoTuneStatus();
+    bool                     DevicesReusable() const;
+    bool                     StartFailed(const char* error);
 
     static std::vector<winrt::com_ptr<IDXGIAdapter2>> EnumerateAdapters();
 };
@@ -0,0 +1,222 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace ShaderBeam
+{
+
+// bump when the entry layout changes
+constexpr uint32_t SHADER_CACHE_MAGIC   = 0x43534253; // "SBSC"
+constexpr uint32_t SHADER_CACHE_VERSION = 1;
+
+struct ShaderCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t size;
+    uint64_t checksum; // of the bytecode, catches entries cut short
+};
+
+void ShaderCache::SetDirectory(const std::filesystem::path& directory)
+{
+    std::lock_guard lock(m_mutex);
+    m_directory = directory;
+    if(!m_directory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if(error)
+            m_directory.clear();
+    }
+}
+
+std::vector<uint8_t> ShaderCache::Get(const std::filesystem::path& source,
+                                      const ShaderMacros&          macros,
+                                      const std::string&           entryPoint,
+                                      const std::string&           target,
+                                      const std::string&           compilerVersion,
+                                      const Compiler&              compile)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // separators keep e.g. macro "A"="BC" and "AB"="C" apart
+    auto key = HashSources(source);
+    for(const auto& [name, value] : macros)
+        key = Hash(value, Hash(name, key));
+    key = Hash(entryPoint, key);
+    key = Hash(target, key);
+    key = Hash(compilerVersion, key);
+
+    std::filesystem::path file;
+    {
+        std::lock_guard lock(m_mutex);
+        if(!m_directory.empty())
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.cso", (unsigned long long)key);
+            file = m_directory / name;
+        }
+    }
+
+    std::vector<uint8_t> bytecode;
+    if(!file.empty() && Load(file, key, bytecode))
+    {
+        std::lock_guard lock(m_mutex);
+        m_stats.loaded++;
+        m_stats.loadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return bytecode;
+    }
+
+    bytecode = compile();
+    if(!file.empty())
+        Store(file, key, bytecode);
+
+    std::lock_guard lock(m_mutex);
+    m_stats.compiled++;
+    m_stats.compileMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return bytecode;
+}
+
+ShaderCacheStats ShaderCache::GetStats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
+bool ShaderCache::Load(const std::filesystem::path& file, uint64_t key, std::vector<uint8_t>& bytecode)
+{
+    std::ifstream stream(file, std::ios::binary);
+    if(!stream)
+        return false;
+
+    ShaderCacheHeader header {};
+    if(stream.read((char*)&header, sizeof(header)) && header.magic == SHADER_CACHE_MAGIC && header.version == SHADER_CACHE_VERSION && header.key == key)
+    {
+        bytecode.resize(header.size);
+        if(stream.read((char*)bytecode.data(), bytecode.size()) && Hash(bytecode.data(), bytecode.size()) == header.checksum)
+            return true;
+    }
+
+    // someone else's or damaged, compiling writes a good one over it
+    bytecode.clear();
+    std::lock_guard lock(m_mutex);
+    m_stats.rejected++;
+    return false;
+}
+
+void ShaderCache::Store(const std::filesystem::path& file, uint64_t key, const std::vector<uint8_t>& bytecode) const
+{
+    static std::atomic<unsigned> tempCounter { 0 };
+
+    ShaderCacheHeader header {};
+    header.magic    = SHADER_CACHE_MAGIC;
+    header.version  = SHADER_CACHE_VERSION;
+    header.key      = key;
+    header.size     = bytecode.size();
+    header.checksum = Hash(bytecode.data(), bytecode.size());
+
+    // complete entry goes in under a temporary name first, renaming it into place replaces the old one in one step
+    auto temp = file;
+    temp += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" + std::to_string(tempCounter++);
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if(!stream.write((const char*)&header, sizeof(header)) || !stream.write((const char*)bytecode.data(), bytecode.size()))
+        {
+            stream.close();
+            std::error_code error;
+            std::filesystem::remove(temp, error);
+            return;
+        }
+    }
+
+    // a cache that can't be written is just slower, never an error
+    std::error_code error;
+    std::filesystem::rename(temp, file, error);
+    if(error)
+        std::filesystem::remove(temp, error);
+}
+
+uint64_t ShaderCache::HashSources(const std::filesystem::path& source)
+{
+    std::vector<std::filesystem::path> visited;
+    uint64_t                           hash = SHADER_HASH_SEED;
+    HashSources(source, visited, hash);
+    return hash;
+}
+
+void ShaderCache::HashSources(const std::filesystem::path& source, std::vector<std::filesystem::path>& visited, uint64_t& hash)
+{
+    auto normal = source.lexically_normal();
+    if(std::find(visited.begin(), visited.end(), normal) != visited.end())
+        return;
+    visited.push_back(normal);
+
+    // a missing file still counts, it may show up later
+    hash = Hash(normal.generic_string(), hash);
+    std::ifstream stream(source, std::ios::binary);
+    if(!stream)
+    {
+        hash = Hash(std::string("<missing>"), hash);
+        return;
+    }
+
+    std::stringstream content;
+    content << stream.rdbuf();
+    const auto text = content.str();
+    hash            = Hash(text.data(), text.size(), hash);
+
+    // includes inside comments or disabled #if blocks count too, which only costs a recompile
+    std::istringstream lines(text);
+    std::string        line;
+    while(std::getline(lines, line))
+    {
+        auto directive = line.find_first_not_of(" \t");
+        if(directive == std::string::npos || line.compare(directive, 1, "#") != 0)
+            continue;
+        auto keyword = line.find_first_not_of(" \t", directive + 1);
+        if(keyword == std::string::npos || line.compare(keyword, 7, "include") != 0)
+            continue;
+
+        auto open = line.find_first_of("\"<", keyword + 7);
+        if(open == std::string::npos)
+            continue;
+        auto close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+        if(close == std::string::npos)
+            continue;
+
+        HashSources(source.parent_path() / line.substr(open + 1, close - open - 1), visited, hash);
+    }
+}
+
+uint64_t ShaderCache::Hash(const void* data, size_t size, uint64_t hash)
+{
+    auto bytes = (const uint8_t*)data;
+    for(size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t ShaderCache::Hash(const std::string& text, uint64_t hash)
+{
+    // length first so consecutive strings can't run into each other
+    const uint64_t length = text.size();
+    return Hash(text.data(), text.size(), Hash(&length, sizeof(length), hash));
+}
+
+} // namespace ShaderBeam
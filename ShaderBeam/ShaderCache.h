@@ -0,0 +1,72 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ShaderBeam
+{
+
+constexpr uint64_t SHADER_HASH_SEED = 0xcbf29ce484222325ull; // FNV-1a offset basis
+
+using ShaderMacros = std::vector<std::pair<std::string, std::string>>;
+
+struct ShaderCacheStats
+{
+    unsigned compiled { 0 }; // not found or out of date
+    unsigned loaded { 0 };   // served from disk
+    unsigned rejected { 0 }; // entries that failed validation, e.g. truncated
+    double   compileMs { 0.0 };
+    double   loadMs { 0.0 };
+};
+
+// compiled shader bytecode kept on disk, keyed by a hash of the source with everything it includes, macros,
+// entry point, target and compiler; any change to those gives a different key, so stale entries are never read
+class ShaderCache
+{
+public:
+    // invoked on a miss, throws if compilation fails (nothing gets cached then)
+    using Compiler = std::function<std::vector<uint8_t>()>;
+
+    // empty disables the disk side, everything is compiled
+    void SetDirectory(const std::filesystem::path& directory);
+
+    std::vector<uint8_t> Get(const std::filesystem::path& source,
+                             const ShaderMacros&          macros,
+                             const std::string&           entryPoint,
+                             const std::string&           target,
+                             const std::string&           compilerVersion,
+                             const Compiler&              compile);
+
+    ShaderCacheStats GetStats() const;
+
+    // source and every file it #includes, resolved relative to the including file like the standard include handler
+    static uint64_t HashSources(const std::filesystem::path& source);
+    static uint64_t Hash(const void* data, size_t size, uint64_t hash = SHADER_HASH_SEED);
+    static uint64_t Hash(const std::string& text, uint64_t hash);
+
+private:
+    mutable std::mutex    m_mutex;
+    std::filesystem::path m_directory;
+    ShaderCacheStats      m_stats;
+
+    bool Load(const std::filesystem::path& file, uint64_t key, std::vector<uint8_t>& bytecode);
+    void Store(const std::filesystem::path& file, uint64_t key, const std::vector<uint8_t>& bytecode) const;
+
+    static void HashSources(const std::filesystem::path& source, std::vector<std::filesystem::path>& visited, uint64_t& hash);
+};
+} // namespace ShaderBeam
@@ -23,8 +23,36 @@ void ShaderManager::Create(const RenderContext& renderContext, int profileNo)
     if(profileNo >= m_shaderProfiles.size())
         abort();
 
+    m_created.assign(m_shaderProfiles.size(), false);
+    m_activeProfile = profileNo;
+    Build(renderContext, profileNo);
+
+    // the rest are prewarmed, one that fails only matters once it's switched to (and gets another try then)
+    for(int no = 0; no < (int)m_shaderProfiles.size(); no++)
+    {
+        if(no == profileNo)
+            continue;
+        try
+        {
+            Build(renderContext, no);
+        }
+        catch(const std::exception& ex)
+        {
+            OutputDebugStringA(ex.what());
+        }
+    }
+}
+
+void ShaderManager::Switch(const RenderContext& renderContext, int profileNo)
+{
+    if(profileNo >= m_shaderProfiles.size())
+        abort();
+
+    Build(renderContext, profileNo);
+
+    // subframes may have changed while it wasn't active
+    m_shaderProfiles[profileNo]->Reconfigure(renderContext);
     m_activeProfile = profileNo;
-    m_shaderProfiles[m_activeProfile]->Create(renderContext);
 }
 
 void ShaderManager::Render(const RenderContext& renderContext)
@@ -34,7 +62,30 @@ void ShaderManager::Render(const RenderContext& renderContext)
 
 void ShaderManager::Destroy()
 {
-    m_shaderProfiles[m_activeProfile]->Destroy();
+    for(int no = 0; no < (int)m_created.size(); no++)
+    {
+        if(m_created[no])
+            m_shaderProfiles[no]->Destroy();
+    }
+    m_created.clear();
+}
+
+void ShaderManager::Build(const RenderContext& renderContext, int profileNo)
+{
+    if(m_created[profileNo])
+        return;
+
+    try
+    {
+        m_shaderProfiles[profileNo]->Create(renderContext);
+    }
+    catch(...)
+    {
+        // whatever it got to create before failing
+        m_shaderProfiles[profileNo]->Destroy();
+        throw;
+    }
+    m_created[profileNo] = true;
 }
 
 std::vector<ShaderInfo> ShaderManager::GetShaders() const
@@ -63,9 +114,17 @@ void ShaderManager::ResetDefaults()
     m_shaderProfiles[m_activeProfile]->ResetDefaults();
 }
 
-int ShaderManager::NumInputsRequired()
+int ShaderManager::GetActiveProfile() const
 {
-    return m_shaderProfiles[m_activeProfile]->m_numInputs;
+    return m_activeProfile;
+}
+
+int ShaderManager::NumInputsRequired() const
+{
+    int numInputs = 1;
+    for(const auto& profile : m_shaderProfiles)
+        numInputs = max(numInputs, profile->m_numInputs);
+    return numInputs;
 }
 
 bool ShaderManager::NewInputRequired(const RenderContext& renderContext) const
@@ -78,4 +137,14 @@ bool ShaderManager::SupportsResync(const RenderContext& renderContext) const
     return m_shaderProfiles[m_activeProfile]->SupportsResync(renderContext);
 }
 
+bool ShaderManager::UsesHistory(const RenderContext& renderContext) const
+{
+    return m_shaderProfiles[m_activeProfile]->UsesHistory(renderContext);
+}
+
+void ShaderManager::Reconfigure(const RenderContext& renderContext)
+{
+    m_shaderProfiles[m_activeProfile]->Reconfigure(renderContext);
+}
+
 } // namespace ShaderBeam
\ No newline at end of file
@@ -7,6 +7,8 @@ MIT License
 
 #pragma once
 
+#include <atomic>
+
 #include "ShaderProfile.h"
 
 namespace ShaderBeam
@@ -17,7 +19,9 @@ class ShaderManager
 public:
     ShaderManager();
 
+    // builds every profile so switching between them needs no restart, profileNo becomes active
     void Create(const RenderContext& renderContext, int profileNo);
+    void Switch(const RenderContext& renderContext, int profileNo);
     void Render(const RenderContext& renderContext);
     void Destroy();
 
@@ -25,12 +29,18 @@ public:
     const std::vector<ParameterInfo>& GetParameterInfos(int profileNo) const;
     const std::vector<ParameterInfo>& GetParameterInfos() const;
     void                              ResetDefaults();
-    int                               NumInputsRequired();
+    int                               GetActiveProfile() const;
+    int                               NumInputsRequired() const; // deepest history of all profiles, so any of them can take over
     bool                              NewInputRequired(const RenderContext& renderContext) const;
     bool                              SupportsResync(const RenderContext& renderContext) const;
+    bool                              UsesHistory(const RenderContext& renderContext) const;
+    void                              Reconfigure(const RenderContext& renderContext);
 
 private:
-    int                       m_activeProfile { 0 };
+    std::atomic<int>          m_activeProfile { 0 }; // UI reads parameters of the active one from the message thread
     std::span<ShaderProfile*> m_shaderProfiles;
+    std::vector<bool>         m_created;
+
+    void Build(const RenderContext& renderContext, int profileNo);
 };
 } // namespace ShaderBeam
\ No newline at end of file
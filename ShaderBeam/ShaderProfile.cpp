@@ -14,7 +14,12 @@ namespace ShaderBeam
 
 void ShaderProfile::Passthrough(const RenderContext& renderContext)
 {
-    renderContext.deviceContext->CopyResource(renderContext.outputTexture.get(), renderContext.inputTextures[renderContext.inputSlots[0]].get());
+    const auto& options = renderContext.options;
+    const auto& input   = renderContext.GetNewestInput();
+    if(options.inputWidth == options.outputWidth && options.inputHeight == options.outputHeight)
+        renderContext.deviceContext->CopyResource(renderContext.outputTexture.get(), input.get());
+    else
+        renderContext.deviceContext->CopySubresourceRegion(renderContext.outputTexture.get(), 0, options.inputX, options.inputY, 0, input.get(), 0, nullptr);
 }
 
 void ShaderProfile::AddParameter(const char* name, const char* description, float* value, float min, float max)
@@ -81,4 +86,11 @@ bool ShaderProfile::SupportsResync(const RenderContext& renderContext) const
     return true;
 }
 
+bool ShaderProfile::UsesHistory(const RenderContext& renderContext) const
+{
+    return m_numInputs > 1;
+}
+
+void ShaderProfile::Reconfigure(const RenderContext& renderContext) { }
+
 } // namespace ShaderBeam
\ No newline at end of file
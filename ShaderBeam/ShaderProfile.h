@@ -22,11 +22,13 @@ public:
 
     std::string                m_name;
     std::vector<ParameterInfo> m_parameterInfos;
-    int                        m_numInputs { 1 };
+    int                        m_numInputs { 1 }; // history depth, newest frame included (up to MAX_INPUTS)
 
     void         ResetDefaults();
     virtual bool NewInputRequired(const RenderContext& renderContext) const;
     virtual bool SupportsResync(const RenderContext& renderContext) const;
+    virtual bool UsesHistory(const RenderContext& renderContext) const;
+    virtual void Reconfigure(const RenderContext& renderContext);
 
 protected:
     void                       Passthrough(const RenderContext& renderContext);
@@ -16,6 +16,13 @@ cbuffer Params : register(b0)
     float param_crtHzCounter;
 };
 
+// set by ShaderBeam: where input textures sit on the output, maps output uv to input uv
+cbuffer Input : register(b1)
+{
+    float2 input_offset;
+    float2 input_scale;
+};
+
 #define GAMMA                   param_gamma
 #define GAIN_VS_BLUR            param_gainVsBlur
 #define EFFECTIVE_FRAMES_PER_HZ param_effectiveFramesPerHz
@@ -219,13 +226,9 @@ float3 getPixelFromOrigFrame(float2 uv, float getFromHzNumber, float currentHzCo
 // - phaseOffset: fractional start of the brightness interval [0..1] (0.0 at top, 1.0 at bottom).
 // - framesPerHz: Number of frames per Hz. (Does not have to be integer divisible!)
 //
-float3 getPixelFromSimulatedCRT(float2 uv, float crtRasterPos, float crtHzCounter, float framesPerHz, float tubePos)
+// (split from getPixelFromSimulatedCRT below so the compute version can feed pixels it loaded itself)
+float3 simulateCRT(float3 pixelPrev2, float3 pixelPrev1, float3 pixelCurr, float crtRasterPos, float framesPerHz, float tubePos)
 {
-    // Get pixels from three consecutive refresh cycles
-    float3 pixelPrev2 = srgb2linear(getPixelFromOrigFrame(uv, crtHzCounter - 2.0, crtHzCounter));
-    float3 pixelPrev1 = srgb2linear(getPixelFromOrigFrame(uv, crtHzCounter - 1.0, crtHzCounter));
-    float3 pixelCurr = srgb2linear(getPixelFromOrigFrame(uv, crtHzCounter, crtHzCounter));
-
     float3 result = float3(0.0, 0.0, 0.0);
 
     // Compute "photon budgets" for all three cycles
@@ -296,6 +299,38 @@ float3 getPixelFromSimulatedCRT(float2 uv, float crtRasterPos, float crtHzCounte
     return linear2srgb(result);
 }
 
+float3 getPixelFromSimulatedCRT(float2 uv, float crtRasterPos, float crtHzCounter, float framesPerHz, float tubePos)
+{
+    // Get pixels from three consecutive refresh cycles
+    float3 pixelPrev2 = srgb2linear(getPixelFromOrigFrame(uv, crtHzCounter - 2.0, crtHzCounter));
+    float3 pixelPrev1 = srgb2linear(getPixelFromOrigFrame(uv, crtHzCounter - 1.0, crtHzCounter));
+    float3 pixelCurr = srgb2linear(getPixelFromOrigFrame(uv, crtHzCounter, crtHzCounter));
+
+    return simulateCRT(pixelPrev2, pixelPrev1, pixelCurr, crtRasterPos, framesPerHz, tubePos);
+}
+
+// position along the scan direction, 0 where the beam starts
+float getTubePos(float2 vTexCoord)
+{
+    if (int(param_scanDirection) == 1)
+    {
+        return vTexCoord.y;
+    }
+    if (int(param_scanDirection) == 2)
+    {
+        return 1.0f - vTexCoord.y;
+    }
+    if (int(param_scanDirection) == 3)
+    {
+        return vTexCoord.x;
+    }
+    if (int(param_scanDirection) == 4)
+    {
+        return 1.0f - vTexCoord.x;
+    }
+    return 0.0f;
+}
+
 struct VSIn
 {
     uint vertexId : SV_VertexID;
@@ -327,7 +362,7 @@ PSOut PSmain(PSIn input)
     PSOut output;
     
     // uv: Normalized coordinates ranging from (0,0) at the bottom-left to (1,1) at the top-right.
-    float2 uv = input.vTexCoord;
+    float2 uv = (input.vTexCoord - input_offset) * input_scale;
 
     //-----------------------------------------------------------------------------------------
     // Get CRT simulated version of pixel
@@ -363,40 +398,80 @@ VSOut VSmain(VSIn input)
     }
     
     // precalculate tubePos
-    if (int(param_scanDirection) == 1)
+    tubePos = getTubePos(vTexCoord);
+    
+    output.tubePos = tubePos;
+    output.vTexCoord = vTexCoord;
+    return output;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Compute Shader
+//
+// Same result written straight into the output, used with computeShaders in ShaderBeam.ini
+#if COMPUTE_SHADER == 1
+
+// set by ShaderBeam: output pixels to cover and where inputs sit on the output
+cbuffer Dispatch : register(b2)
+{
+    uint2 dispatch_origin;
+    uint2 dispatch_size;
+    int2 dispatch_inputOrigin;
+    float2 dispatch_outputSize;
+};
+
+RWTexture2D<float4> outputTexture : register(u0);
+
+// inputs map 1:1 onto output pixels so every thread loads its own texels once and keeps them,
+// the group only needs to share whether anything in its tile emits light
+groupshared uint tileEmission;
+
+[numthreads(8, 8, 1)]
+void CSmain(uint3 dispatchThreadId : SV_DispatchThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
     {
-        tubePos = vTexCoord.y;
+        tileEmission = 0;
     }
-    else
+    GroupMemoryBarrierWithGroupSync();
+
+    uint2 pixel = dispatch_origin + dispatchThreadId.xy;
+    bool inside = all(dispatchThreadId.xy < dispatch_size);
+
+    // Load returns 0 outside the texture, same as the border sampler
+    int3 texel = int3(int2(pixel) - dispatch_inputOrigin, 0);
+    float3 pixelPrev2 = float3(0.0, 0.0, 0.0);
+    float3 pixelPrev1 = float3(0.0, 0.0, 0.0);
+    float3 pixelCurr = float3(0.0, 0.0, 0.0);
+    if (inside)
     {
-        if (int(param_scanDirection) == 2)
-        {
-            tubePos = 1.0f - vTexCoord.y;
-        }
-        else
+        pixelPrev2 = srgb2linear(iChannel2.Load(texel).rgb);
+        pixelPrev1 = srgb2linear(iChannel1.Load(texel).rgb);
+        pixelCurr = srgb2linear(iChannel0.Load(texel).rgb);
+        if (any(max(max(pixelPrev2, pixelPrev1), pixelCurr) > 0.0))
         {
-            if (int(param_scanDirection) == 3)
-            {
-                tubePos = vTexCoord.x;
-            }
-            else
-            {
-                if (int(param_scanDirection) == 4)
-                {
-                    tubePos = 1.0f - vTexCoord.x;
-                }
-                else
-                {
-                    tubePos = 0.0f;
-                }
-            }
+            InterlockedOr(tileEmission, 1);
         }
     }
-    
-    output.tubePos = tubePos;
-    output.vTexCoord = vTexCoord;
-    return output;
+    GroupMemoryBarrierWithGroupSync();
+
+    if (!inside)
+    {
+        return;
+    }
+
+    // dark tiles (black bars, dark backgrounds) skip the beam maths, every channel takes simulateCRT's early exit;
+    // encoded the same way as there, linear2srgb(0) is below 0 and only clamps to black on UNORM outputs
+    if (tileEmission == 0)
+    {
+        outputTexture[pixel] = float4(linear2srgb(float3(0.0, 0.0, 0.0)), 1.0);
+        return;
+    }
+
+    float2 vTexCoord = (float2(pixel) + 0.5) / dispatch_outputSize;
+    outputTexture[pixel] = float4(simulateCRT(pixelPrev2, pixelPrev1, pixelCurr, param_crtRasterPos, EFFECTIVE_FRAMES_PER_HZ, getTubePos(vTexCoord)), 1.0);
 }
+#endif
 
 //-------------------------------------------------------------------------------------------------
 // Credits Reminder:
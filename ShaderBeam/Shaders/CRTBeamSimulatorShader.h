@@ -40,6 +40,11 @@ public:
     // derived
     float m_framesPerHz { 4.0f };
 
+    // parameters for every subframe of a beam cycle, 0 when not built yet and -1 if the device can't use one
+    int                m_tableBlocks { 0 };
+    decltype(m_params) m_tableParams;
+    int                m_tableFpsDivisor { 0 };
+
     const std::map<int, std::string> m_scanDirections = {
         { 0, "None (Global Refresh)" }, { 1, "Top to Bottom" }, { 2, "Bottom to Top" }, { 3, "Left to Right" }, { 4, "Right to Left" }
     };
@@ -103,8 +108,23 @@ public:
         };
 
         SetShader(L"Shaders\\CRTBeamSimulator.hlsl", macros, renderContext);
+
+        // compute shaders write the output as is, hardware sRGB has no UAV so doesn't get here
+        D3D_SHADER_MACRO computeMacros[3] = {
+            { "HARDWARE_SRGB", "0" },
+            { "COMPUTE_SHADER", "1" },
+            { NULL, NULL },
+        };
+        SetComputeShader(L"Shaders\\CRTBeamSimulator.hlsl", computeMacros, renderContext);
         SetParameterBuffer(&m_params, sizeof(m_params), renderContext);
         CreatePipeline(renderContext);
+        m_tableBlocks = 0;
+    }
+
+    void Reconfigure(const RenderContext& renderContext)
+    {
+        // subframes changed, everything else is computed per frame
+        m_framesPerHz = (float)renderContext.options.subFrames;
     }
 
     bool NewInputRequired(const RenderContext& renderContext) const
@@ -129,6 +149,12 @@ public:
         return !AntiRetentionRequired(renderContext);
     }
 
+    bool UsesHistory(const RenderContext& renderContext) const
+    {
+        // frame-ahead mode only looks at the newest input
+        return AntiRetentionRequired(renderContext);
+    }
+
     void OverrideInputs(const RenderContext& renderContext, const std::span<ID3D11ShaderResourceView*>& inputs)
     {
         if(!AntiRetentionRequired(renderContext))
@@ -143,7 +169,34 @@ public:
     {
         // linear frame number
         unsigned frameNo = (renderContext.frameNo * renderContext.options.subFrames) + renderContext.subFrameNo;
+        UpdateBeam(renderContext, frameNo);
+
+        // with a whole number of subframes and no anti-retention slew the beam repeats every FPS_DIVISOR CRT frames,
+        // so all of its parameters can sit on the GPU already and only the offset changes per subframe
+        if(!AntiRetentionRequired(renderContext) && floorf(m_framesPerHz) == m_framesPerHz)
+        {
+            if(m_tableBlocks == 0 || (m_tableBlocks > 0 && CycleChanged()))
+                BuildCycleTable(renderContext);
+            if(m_tableBlocks > 0)
+            {
+                SelectParameterBlock((int)(frameNo % m_tableBlocks));
+                RenderPipeline(renderContext);
+                return;
+            }
+        }
+        else if(m_tableBlocks > 0)
+        {
+            ClearParameterTable();
+            m_tableBlocks = 0;
+        }
 
+        UpdateParameters(renderContext);
+        RenderPipeline(renderContext);
+    }
+
+private:
+    void UpdateBeam(const RenderContext& renderContext, unsigned frameNo)
+    {
         //-------------------------------------------------------------------------------------------------
         // CRT beam calculations
         // Frame counter, which may be compensated by slo-mo modes (FPS_DIVISOR). Does not need to be integer divisible.
@@ -165,9 +218,30 @@ public:
 
         // CRT refresh cycle counter
         m_params.crtHzCounter = (float)floor(effectiveFrame / m_params.effectiveFramesPerHz);
+    }
 
-        UpdateParameters(renderContext);
-        RenderPipeline(renderContext);
+    bool CycleChanged() const
+    {
+        return m_tableParams.gamma != m_params.gamma || m_tableParams.gainVsBlur != m_params.gainVsBlur || m_tableParams.scanDirection != m_params.scanDirection ||
+               m_tableParams.effectiveFramesPerHz != m_params.effectiveFramesPerHz || m_tableFpsDivisor != m_fpsDivisor;
+    }
+
+    void BuildCycleTable(const RenderContext& renderContext)
+    {
+        // shader only looks at the counter relative to itself, so one cycle from frame 0 stands in for all of them
+        const auto                      current = m_params;
+        const int                       blocks  = (int)m_framesPerHz * m_fpsDivisor;
+        std::vector<decltype(m_params)> table(blocks);
+        for(int block = 0; block < blocks; block++)
+        {
+            UpdateBeam(renderContext, block);
+            table[block] = m_params;
+        }
+        m_params = current;
+
+        m_tableParams     = m_params;
+        m_tableFpsDivisor = m_fpsDivisor;
+        m_tableBlocks     = SetParameterTable(table.data(), sizeof(m_params), blocks, renderContext) ? blocks : -1;
     }
 };
 } // namespace ShaderBeam
\ No newline at end of file
@@ -0,0 +1,52 @@
+// ShaderBeam: performance charts drawn straight from the sample rings,
+// one column per sample with the value as a bar from the bottom and a cursor after the newest one
+
+#define CHART_SERIES 5
+
+// set by Charts every frame, one entry per series
+cbuffer Charts : register(b0)
+{
+    float4 charts_series[CHART_SERIES]; // min, max, cursor column, unused
+    float2 charts_origin;               // top-left on the output
+    float charts_rowHeight;
+    float charts_brightness;            // scRGB needs more than 1.0 to match SDR white
+};
+
+// sample-major, all series of one column next to each other
+Buffer<float> samples : register(t0);
+
+struct VSOut
+{
+    float4 pos : SV_Position;
+};
+
+VSOut VSmain(uint vertexId : SV_VertexID)
+{
+    // hardcoded triangle covering the target, scissor limits it to the charts
+    VSOut output;
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    output.pos = float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    return output;
+}
+
+float4 PSmain(VSOut input) : SV_Target0
+{
+    float2 local = input.pos.xy - charts_origin;
+    uint column = (uint)local.x;
+    uint series = min((uint)(local.y / charts_rowHeight), CHART_SERIES - 1);
+    float4 range = charts_series[series];
+
+    float3 color;
+    if(column == (uint)range.z)
+    {
+        color = float3(1.0, 0.2, 0.2);
+    }
+    else
+    {
+        float value = samples.Load(column * CHART_SERIES + series);
+        float bar = saturate((value - range.x) / (range.y - range.x)) * charts_rowHeight;
+        float fromBottom = charts_rowHeight - (local.y - series * charts_rowHeight);
+        color = fromBottom <= bar ? float3(0.2, 0.2, 1.0) : float3(1.0, 1.0, 1.0);
+    }
+    return float4(color * charts_brightness, 1.0);
+}
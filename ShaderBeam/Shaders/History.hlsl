@@ -0,0 +1,23 @@
+// ShaderBeam: copies an input frame into compact history storage (also composites the cached UI overlay),
+// format conversion (e.g. to R11G11B10_FLOAT) happens on render target write
+
+Texture2D<float4> source : register(t0);
+
+struct VSOut
+{
+    float4 pos : SV_Position;
+};
+
+VSOut VSmain(uint vertexId : SV_VertexID)
+{
+    // hardcoded triangle covering the target
+    VSOut output;
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    output.pos = float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    return output;
+}
+
+float4 PSmain(VSOut input) : SV_Target0
+{
+    return source.Load(int3(input.pos.xy, 0));
+}
@@ -9,6 +9,7 @@ MIT License
 
 #include "SimpleBFIShader.h"
 #include "CRTBeamSimulatorShader.h"
+#include "SoftBFIShader.h"
 
 namespace ShaderBeam
 {
@@ -16,5 +17,6 @@ namespace ShaderBeam
 static ShaderProfile* s_shaders[] = {
     new CRTBeamSimulatorShader(),
     new SimpleBFIShader(),
+    new SoftBFIShader(),
 };
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+// ShaderBeam: BFI whose dark subframes keep a dim, blurred afterglow of the image instead of black,
+// the blur only depends on the input so it's worked out once per input frame and reused on every subframe
+
+cbuffer Params : register(b0)
+{
+    float param_gamma;
+    float param_afterglow;
+};
+
+// set by ShaderBeam: where input textures sit on the output, maps output uv to input uv
+cbuffer Input : register(b1)
+{
+    float2 input_offset;
+    float2 input_scale;
+};
+
+// set by MultiPassShaderProfile for every pass
+cbuffer Pass : register(b2)
+{
+    float2 pass_targetSize;
+    float2 pass_texelSize;
+    uint pass_subFrameNo;
+    uint pass_subFrames;
+    uint pass_frameNo;
+};
+
+Texture2D<float4> iChannel0 : register(t2);
+Texture2D<float4> iChannel1 : register(t3);
+SamplerState iChannel_sampler : register(s2);
+SamplerState linear_sampler : register(s3);
+
+struct VSOut
+{
+    float4 pos : SV_Position;
+    float2 uv : TEXCOORD0;
+};
+
+VSOut VSmain(uint vertexId : SV_VertexID)
+{
+    // hardcoded triangle covering the target, uv 0..1 across it
+    VSOut output;
+    output.uv = float2((vertexId << 1) & 2, vertexId & 2);
+    output.pos = float4(output.uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    return output;
+}
+
+float3 ToLinear(float3 color)
+{
+#if HARDWARE_SRGB == 1
+    return color;
+#else
+    return pow(max(color, 0.0), param_gamma);
+#endif
+}
+
+float3 FromLinear(float3 color)
+{
+#if HARDWARE_SRGB == 1
+    return color;
+#else
+    return pow(max(color, 0.0), 1.0 / param_gamma);
+#endif
+}
+
+// 9-tap gaussian, applied once horizontally and once vertically
+static const float blurWeights[5] = { 0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162 };
+
+float3 Blur(float2 uv, float2 step)
+{
+    float3 sum = iChannel0.SampleLevel(linear_sampler, uv, 0.0).rgb * blurWeights[0];
+    for (int tap = 1; tap < 5; tap++)
+    {
+        sum += iChannel0.SampleLevel(linear_sampler, uv + step * tap, 0.0).rgb * blurWeights[tap];
+        sum += iChannel0.SampleLevel(linear_sampler, uv - step * tap, 0.0).rgb * blurWeights[tap];
+    }
+    return sum;
+}
+
+// per input: input to linear light at reduced resolution
+float4 PSdownsample(VSOut input) : SV_Target0
+{
+    return float4(ToLinear(iChannel0.SampleLevel(linear_sampler, input.uv, 0.0).rgb), 1.0);
+}
+
+// per input
+float4 PSblurH(VSOut input) : SV_Target0
+{
+    return float4(Blur(input.uv, float2(pass_texelSize.x, 0.0)), 1.0);
+}
+
+// per input
+float4 PSblurV(VSOut input) : SV_Target0
+{
+    return float4(Blur(input.uv, float2(0.0, pass_texelSize.y)), 1.0);
+}
+
+// per subframe: input as is on the first subframe, afterglow on the rest
+float4 PSmain(VSOut input) : SV_Target0
+{
+    float2 uv = (input.uv - input_offset) * input_scale;
+    if (pass_subFrameNo == 0)
+        return float4(iChannel0.SampleLevel(iChannel_sampler, uv, 0.0).rgb, 1.0);
+
+    float3 glow = iChannel1.SampleLevel(linear_sampler, uv, 0.0).rgb * param_afterglow;
+    return float4(FromLinear(glow), 1.0);
+}
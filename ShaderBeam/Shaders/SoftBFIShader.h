@@ -0,0 +1,64 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "MultiPassShaderProfile.h"
+
+namespace ShaderBeam
+{
+
+class SoftBFIShader : public MultiPassShaderProfile
+{
+public:
+    struct
+    {
+        float gamma { 2.2f };
+        float afterglow { 0.1f };
+    } m_params;
+
+    SoftBFIShader()
+    {
+        m_name = "Soft BFI";
+        AddParameter("Gamma", "Your display's gamma value, the afterglow is blended in linear light.", &m_params.gamma, 0.5f, 5.0f);
+        AddParameter("Afterglow",
+                     "Brightness of the blurred image shown on dark subframes.\n"
+                     "- 0.0 is plain BFI.\n"
+                     "- Higher values reduce flicker at the cost of some motion clarity.",
+                     &m_params.afterglow,
+                     0.0f,
+                     0.5f);
+    }
+
+    void Create(const RenderContext& renderContext)
+    {
+        D3D_SHADER_MACRO macros[2] = {
+            { "HARDWARE_SRGB", renderContext.options.hardwareSrgb ? "1" : "0" },
+            { NULL, NULL },
+        };
+
+        // glow is blurred at half resolution, the first intermediate shares memory with the result
+        const auto linear = AddTarget(DXGI_FORMAT_R16G16B16A16_FLOAT, 2);
+        const auto blurH  = AddTarget(DXGI_FORMAT_R16G16B16A16_FLOAT, 2);
+        const auto glow   = AddTarget(DXGI_FORMAT_R16G16B16A16_FLOAT, 2);
+
+        AddPass(L"Shaders\\SoftBFI.hlsl", macros, "PSdownsample", { PassSource(0) }, linear, PASS_PER_INPUT, renderContext);
+        AddPass(L"Shaders\\SoftBFI.hlsl", macros, "PSblurH", { linear }, blurH, PASS_PER_INPUT, renderContext);
+        AddPass(L"Shaders\\SoftBFI.hlsl", macros, "PSblurV", { blurH }, glow, PASS_PER_INPUT, renderContext);
+        AddPass(L"Shaders\\SoftBFI.hlsl", macros, "PSmain", { PassSource(0), glow }, PASS_OUTPUT, PASS_PER_SUBFRAME, renderContext);
+
+        SetParameterBuffer(&m_params, sizeof(m_params), renderContext);
+        CreatePipeline(renderContext);
+    }
+
+    void Render(const RenderContext& renderContext)
+    {
+        UpdateParameters(renderContext);
+        RenderPipeline(renderContext);
+    }
+};
+} // namespace ShaderBeam
@@ -0,0 +1,54 @@
+// ShaderBeam: hashes captured frames in 64x64 tiles on the GPU so identical frames can be dropped without reading them back,
+// one group per tile with every thread hashing an 8x8 block, same tile grid as TileHasher
+
+#define HASH_TILE_SIZE 64
+#define HASH_BLOCK     8
+
+Texture2D<float4> source : register(t0);
+
+// two 32-bit halves per tile, row-major
+RWStructuredBuffer<uint2> hashes : register(u0);
+
+groupshared uint2 tileHash;
+
+uint Mix(uint h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+[numthreads(HASH_TILE_SIZE / HASH_BLOCK, HASH_TILE_SIZE / HASH_BLOCK, 1)]
+void CSmain(uint3 groupId : SV_GroupID, uint3 threadId : SV_GroupThreadID, uint threadIndex : SV_GroupIndex)
+{
+    uint width, height;
+    source.GetDimensions(width, height);
+
+    if(threadIndex == 0)
+        tileHash = uint2(0, 0);
+    GroupMemoryBarrierWithGroupSync();
+
+    // seeded by position so blocks swapping places still change the sum
+    uint2 origin = groupId.xy * HASH_TILE_SIZE + threadId.xy * HASH_BLOCK;
+    uint2 h      = uint2(Mix(threadIndex + 1), Mix(threadIndex + 0x9e3779b9));
+    for(uint y = origin.y; y < min(origin.y + HASH_BLOCK, height); y++)
+    {
+        for(uint x = origin.x; x < min(origin.x + HASH_BLOCK, width); x++)
+        {
+            uint4 bits = asuint(source.Load(int3(x, y, 0)));
+            h.x        = Mix(h.x ^ bits.x ^ Mix(bits.y));
+            h.y        = Mix(h.y ^ bits.z ^ Mix(bits.w + h.x));
+        }
+    }
+
+    // order doesn't matter for a sum, threads are told apart by their seeds
+    InterlockedAdd(tileHash.x, h.x);
+    InterlockedAdd(tileHash.y, h.y);
+    GroupMemoryBarrierWithGroupSync();
+
+    if(threadIndex == 0)
+        hashes[groupId.y * ((width + HASH_TILE_SIZE - 1) / HASH_TILE_SIZE) + groupId.x] = tileHash;
+}
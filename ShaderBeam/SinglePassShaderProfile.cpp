@@ -13,43 +13,37 @@ MIT License
 namespace ShaderBeam
 {
 
+// constant buffer offsets and sizes are in 16-byte constants and have to be multiples of 16 of them
+#define PARAMETER_BLOCK_CONSTANTS 16
+#define PARAMETER_BLOCK_BYTES     (PARAMETER_BLOCK_CONSTANTS * 16)
+
+// matches numthreads of CSmain
+#define COMPUTE_TILE 8
+
 void SinglePassShaderProfile::SetShader(const wchar_t* filename, D3D10_SHADER_MACRO* macros, const RenderContext& renderContext)
 {
-    ID3DBlob* vertexBlob = nullptr;
-    ID3DBlob* pixelBlob  = nullptr;
-    ID3DBlob* errorBlob  = nullptr;
-    UINT      flags      = D3DCOMPILE_OPTIMIZATION_LEVEL3 | D3DCOMPILE_ENABLE_STRICTNESS;
-    HRESULT   hr;
-
-    hr = D3DCompileFromFile(filename, macros, D3D_COMPILE_STANDARD_FILE_INCLUDE, "VSmain", "vs_5_0", flags, 0, &vertexBlob, &errorBlob);
-    if(FAILED(hr))
-    {
-        char* msg = NULL;
-        if(errorBlob)
-        {
-            msg = (char*)errorBlob->GetBufferPointer();
-            OutputDebugStringA(msg);
-        }
-        throw std::runtime_error("Unable to compile vertex shader:\n" + Helpers::WCharToString(filename) + "\n" + (msg ? msg : ""));
-    }
-    THROW(renderContext.device->CreateVertexShader(vertexBlob->GetBufferPointer(), vertexBlob->GetBufferSize(), NULL, m_vertexShader.put()), "Unable to create vertex shader");
+    auto vertexCode = Helpers::CompileShader(filename, macros, "VSmain", "vs_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreateVertexShader(vertexCode.data(), vertexCode.size(), NULL, m_vertexShader.put()), "Unable to create vertex shader");
 
-    hr = D3DCompileFromFile(filename, macros, D3D_COMPILE_STANDARD_FILE_INCLUDE, "PSmain", "ps_5_0", flags, 0, &pixelBlob, &errorBlob);
-    if(FAILED(hr))
-    {
-        char* msg = NULL;
-        if(errorBlob)
-        {
-            msg = (char*)errorBlob->GetBufferPointer();
-            OutputDebugStringA(msg);
-        }
-        throw std::runtime_error("Unable to compile pixel shader from\n" + Helpers::WCharToString(filename) + "\n" + (msg ? msg : ""));
-    }
+    auto pixelCode = Helpers::CompileShader(filename, macros, "PSmain", "ps_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreatePixelShader(pixelCode.data(), pixelCode.size(), NULL, m_pixelShader.put()), "Unable to create pixel shader");
+}
 
-    THROW(renderContext.device->CreatePixelShader(pixelBlob->GetBufferPointer(), pixelBlob->GetBufferSize(), NULL, m_pixelShader.put()), "Unable to create pixel shader");
+void SinglePassShaderProfile::SetComputeShader(const wchar_t* filename, D3D10_SHADER_MACRO* macros, const RenderContext& renderContext)
+{
+    // only when the output can take it, otherwise not worth compiling
+    if(!renderContext.outputUnorderedView)
+        return;
 
-    vertexBlob->Release();
-    pixelBlob->Release();
+    auto computeCode = Helpers::CompileShader(filename, macros, "CSmain", "cs_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreateComputeShader(computeCode.data(), computeCode.size(), NULL, m_computeShader.put()), "Unable to create compute shader");
+
+    D3D11_BUFFER_DESC dispatchDesc {};
+    dispatchDesc.ByteWidth = sizeof(DispatchConstants);
+    dispatchDesc.Usage     = D3D11_USAGE_DEFAULT;
+    dispatchDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    THROW(renderContext.device->CreateBuffer(&dispatchDesc, nullptr, m_dispatchBuffer.put()), "Unable to create dispatch buffer");
+    m_dispatch = {};
 }
 
 void SinglePassShaderProfile::SetParameterBuffer(void* data, int size, const RenderContext& renderContext)
@@ -63,6 +57,42 @@ void SinglePassShaderProfile::SetParameterBuffer(void* data, int size, const Ren
     constantBufferDesc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
     constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     THROW(renderContext.device->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.put()), "Unable to create constant buffer");
+
+    D3D11_FEATURE_DATA_D3D11_OPTIONS features {};
+    if(SUCCEEDED(renderContext.device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &features, sizeof(features))) && features.ConstantBufferOffsetting)
+        m_deviceContext1 = renderContext.deviceContext.try_as<ID3D11DeviceContext1>();
+}
+
+bool SinglePassShaderProfile::SetParameterTable(const void* blocks, int blockSize, int numBlocks, const RenderContext& renderContext)
+{
+    ClearParameterTable();
+    if(!m_deviceContext1 || blockSize > PARAMETER_BLOCK_BYTES || numBlocks <= 0)
+        return false;
+
+    std::vector<uint8_t> table((size_t)numBlocks * PARAMETER_BLOCK_BYTES);
+    for(int block = 0; block < numBlocks; block++)
+        memcpy(table.data() + (size_t)block * PARAMETER_BLOCK_BYTES, (const uint8_t*)blocks + (size_t)block * blockSize, blockSize);
+
+    D3D11_BUFFER_DESC tableDesc {};
+    tableDesc.ByteWidth = (UINT)table.size();
+    tableDesc.Usage     = D3D11_USAGE_IMMUTABLE;
+    tableDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+
+    D3D11_SUBRESOURCE_DATA tableData {};
+    tableData.pSysMem = table.data();
+    THROW(renderContext.device->CreateBuffer(&tableDesc, &tableData, m_parameterTable.put()), "Unable to create parameter table");
+    return true;
+}
+
+void SinglePassShaderProfile::SelectParameterBlock(int block)
+{
+    m_parameterBlock = block;
+}
+
+void SinglePassShaderProfile::ClearParameterTable()
+{
+    m_parameterTable = nullptr;
+    m_parameterBlock = -1;
 }
 
 void SinglePassShaderProfile::CreatePipeline(const RenderContext& renderContext)
@@ -80,24 +110,61 @@ void SinglePassShaderProfile::CreatePipeline(const RenderContext& renderContext)
     renderContext.device->CreateSamplerState(&samplerDesc, m_samplerState.put());
 }
 
+void SinglePassShaderProfile::BindParameters(const RenderContext& renderContext, bool compute)
+{
+    if(m_parameterTable && m_parameterBlock >= 0)
+    {
+        ID3D11Buffer* table[1]  = { m_parameterTable.get() };
+        UINT          first[1]  = { (UINT)m_parameterBlock * PARAMETER_BLOCK_CONSTANTS };
+        UINT          number[1] = { PARAMETER_BLOCK_CONSTANTS };
+        if(compute)
+        {
+            m_deviceContext1->CSSetConstantBuffers1(0, 1, table, first, number);
+        }
+        else
+        {
+            m_deviceContext1->VSSetConstantBuffers1(0, 1, table, first, number);
+            m_deviceContext1->PSSetConstantBuffers1(0, 1, table, first, number);
+        }
+    }
+    else
+    {
+        ID3D11Buffer* buffer[1] = { m_constantBuffer.get() };
+        if(compute)
+        {
+            renderContext.deviceContext->CSSetConstantBuffers(0, 1, buffer);
+        }
+        else
+        {
+            renderContext.deviceContext->VSSetConstantBuffers(0, 1, buffer);
+            renderContext.deviceContext->PSSetConstantBuffers(0, 1, buffer);
+        }
+    }
+}
+
 void SinglePassShaderProfile::RenderPipeline(const RenderContext& renderContext)
 {
+    if(m_computeShader && renderContext.outputUnorderedView)
+    {
+        RenderCompute(renderContext);
+        return;
+    }
+
     renderContext.deviceContext->VSSetShader(m_vertexShader.get(), NULL, 0);
     renderContext.deviceContext->PSSetShader(m_pixelShader.get(), NULL, 0);
 
     renderContext.deviceContext->IASetInputLayout(NULL);
     renderContext.deviceContext->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    ID3D11Buffer* buffer[1] = { m_constantBuffer.get() };
-    renderContext.deviceContext->VSSetConstantBuffers(0, 1, buffer);
-    renderContext.deviceContext->PSSetConstantBuffers(0, 1, buffer);
+    BindParameters(renderContext, false);
 
+    const int                 numInputs = min((int)renderContext.NumInputs(), m_numInputs); // ring may be deeper for other profiles
     ID3D11ShaderResourceView* shaderInputs[MAX_INPUTS];
-    for(int slot = 0; slot < renderContext.inputSlots.size(); slot++)
-        shaderInputs[slot] = renderContext.inputTextureViews[renderContext.inputSlots[slot]].get();
-    OverrideInputs(renderContext, std::span<ID3D11ShaderResourceView*>(shaderInputs, renderContext.inputSlots.size()));
+    for(int slot = 0; slot < numInputs; slot++)
+        shaderInputs[slot] = renderContext.GetInputView(slot);
+    OverrideInputs(renderContext, std::span<ID3D11ShaderResourceView*>(shaderInputs, numInputs));
 
-    renderContext.deviceContext->PSSetShaderResources(2, (UINT)renderContext.inputSlots.size(), shaderInputs);
+    renderContext.deviceContext->PSSetShaderResources(2, (UINT)numInputs, shaderInputs);
 
     ID3D11SamplerState* samplers[1] = { m_samplerState.get() };
     renderContext.deviceContext->PSSetSamplers(2, 1, samplers);
@@ -115,6 +182,69 @@ void SinglePassShaderProfile::RenderPipeline(const RenderContext& renderContext)
     renderContext.deviceContext->PSSetSamplers(2, 1, nulls);
 }
 
+void SinglePassShaderProfile::RenderCompute(const RenderContext& renderContext)
+{
+    // cover what the pixel shader would, i.e. the scissor Renderer set up
+    UINT       numScissors = 1;
+    D3D11_RECT scissor {};
+    renderContext.deviceContext->RSGetScissorRects(&numScissors, &scissor);
+    scissor.left = max(scissor.left, 0);
+    scissor.top  = max(scissor.top, 0);
+    if(scissor.right <= scissor.left || scissor.bottom <= scissor.top)
+        return;
+
+    const auto&       options = renderContext.options;
+    DispatchConstants dispatch {};
+    dispatch.originX      = (UINT)scissor.left;
+    dispatch.originY      = (UINT)scissor.top;
+    dispatch.width        = (UINT)(scissor.right - scissor.left);
+    dispatch.height       = (UINT)(scissor.bottom - scissor.top);
+    dispatch.inputX       = options.inputX;
+    dispatch.inputY       = options.inputY;
+    dispatch.outputWidth  = (float)options.outputWidth;
+    dispatch.outputHeight = (float)options.outputHeight;
+    if(memcmp(&dispatch, &m_dispatch, sizeof(dispatch)) != 0)
+    {
+        m_dispatch = dispatch;
+        renderContext.deviceContext->UpdateSubresource(m_dispatchBuffer.get(), 0, nullptr, &m_dispatch, 0, 0);
+    }
+
+    // output can't be bound as a render target and a UAV at the same time
+    ID3D11RenderTargetView* nullt[1] = { nullptr };
+    renderContext.deviceContext->OMSetRenderTargets(1, nullt, NULL);
+
+    renderContext.deviceContext->CSSetShader(m_computeShader.get(), NULL, 0);
+    BindParameters(renderContext, true);
+    ID3D11Buffer* dispatchBuffer[1] = { m_dispatchBuffer.get() };
+    renderContext.deviceContext->CSSetConstantBuffers(2, 1, dispatchBuffer);
+
+    const int                 numInputs = min((int)renderContext.NumInputs(), m_numInputs);
+    ID3D11ShaderResourceView* shaderInputs[MAX_INPUTS];
+    for(int slot = 0; slot < numInputs; slot++)
+        shaderInputs[slot] = renderContext.GetInputView(slot);
+    OverrideInputs(renderContext, std::span<ID3D11ShaderResourceView*>(shaderInputs, numInputs));
+    renderContext.deviceContext->CSSetShaderResources(2, (UINT)numInputs, shaderInputs);
+
+    ID3D11UnorderedAccessView* outputs[1] = { renderContext.outputUnorderedView.get() };
+    renderContext.deviceContext->CSSetUnorderedAccessViews(0, 1, outputs, nullptr);
+
+    renderContext.deviceContext->Dispatch((m_dispatch.width + COMPUTE_TILE - 1) / COMPUTE_TILE, (m_dispatch.height + COMPUTE_TILE - 1) / COMPUTE_TILE, 1);
+
+    ID3D11UnorderedAccessView* nullu[1] = { nullptr };
+    renderContext.deviceContext->CSSetUnorderedAccessViews(0, 1, nullu, nullptr);
+
+    ID3D11ShaderResourceView* nullv[MAX_INPUTS] = {};
+    renderContext.deviceContext->CSSetShaderResources(2, (UINT)numInputs, nullv);
+
+    ID3D11Buffer* nullb[3] = { nullptr, nullptr, nullptr };
+    renderContext.deviceContext->CSSetConstantBuffers(0, 3, nullb);
+    renderContext.deviceContext->CSSetShader(NULL, NULL, 0);
+
+    // rest of the frame (split screen, charts, UI) draws on top as usual
+    ID3D11RenderTargetView* targets[1] = { renderContext.outputTargetView.get() };
+    renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
+}
+
 void SinglePassShaderProfile::UpdateParameters(const RenderContext& renderContext)
 {
     D3D11_MAPPED_SUBRESOURCE mappedSubresource;
@@ -127,6 +257,10 @@ void SinglePassShaderProfile::OverrideInputs(const RenderContext& renderContext,
 
 void SinglePassShaderProfile::Destroy()
 {
+    ClearParameterTable();
+    m_dispatchBuffer = nullptr;
+    m_computeShader  = nullptr;
+    m_deviceContext1 = nullptr;
     m_constantBuffer = nullptr;
     m_samplerState   = nullptr;
     m_pixelShader    = nullptr;
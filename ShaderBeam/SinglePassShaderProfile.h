@@ -19,14 +19,36 @@ public:
 
 protected:
     void SetShader(const wchar_t* filename, D3D10_SHADER_MACRO* macros, const RenderContext& renderContext);
+
+    // CSmain writing the output through a UAV, RenderPipeline uses it instead when computeShaders got one set up
+    void SetComputeShader(const wchar_t* filename, D3D10_SHADER_MACRO* macros, const RenderContext& renderContext);
     void SetParameterBuffer(void* data, int size, const RenderContext& renderContext);
     void CreatePipeline(const RenderContext& renderContext);
     void RenderPipeline(const RenderContext& renderContext);
     void UpdateParameters(const RenderContext& renderContext);
 
+    // parameter blocks for a repeating cycle of subframes, uploaded once and picked by offset instead of per subframe;
+    // returns false if the device can't bind constant buffers at an offset, UpdateParameters is needed then
+    bool SetParameterTable(const void* blocks, int blockSize, int numBlocks, const RenderContext& renderContext);
+    void SelectParameterBlock(int block);
+    void ClearParameterTable();
+
     virtual void OverrideInputs(const RenderContext& renderContext, const std::span<ID3D11ShaderResourceView*>& inputs);
 
 private:
+    // output pixels a compute dispatch covers, b2 in the shader
+    struct DispatchConstants
+    {
+        UINT  originX;
+        UINT  originY;
+        UINT  width;
+        UINT  height;
+        INT   inputX;
+        INT   inputY;
+        float outputWidth;
+        float outputHeight;
+    };
+
     void* m_parametersBuffer { nullptr };
     int   m_parametersSize { 0 };
 
@@ -34,5 +56,16 @@ private:
     winrt::com_ptr<ID3D11PixelShader>  m_pixelShader;
     winrt::com_ptr<ID3D11SamplerState> m_samplerState;
     winrt::com_ptr<ID3D11Buffer>       m_constantBuffer;
+
+    winrt::com_ptr<ID3D11DeviceContext1> m_deviceContext1; // only with constant buffer offsetting
+    winrt::com_ptr<ID3D11Buffer>         m_parameterTable;
+    int                                  m_parameterBlock { -1 };
+
+    winrt::com_ptr<ID3D11ComputeShader> m_computeShader;
+    winrt::com_ptr<ID3D11Buffer>        m_dispatchBuffer;
+    DispatchConstants                   m_dispatch {};
+
+    void BindParameters(const RenderContext& renderContext, bool compute);
+    void RenderCompute(const RenderContext& renderContext);
 };
 } // namespace ShaderBeam
\ No newline at end of file
@@ -0,0 +1,265 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "TestPattern.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ShaderBeam
+{
+
+// rows per worker task
+static constexpr unsigned TEST_BAND_ROWS = 32;
+
+// horizontal repeat of each pattern in pixels, scrolling wraps on it
+static constexpr int UFO_PERIOD  = 384;
+static constexpr int BARS_PERIOD = 64;
+
+static const char TEXT_MESSAGE[] = "SHADERBEAM MOTION TEST 0123456789 ";
+
+// 5x7 glyphs, one row per byte with bit 4 on the left, for the characters in TEXT_MESSAGE
+static const uint8_t FONT_DIGITS[10][7] = {
+    { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e }, { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e }, { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f },
+    { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e }, { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 }, { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e },
+    { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e }, { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e },
+    { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c }
+};
+
+static const uint8_t FONT_LETTERS[26][7] = {
+    { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e }, { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e },
+    { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c }, { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f }, { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 },
+    { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f }, { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e },
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c }, { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f },
+    { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 }, { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },
+    { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 }, { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d }, { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 },
+    { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e }, { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 }, { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a }, { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 },
+    { 0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04 }, { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f }
+};
+
+static bool GlyphPixel(char c, int column, int row)
+{
+    if(column < 0 || column >= 5 || row < 0 || row >= 7)
+        return false;
+    const uint8_t* glyph = nullptr;
+    if(c >= '0' && c <= '9')
+        glyph = FONT_DIGITS[c - '0'];
+    else if(c >= 'A' && c <= 'Z')
+        glyph = FONT_LETTERS[c - 'A'];
+    return glyph && (glyph[row] >> (4 - column)) & 1;
+}
+
+static uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign     = (bits >> 16) & 0x8000;
+    const int      exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    const uint32_t mantissa = bits & 0x7fffff;
+    if(exponent <= 0)
+        return (uint16_t)sign; // too small for a normal half, nothing we draw gets here
+    if(exponent >= 31)
+        return (uint16_t)(sign | 0x7c00);
+    return (uint16_t)(sign | ((exponent << 10) + ((mantissa + 0x1000) >> 13))); // rounding may carry into exponent, still correct
+}
+
+// cheap per-pixel hash for a static starfield, so the background is the same every frame
+static uint32_t HashPixel(int x, int y)
+{
+    uint32_t h = (uint32_t)x * 0x8da6b343u ^ (uint32_t)y * 0xd8163841u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    return h ^ (h >> 15);
+}
+
+static int Wrap(int64_t value, int period)
+{
+    auto wrapped = (int)(value % period);
+    return wrapped < 0 ? wrapped + period : wrapped;
+}
+
+TestPattern::TestPattern(WorkerPool& pool) : m_pool(pool) { }
+
+void TestPattern::Reset(unsigned width, unsigned height, unsigned bytesPerPixel, int pattern, float speed)
+{
+    m_width         = width;
+    m_height        = height;
+    m_bytesPerPixel = bytesPerPixel;
+    m_pattern       = std::clamp(pattern, TEST_PATTERN_UFO, TEST_PATTERN_TEXT);
+    m_speed         = speed;
+    m_frame.assign((size_t)width * height * bytesPerPixel, 0);
+
+    // HDR output is scRGB, so patterns keep their SDR look at 80 nits
+    for(int i = 0; i < 256; i++)
+    {
+        float srgb   = i / 255.0f;
+        float linear = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+        m_halfLut[i] = FloatToHalf(linear);
+    }
+}
+
+void TestPattern::Render(uint32_t serial, double time)
+{
+    if(m_frame.empty())
+        return;
+
+    const unsigned numBands = (m_height + TEST_BAND_ROWS - 1) / TEST_BAND_ROWS;
+    m_pool.Run(numBands, [&](unsigned band) {
+        const unsigned firstRow = band * TEST_BAND_ROWS;
+        RenderRows(firstRow, std::min(TEST_BAND_ROWS, m_height - firstRow), serial, time);
+    });
+}
+
+const uint8_t* TestPattern::GetData() const
+{
+    return m_frame.data();
+}
+
+size_t TestPattern::GetPitch() const
+{
+    return (size_t)m_width * m_bytesPerPixel;
+}
+
+uint32_t TestPattern::ReadSerial(const uint8_t* data, size_t pitch, unsigned bytesPerPixel)
+{
+    // sample green in the middle of each block
+    uint32_t serial = 0;
+    auto     row    = data + (TEST_SERIAL_BLOCK / 2) * pitch;
+    for(unsigned bit = 0; bit < TEST_SERIAL_BITS; bit++)
+    {
+        auto pixel = row + (bit * TEST_SERIAL_BLOCK + TEST_SERIAL_BLOCK / 2) * bytesPerPixel;
+        bool set;
+        if(bytesPerPixel == 8)
+        {
+            uint16_t green;
+            memcpy(&green, pixel + 2, sizeof(green));
+            set = green > 0x3800; // 0.5
+        }
+        else
+        {
+            set = pixel[1] > 127;
+        }
+        if(set)
+            serial |= 1u << bit;
+    }
+    return serial;
+}
+
+void TestPattern::RenderRows(unsigned firstRow, unsigned numRows, uint32_t serial, double time)
+{
+    // whole pixels only, like TestUFO, so every frame moves by the same step
+    const auto offset = (int64_t)std::floor(time * m_speed);
+    for(unsigned y = firstRow; y < firstRow + numRows; y++)
+    {
+        auto row = m_frame.data() + (size_t)y * GetPitch();
+        for(unsigned x = 0; x < m_width; x++)
+        {
+            uint32_t color = Shade((int)x, (int)y, offset);
+            if(y < TEST_SERIAL_BLOCK && x < TEST_SERIAL_BITS * TEST_SERIAL_BLOCK)
+                color = (serial >> (x / TEST_SERIAL_BLOCK)) & 1 ? 0xffffff : 0x000000;
+            Store(row + x * m_bytesPerPixel, color);
+        }
+    }
+}
+
+uint32_t TestPattern::Shade(int x, int y, int64_t offset) const
+{
+    switch(m_pattern)
+    {
+    case TEST_PATTERN_BARS:
+        return ShadeBars(x, y, offset);
+    case TEST_PATTERN_TEXT:
+        return ShadeText(x, y, offset);
+    default:
+        return ShadeUfo(x, y, offset);
+    }
+}
+
+uint32_t TestPattern::ShadeUfo(int x, int y, int64_t offset) const
+{
+    // three lanes with a UFO flying through each, over a static starfield
+    static const uint32_t laneColors[3] = { 0x101830, 0x303030, 0x506080 };
+    const int             laneHeight    = std::max((int)m_height / 3, 1);
+    const int             lane          = std::min(y / laneHeight, 2);
+    const int             size          = std::min(laneHeight / 2, UFO_PERIOD / 2);
+
+    const float u  = (float)(Wrap(x - offset, UFO_PERIOD) - UFO_PERIOD / 2);
+    const float v  = (float)(y - lane * laneHeight - laneHeight / 2);
+    const float rx = size * 0.5f;
+    const float ry = size * 0.16f;
+
+    // dome on top of a saucer, with a row of lights along the rim
+    if(v < 0 && u * u + v * v < (rx * 0.45f) * (rx * 0.45f))
+        return 0x60d0f0;
+    if((u * u) / (rx * rx) + (v * v) / (ry * ry) < 1.0f)
+    {
+        const float light = std::fmod(u + rx * 2.0f, rx * 0.4f) - rx * 0.2f;
+        if(v > 0 && v < ry * 0.6f && light * light + (v - ry * 0.3f) * (v - ry * 0.3f) < ry * ry * 0.09f)
+            return 0xffe040;
+        return 0xb0b0b0;
+    }
+
+    if((HashPixel(x, y) & 0x3ff) == 0)
+        return 0xffffff;
+    return laneColors[lane];
+}
+
+uint32_t TestPattern::ShadeBars(int x, int y, int64_t offset) const
+{
+    // wide bars, thin bars and a checkerboard, all moving together
+    const int laneHeight = std::max((int)m_height / 3, 1);
+    const int lane       = std::min(y / laneHeight, 2);
+    const int u          = Wrap(x - offset, BARS_PERIOD);
+    bool      white;
+    switch(lane)
+    {
+    case 0:
+        white = u < BARS_PERIOD / 2;
+        break;
+    case 1:
+        white = (u / 8) & 1;
+        break;
+    default:
+        white = ((u / (BARS_PERIOD / 2)) ^ (y / (BARS_PERIOD / 2))) & 1;
+        break;
+    }
+    return white ? 0xffffff : 0x000000;
+}
+
+uint32_t TestPattern::ShadeText(int x, int y, int64_t offset) const
+{
+    // three lines of scrolling text, blur shows up as unreadable letters
+    const int laneHeight = std::max((int)m_height / 3, 1);
+    const int lane       = std::min(y / laneHeight, 2);
+    const int scale      = std::max(laneHeight / 24, 1);
+    const int cell       = 6 * scale;
+    const int length     = (int)sizeof(TEXT_MESSAGE) - 1;
+
+    const int u   = Wrap(x - offset + lane * cell * 7, cell * length);
+    const int row = (y - lane * laneHeight - (laneHeight - 7 * scale) / 2) / scale;
+    if(GlyphPixel(TEXT_MESSAGE[u / cell], (u % cell) / scale, row))
+        return 0xffffff;
+    return 0x202020;
+}
+
+void TestPattern::Store(uint8_t* pixel, uint32_t color) const
+{
+    if(m_bytesPerPixel == 8)
+    {
+        const uint16_t rgba[4] = { m_halfLut[(color >> 16) & 0xff], m_halfLut[(color >> 8) & 0xff], m_halfLut[color & 0xff], 0x3c00 };
+        memcpy(pixel, rgba, sizeof(rgba));
+    }
+    else
+    {
+        const uint32_t bgra = color | 0xff000000;
+        memcpy(pixel, &bgra, sizeof(bgra));
+    }
+}
+
+} // namespace ShaderBeam
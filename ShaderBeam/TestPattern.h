@@ -0,0 +1,64 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "WorkerPool.h"
+
+namespace ShaderBeam
+{
+
+constexpr int TEST_PATTERN_UFO  = 0;
+constexpr int TEST_PATTERN_BARS = 1;
+constexpr int TEST_PATTERN_TEXT = 2;
+
+// serial number is stamped top-left as 32 blocks, white = 1, least significant first
+constexpr unsigned TEST_SERIAL_BITS  = 32;
+constexpr unsigned TEST_SERIAL_BLOCK = 8;
+
+// TestUFO-style motion patterns rendered on the CPU in bands across the worker pool
+class TestPattern
+{
+public:
+    explicit TestPattern(WorkerPool& pool);
+
+    // bytesPerPixel 4 renders BGRA8, 8 renders RGBA16F (scRGB)
+    void Reset(unsigned width, unsigned height, unsigned bytesPerPixel, int pattern, float speed);
+
+    // draws the scene as it looks at time (seconds), speed is in pixels per second
+    void Render(uint32_t serial, double time);
+
+    const uint8_t* GetData() const;
+    size_t         GetPitch() const;
+
+    // decodes serial from a frame in the same format, e.g. to verify what reached the output
+    static uint32_t ReadSerial(const uint8_t* data, size_t pitch, unsigned bytesPerPixel);
+
+private:
+    WorkerPool&          m_pool;
+    unsigned             m_width { 0 };
+    unsigned             m_height { 0 };
+    unsigned             m_bytesPerPixel { 4 };
+    int                  m_pattern { TEST_PATTERN_UFO };
+    float                m_speed { 0 };
+    std::vector<uint8_t> m_frame;
+    uint16_t             m_halfLut[256] {}; // sRGB 8-bit to linear half
+
+    void     RenderRows(unsigned firstRow, unsigned numRows, uint32_t serial, double time);
+    uint32_t Shade(int x, int y, int64_t offset) const;
+    uint32_t ShadeUfo(int x, int y, int64_t offset) const;
+    uint32_t ShadeBars(int x, int y, int64_t offset) const;
+    uint32_t ShadeText(int x, int y, int64_t offset) const;
+    void     Store(uint8_t* pixel, uint32_t color) const;
+};
+} // namespace ShaderBeam
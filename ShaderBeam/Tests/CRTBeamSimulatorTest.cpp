@@ -0,0 +1,315 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// Shaders/CRTBeamSimulator.hlsl emulated on the CPU: the compute path (8x8 groups, dark tile early-out, Load)
+// against the pixel shader path (full-screen triangle, point sampler with black border) on the same inputs.
+// Float results are compared before the store, so they hold for UNORM and FP16 outputs alike.
+// Keep the functions below in step with the shader when it changes.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+
+namespace
+{
+
+// compute path group size, numthreads of CSmain
+constexpr int COMPUTE_TILE = 8;
+
+struct Params
+{
+    float gamma;
+    float gainVsBlur;
+    int   scanDirection;
+    float effectiveFramesPerHz;
+    float crtRasterPos;
+};
+
+struct Pixel
+{
+    float c[3];
+};
+
+// HLSL clamp(x, lo, hi) is min(max(x, lo), hi), the shader relies on it with lo > hi
+float Clamp(float x, float lo, float hi)
+{
+    return std::min(std::max(x, lo), hi);
+}
+
+float Linear2Srgb(float c, const Params& params)
+{
+    return Clamp(0.0031308f * 12.92f, c * 12.92f, std::pow(c, 1.0f / params.gamma) * 1.055f + -0.055f);
+}
+
+float Srgb2Linear(float c, const Params& params)
+{
+    return c > 0.04045f ? std::pow(c * (1.0f / 1.055f) + 0.055f / 1.055f, params.gamma) : c * (1.0f / 12.92f);
+}
+
+Pixel Srgb2Linear(const Pixel& pixel, const Params& params)
+{
+    return { { Srgb2Linear(pixel.c[0], params), Srgb2Linear(pixel.c[1], params), Srgb2Linear(pixel.c[2], params) } };
+}
+
+float IntervalOverlap(float aStart, float aEnd, float bStart, float bEnd)
+{
+    return std::max(0.0f, std::min(aEnd, bEnd) - std::max(aStart, bStart));
+}
+
+Pixel SimulateCRT(const Pixel& prev2, const Pixel& prev1, const Pixel& curr, const Params& params, float tubePos)
+{
+    const float framesPerHz     = params.effectiveFramesPerHz;
+    const float brightnessScale = framesPerHz * params.gainVsBlur;
+
+    Pixel result {};
+    for(int ch = 0; ch < 3; ch++)
+    {
+        const float lPrev2 = prev2.c[ch] * brightnessScale;
+        const float lPrev1 = prev1.c[ch] * brightnessScale;
+        const float lCurr  = curr.c[ch] * brightnessScale;
+        if(lPrev2 <= 0.0f && lPrev1 <= 0.0f && lCurr <= 0.0f)
+        {
+            result.c[ch] = 0.0f;
+            continue;
+        }
+
+        const float tubeFrame  = tubePos * framesPerHz;
+        const float fStart     = params.crtRasterPos * framesPerHz;
+        const float fEnd       = fStart + 1.0f;
+        const float startPrev2 = tubeFrame - framesPerHz;
+        const float startPrev1 = tubeFrame;
+        const float startCurr  = tubeFrame + framesPerHz;
+        result.c[ch] = IntervalOverlap(startPrev2, startPrev2 + lPrev2, fStart, fEnd) + IntervalOverlap(startPrev1, startPrev1 + lPrev1, fStart, fEnd) +
+                       IntervalOverlap(startCurr, startCurr + lCurr, fStart, fEnd);
+    }
+
+    for(auto& c : result.c)
+        c = Linear2Srgb(c, params);
+    return result;
+}
+
+float GetTubePos(float u, float v, const Params& params)
+{
+    switch(params.scanDirection)
+    {
+    case 1:
+        return v;
+    case 2:
+        return 1.0f - v;
+    case 3:
+        return u;
+    case 4:
+        return 1.0f - u;
+    }
+    return 0.0f;
+}
+
+// three trailing inputs, newest first like iChannel0..2
+struct Inputs
+{
+    int                width;
+    int                height;
+    std::vector<Pixel> frames[3];
+
+    // Load and the border sampler agree: black outside
+    Pixel Load(int frame, int x, int y) const
+    {
+        if(x < 0 || y < 0 || x >= width || y >= height)
+            return {};
+        return frames[frame][(size_t)y * width + x];
+    }
+};
+
+// what Renderer sets up: inputs at inputX/Y on the output, scissor rect to draw
+struct Layout
+{
+    int outputWidth;
+    int outputHeight;
+    int inputX;
+    int inputY;
+    int scissorLeft;
+    int scissorTop;
+    int scissorRight;
+    int scissorBottom;
+};
+
+// VSmain's triangle interpolated at the pixel centre, then PSmain sampling through input_offset/input_scale
+Pixel PixelShader(const Inputs& inputs, const Layout& layout, const Params& params, int x, int y)
+{
+    const float ndcX = (x + 0.5f) / layout.outputWidth * 2.0f - 1.0f;
+    const float ndcY = 1.0f - (y + 0.5f) / layout.outputHeight * 2.0f;
+
+    // barycentrics against (0,2) (-3,-1) (3,-1)
+    const float w0 = (ndcY + 1.0f) / 3.0f;
+    const float w2 = ((3.0f - ndcX) - 3.0f * w0) / 6.0f;
+    const float w1 = 1.0f - w0 - w2;
+    const float u  = w0 * 0.5f + w1 * 2.0f + w2 * -1.0f;
+    const float v  = w0 * -0.5f + w1 * 1.0f + w2 * 1.0f;
+    const float tubePos =
+        w0 * GetTubePos(0.5f, -0.5f, params) + w1 * GetTubePos(2.0f, 1.0f, params) + w2 * GetTubePos(-1.0f, 1.0f, params);
+
+    const float inputU = (u - (float)layout.inputX / layout.outputWidth) * ((float)layout.outputWidth / inputs.width);
+    const float inputV = (v - (float)layout.inputY / layout.outputHeight) * ((float)layout.outputHeight / inputs.height);
+    const int   texelX = inputU < 0.0f || inputU >= 1.0f ? -1 : (int)std::floor(inputU * inputs.width);
+    const int   texelY = inputV < 0.0f || inputV >= 1.0f ? -1 : (int)std::floor(inputV * inputs.height);
+
+    return SimulateCRT(Srgb2Linear(inputs.Load(2, texelX, texelY), params),
+                       Srgb2Linear(inputs.Load(1, texelX, texelY), params),
+                       Srgb2Linear(inputs.Load(0, texelX, texelY), params),
+                       params,
+                       tubePos);
+}
+
+// one CSmain group, writes only the pixels it covers
+void ComputeGroup(const Inputs& inputs, const Layout& layout, const Params& params, int groupX, int groupY, std::vector<Pixel>& output, std::vector<uint8_t>& written)
+{
+    const int width  = layout.scissorRight - layout.scissorLeft;
+    const int height = layout.scissorBottom - layout.scissorTop;
+
+    Pixel prev2[COMPUTE_TILE][COMPUTE_TILE] {}, prev1[COMPUTE_TILE][COMPUTE_TILE] {}, curr[COMPUTE_TILE][COMPUTE_TILE] {};
+    bool  tileEmission = false;
+    for(int ty = 0; ty < COMPUTE_TILE; ty++)
+    {
+        for(int tx = 0; tx < COMPUTE_TILE; tx++)
+        {
+            const int dx = groupX * COMPUTE_TILE + tx, dy = groupY * COMPUTE_TILE + ty;
+            if(dx >= width || dy >= height)
+                continue;
+            const int texelX = layout.scissorLeft + dx - layout.inputX, texelY = layout.scissorTop + dy - layout.inputY;
+            prev2[ty][tx]    = Srgb2Linear(inputs.Load(2, texelX, texelY), params);
+            prev1[ty][tx]    = Srgb2Linear(inputs.Load(1, texelX, texelY), params);
+            curr[ty][tx]     = Srgb2Linear(inputs.Load(0, texelX, texelY), params);
+            for(int ch = 0; ch < 3; ch++)
+                tileEmission |= std::max(std::max(prev2[ty][tx].c[ch], prev1[ty][tx].c[ch]), curr[ty][tx].c[ch]) > 0.0f;
+        }
+    }
+
+    for(int ty = 0; ty < COMPUTE_TILE; ty++)
+    {
+        for(int tx = 0; tx < COMPUTE_TILE; tx++)
+        {
+            const int dx = groupX * COMPUTE_TILE + tx, dy = groupY * COMPUTE_TILE + ty;
+            if(dx >= width || dy >= height)
+                continue;
+            const int  x     = layout.scissorLeft + dx, y = layout.scissorTop + dy;
+            const auto index = (size_t)y * layout.outputWidth + x;
+            written[index]++;
+            if(!tileEmission)
+            {
+                const float black = Linear2Srgb(0.0f, params);
+                output[index]     = { { black, black, black } };
+                continue;
+            }
+            const float tubePos = GetTubePos((x + 0.5f) / layout.outputWidth, (y + 0.5f) / layout.outputHeight, params);
+            output[index]       = SimulateCRT(prev2[ty][tx], prev1[ty][tx], curr[ty][tx], params, tubePos);
+        }
+    }
+}
+
+Inputs MakeInputs(int width, int height, unsigned seed)
+{
+    std::mt19937 random(seed);
+    Inputs       inputs { width, height, {} };
+    for(int frame = 0; frame < 3; frame++)
+    {
+        auto& pixels = inputs.frames[frame];
+        pixels.resize((size_t)width * height);
+        for(auto& pixel : pixels)
+        {
+            // 8-bit UNORM values, dark ones common enough to leave whole tiles black in some frames only
+            for(auto& c : pixel.c)
+                c = random() % 3 ? 0.0f : (float)(random() % 256) / 255.0f;
+        }
+
+        // black blocks, some aligned to compute tiles and some not, black in every frame for a few
+        for(int block = 0; block < 6; block++)
+        {
+            const int bx = (int)(random() % width), by = (int)(random() % height);
+            const int bw = 4 + (int)(random() % 24), bh = 4 + (int)(random() % 24);
+            for(int y = by; y < std::min(by + bh, height); y++)
+                for(int x = bx; x < std::min(bx + bw, width); x++)
+                    pixels[(size_t)y * width + x] = {};
+        }
+        for(int y = 16; y < std::min(40, height); y++)
+            for(int x = 0; x < std::min(24, width); x++)
+                pixels[(size_t)y * width + x] = {};
+    }
+    return inputs;
+}
+
+bool Near(float a, float b)
+{
+    // tubePos comes from interpolation on one path and the pixel centre on the other
+    return std::fabs(a - b) <= 2e-4f;
+}
+
+void CheckLayout(const Inputs& inputs, const Layout& layout, const Params& params)
+{
+    const int  width   = layout.scissorRight - layout.scissorLeft;
+    const int  height  = layout.scissorBottom - layout.scissorTop;
+    const auto outputs = (size_t)layout.outputWidth * layout.outputHeight;
+
+    std::vector<Pixel>   output(outputs);
+    std::vector<uint8_t> written(outputs, 0);
+    for(int groupY = 0; groupY < (height + COMPUTE_TILE - 1) / COMPUTE_TILE; groupY++)
+        for(int groupX = 0; groupX < (width + COMPUTE_TILE - 1) / COMPUTE_TILE; groupX++)
+            ComputeGroup(inputs, layout, params, groupX, groupY, output, written);
+
+    int mismatches = 0, coverage = 0;
+    for(int y = 0; y < layout.outputHeight; y++)
+    {
+        for(int x = 0; x < layout.outputWidth; x++)
+        {
+            const auto index   = (size_t)y * layout.outputWidth + x;
+            const bool scissor = x >= layout.scissorLeft && x < layout.scissorRight && y >= layout.scissorTop && y < layout.scissorBottom;
+            coverage += written[index] != (scissor ? 1 : 0);
+            if(!scissor)
+                continue;
+
+            const auto expected = PixelShader(inputs, layout, params, x, y);
+            for(int ch = 0; ch < 3; ch++)
+                mismatches += !Near(output[index].c[ch], expected.c[ch]);
+        }
+    }
+    CHECK(coverage == 0);
+    CHECK(mismatches == 0);
+}
+
+} // namespace
+
+int main()
+{
+    const Params paramSets[] = {
+        { 2.2f, 1.0f, 1, 4.001f, 0.0f },  { 2.2f, 0.7f, 2, 4.001f, 0.37f }, { 2.4f, 1.0f, 3, 2.5f, 0.81f },
+        { 2.4f, 0.5f, 4, 8.0f, 0.125f }, { 1.8f, 1.0f, 0, 3.0f, 0.5f },
+    };
+
+    // black written for dark tiles has to be what simulateCRT encodes, which isn't 0 before the UNORM clamp
+    for(const auto& params : paramSets)
+    {
+        const Pixel dark = SimulateCRT({}, {}, {}, params, 0.5f);
+        const float black = Linear2Srgb(0.0f, params);
+        CHECK(dark.c[0] == black && dark.c[1] == black && dark.c[2] == black);
+        CHECK(black < 0.0f);
+    }
+
+    const Inputs inputs = MakeInputs(101, 67, 11);
+    const Layout layouts[] = {
+        { 101, 67, 0, 0, 0, 0, 101, 67 },     // 1:1, partial groups on the right and bottom
+        { 160, 120, 30, 21, 0, 0, 160, 120 }, // black bars all round, whole dark groups
+        { 160, 120, 30, 21, 13, 5, 150, 99 }, // scissor not on a group boundary
+        { 96, 64, -9, -3, 0, 0, 96, 64 },     // input larger than the output
+    };
+    for(const auto& params : paramSets)
+        for(const auto& layout : layouts)
+            CheckLayout(inputs, layout, params);
+
+    return Report("CRTBeamSimulatorTest");
+}
@@ -0,0 +1,32 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include <cstdio>
+
+// minimal checks for the Linux-side tests of portable modules, main returns the failure count
+inline int g_failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if(!(cond))                                                                  \
+        {                                                                            \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                            \
+        }                                                                            \
+    } while(0)
+
+inline int Report(const char* name)
+{
+    if(g_failures)
+        fprintf(stderr, "%s: %d check(s) failed\n", name, g_failures);
+    else
+        printf("%s: passed\n", name);
+    return g_failures;
+}
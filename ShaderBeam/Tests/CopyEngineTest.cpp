@@ -0,0 +1,85 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// CopyEngine against a plain row-by-row reference, then its throughput for common frame sizes
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../CopyEngine.h"
+#include "../WorkerPool.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+
+static void CheckCopy(WorkerPool& pool, bool streaming, size_t rowBytes, unsigned rows, size_t sourcePitch, size_t destPitch, size_t destOffset)
+{
+    std::mt19937         random((unsigned)(rowBytes * 31 + rows));
+    std::vector<uint8_t> source(sourcePitch * rows);
+    for(auto& b : source)
+        b = (uint8_t)random();
+
+    // offset misaligns the destination so the unaligned head of the streaming path is covered
+    std::vector<uint8_t> dest(destOffset + destPitch * rows, 0xcd);
+    std::vector<uint8_t> expected(dest);
+    for(unsigned row = 0; row < rows; row++)
+        memcpy(expected.data() + destOffset + row * destPitch, source.data() + row * sourcePitch, rowBytes);
+
+    CopyEngine engine(pool);
+    engine.SetStreaming(streaming);
+    engine.Copy({ dest.data() + destOffset, destPitch }, { source.data(), sourcePitch }, rowBytes, rows);
+
+    // padding between rows must be left alone too
+    CHECK(dest == expected);
+}
+
+int main()
+{
+    const unsigned threadCounts[] = { 0, 1, 3 };
+    for(auto threads : threadCounts)
+    {
+        WorkerPool pool;
+        pool.Start(threads);
+        for(bool streaming : { false, true })
+        {
+            CheckCopy(pool, streaming, 0, 4, 64, 64, 0);
+            CheckCopy(pool, streaming, 7, 3, 16, 8, 1);
+            CheckCopy(pool, streaming, 64, 1, 64, 64, 0);
+            CheckCopy(pool, streaming, 1000, 17, 1024, 1008, 3);
+            CheckCopy(pool, streaming, 1920 * 4, 1080, 1920 * 4 + 256, 1920 * 4, 0);  // above COPY_MIN_BAND_BYTES, gets split
+            CheckCopy(pool, streaming, 2560 * 8, 301, 2560 * 8 + 64, 2560 * 8 + 192, 5); // HDR, odd row count
+            CheckCopy(pool, streaming, 4096, 600, 4096, 4096, 0);                        // contiguous
+        }
+    }
+
+    struct
+    {
+        const char* name;
+        size_t      rowBytes;
+        unsigned    rows;
+    } const frames[] = {
+        { "1080p", 1920 * 4, 1080 },
+        { "1440p", 2560 * 4, 1440 },
+        { "4K", 3840 * 4, 2160 },
+        { "4K HDR", 3840 * 8, 2160 },
+    };
+    for(auto threads : { 0u, WorkerPool::DefaultThreads() })
+    {
+        WorkerPool pool;
+        pool.Start(threads);
+        CopyEngine engine(pool);
+        for(const auto& frame : frames)
+        {
+            const auto gbps = engine.Benchmark(frame.rowBytes, frame.rows, COPY_BENCHMARK_ITERATIONS);
+            printf("%-7s %u worker(s): %6.2f GB/s\n", frame.name, threads, gbps);
+            CHECK(gbps > 0);
+        }
+    }
+
+    return Report("CopyEngineTest");
+}
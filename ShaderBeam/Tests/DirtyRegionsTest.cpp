@@ -0,0 +1,163 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// randomized coverage checks: whatever gets merged, every changed pixel must still be copied
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../DirtyRegions.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+
+constexpr int WIDTH  = 96;
+constexpr int HEIGHT = 64;
+
+using Mask = std::vector<bool>;
+
+static void Mark(Mask& mask, DirtyRect rect)
+{
+    for(int y = std::max(rect.top, 0); y < std::min(rect.bottom, HEIGHT); y++)
+        for(int x = std::max(rect.left, 0); x < std::min(rect.right, WIDTH); x++)
+            mask[y * WIDTH + x] = true;
+}
+
+static bool Covers(const DirtyRegions& regions, const Mask& changed)
+{
+    Mask covered(WIDTH * HEIGHT);
+    for(const auto& rect : regions.GetRects())
+        Mark(covered, rect);
+    for(size_t i = 0; i < changed.size(); i++)
+    {
+        if(changed[i] && !covered[i])
+            return false;
+    }
+    return true;
+}
+
+static DirtyRect RandomRect(std::mt19937& random)
+{
+    // mostly small (cursor, text), sometimes large or partly off screen
+    const bool                         large = random() % 8 == 0;
+    std::uniform_int_distribution<int> position(-8, WIDTH + 8);
+    std::uniform_int_distribution<int> size(large ? 16 : 1, large ? 48 : 12);
+    const int                          left = position(random);
+    const int                          top  = position(random) * HEIGHT / WIDTH;
+    return { left, top, left + size(random), top + size(random) };
+}
+
+static void CheckInvariants(const DirtyRegions& regions, const Mask& changed)
+{
+    CHECK(Covers(regions, changed));
+    if(regions.IsFull())
+        return;
+
+    const auto rects = regions.GetRects();
+    CHECK(rects.size() <= MAX_DIRTY_RECTS);
+    CHECK(regions.Coverage() <= DIRTY_FULL_COVERAGE);
+    for(size_t a = 0; a < rects.size(); a++)
+    {
+        CHECK(!rects[a].IsEmpty());
+        CHECK(rects[a].left >= 0 && rects[a].top >= 0 && rects[a].right <= WIDTH && rects[a].bottom <= HEIGHT);
+        // touching rects are always merged, so what's left never overlaps (nothing is copied twice)
+        for(size_t b = a + 1; b < rects.size(); b++)
+            CHECK(!rects[a].Touches(rects[b]));
+    }
+}
+
+static void TestRandomFrames()
+{
+    std::mt19937 random(1234);
+    for(int frame = 0; frame < 2000; frame++)
+    {
+        DirtyRegions regions;
+        regions.Reset(WIDTH, HEIGHT);
+        Mask       changed(WIDTH * HEIGHT);
+        const auto count = random() % 24;
+        for(unsigned i = 0; i < count; i++)
+        {
+            const auto rect = RandomRect(random);
+            regions.Add(rect);
+            Mark(changed, rect);
+            CheckInvariants(regions, changed);
+        }
+        CHECK(regions.IsEmpty() == std::none_of(changed.begin(), changed.end(), [](bool c) { return c; }));
+    }
+}
+
+static void TestEdges()
+{
+    DirtyRegions regions;
+    regions.Reset(WIDTH, HEIGHT);
+    CHECK(regions.IsEmpty());
+
+    // entirely off screen or empty, nothing to copy
+    regions.Add({ -10, -10, 0, 0 });
+    regions.Add({ WIDTH, 0, WIDTH + 5, 5 });
+    regions.Add({ 10, 10, 10, 20 });
+    CHECK(regions.IsEmpty());
+
+    // sharing an edge merges into one
+    regions.Add({ 0, 0, 10, 10 });
+    regions.Add({ 10, 0, 20, 10 });
+    CHECK(regions.GetRects().size() == 1);
+    CHECK(regions.GetRects()[0].right == 20);
+
+    // past the coverage threshold becomes a single full copy
+    regions.Add({ 0, 0, WIDTH, HEIGHT * 2 / 3 });
+    CHECK(regions.IsFull());
+    CHECK(regions.GetRects().size() == 1 && regions.GetRects()[0].Area() == WIDTH * HEIGHT);
+}
+
+static void TestTracker()
+{
+    std::mt19937 random(42);
+    DirtyTracker tracker;
+    tracker.Reset(WIDTH, HEIGHT);
+
+    // each target only hears about changes since it was last taken
+    const int targets[3] {};
+    Mask      missed[3];
+    for(auto& mask : missed)
+        mask.assign(WIDTH * HEIGHT, true); // never written
+
+    for(int frame = 0; frame < 500; frame++)
+    {
+        DirtyRegions changes;
+        changes.Reset(WIDTH, HEIGHT);
+        const auto count = random() % 4;
+        Mask       changed(WIDTH * HEIGHT);
+        for(unsigned i = 0; i < count; i++)
+        {
+            const auto rect = RandomRect(random);
+            changes.Add(rect);
+            Mark(changed, rect);
+        }
+        tracker.MarkDirty(changes);
+        for(auto& mask : missed)
+            for(size_t p = 0; p < mask.size(); p++)
+                mask[p] = mask[p] || changed[p];
+
+        const auto target = frame % 3;
+        CHECK(Covers(tracker.Take(&targets[target]), missed[target]));
+        missed[target].assign(WIDTH * HEIGHT, false);
+    }
+
+    // taken twice in a row, nothing new
+    tracker.Take(&targets[0]);
+    CHECK(tracker.Take(&targets[0]).IsEmpty());
+}
+
+int main()
+{
+    TestRandomFrames();
+    TestEdges();
+    TestTracker();
+    return Report("DirtyRegionsTest");
+}
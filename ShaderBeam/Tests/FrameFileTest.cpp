@@ -0,0 +1,262 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// FrameFile over clips written to a temporary directory: raw frame counting, Y4M 420/444/mono parsing and
+// BT.601 conversion against known values, whole and in bands
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "../FrameFile.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+struct TempFile
+{
+    fs::path path;
+
+    explicit TempFile(const std::string& contents)
+    {
+        path = fs::temp_directory_path() / ("ShaderBeamFrameFileTest" + std::to_string(std::random_device()()));
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(contents.data(), contents.size());
+    }
+
+    ~TempFile()
+    {
+        std::error_code error;
+        fs::remove(path, error);
+    }
+};
+
+std::string Y4M(const std::string& header, const std::vector<std::string>& frames)
+{
+    std::string file = "YUV4MPEG2 " + header + "\n";
+    for(const auto& frame : frames)
+        file += "FRAME\n" + frame;
+    return file;
+}
+
+std::string Plane(size_t size, uint8_t value)
+{
+    return std::string(size, (char)value);
+}
+
+bool Throws(const std::string& path, unsigned width, unsigned height, unsigned bytesPerPixel)
+{
+    FrameFile file;
+    try
+    {
+        file.Open(path, width, height, bytesPerPixel);
+    }
+    catch(const std::runtime_error&)
+    {
+        return !file.IsOpen();
+    }
+    return false;
+}
+
+void CheckRaw()
+{
+    // three whole 4x2 BGRA frames and a truncated fourth, each filled with its index
+    const size_t frameSize = 4 * 2 * 4;
+    std::string  contents;
+    for(int frame = 0; frame < 3; frame++)
+        contents += Plane(frameSize, (uint8_t)frame);
+    contents += Plane(frameSize - 1, 3);
+    TempFile temp(contents);
+
+    FrameFile file;
+    file.Open(temp.path.string(), 4, 2, 4);
+    CHECK(file.IsOpen() && !file.IsY4M());
+    CHECK(file.GetNumFrames() == 3);
+    CHECK(file.GetPitch() == 16);
+    CHECK(file.GetFrameRate() == 0);
+    for(unsigned frame = 0; frame < 3; frame++)
+        CHECK(file.GetFrame(frame)[0] == frame && file.GetFrame(frame)[frameSize - 1] == frame);
+    CHECK(file.GetFrame(3) == nullptr);
+
+    // the same bytes as 8 bytes per pixel hold only one whole frame, and none at all as a bigger one
+    file.Open(temp.path.string(), 4, 2, 8);
+    CHECK(file.GetNumFrames() == 1);
+    CHECK(Throws(temp.path.string(), 64, 64, 4));
+    CHECK(Throws(temp.path.string(), 0, 2, 4));
+
+    file.Close();
+    CHECK(!file.IsOpen() && file.GetNumFrames() == 0);
+}
+
+void CheckParsing()
+{
+    // 420 with odd dimensions rounds chroma up, 3x3 luma + 2 * 2x2 chroma per frame
+    {
+        TempFile  temp(Y4M("W3 H3 F30000:1001 Ip A1:1 C420mpeg2 XYSCSS=420MPEG2", { Plane(9 + 8, 128), Plane(9 + 8, 128) }) + "FRAME\n" + Plane(16, 128));
+        FrameFile file;
+        file.Open(temp.path.string(), 0, 0, 4);
+        CHECK(file.IsY4M());
+        CHECK(file.GetWidth() == 3 && file.GetHeight() == 3);
+        CHECK(file.GetNumFrames() == 2);
+        CHECK(file.GetFrameRate() > 29.97 && file.GetFrameRate() < 29.98);
+        CHECK(file.GetFrame(1) - file.GetFrame(0) == 17 + 6);
+    }
+
+    // without a C tag the clip is 420
+    {
+        TempFile  temp(Y4M("W2 H2 F25:1", { Plane(4 + 2, 128) }));
+        FrameFile file;
+        file.Open(temp.path.string(), 0, 0, 4);
+        CHECK(file.GetNumFrames() == 1 && file.GetFrameRate() == 25);
+    }
+
+    {
+        TempFile  temp(Y4M("W4 H2 C444", { Plane(24, 128), Plane(24, 128), Plane(24, 128) }));
+        FrameFile file;
+        file.Open(temp.path.string(), 0, 0, 4);
+        CHECK(file.GetNumFrames() == 3);
+        CHECK(file.GetFrame(1) - file.GetFrame(0) == 24 + 6);
+        CHECK(file.GetFrameRate() == 0);
+    }
+
+    {
+        TempFile  temp(Y4M("W4 H2 Cmono", { Plane(8, 16), Plane(8, 16) }) + "FRAME\n" + Plane(7, 16));
+        FrameFile file;
+        file.Open(temp.path.string(), 0, 0, 4);
+        CHECK(file.GetNumFrames() == 2);
+        CHECK(file.GetFrame(1) - file.GetFrame(0) == 8 + 6);
+    }
+
+    // unusable headers and clips without a whole frame are refused
+    CHECK(Throws(TempFile(Y4M("W4 H2 C422", { Plane(16, 128) })).path.string(), 0, 0, 4));
+    CHECK(Throws(TempFile(Y4M("W4 H2 C420p10", { Plane(24, 128) })).path.string(), 0, 0, 4));
+    CHECK(Throws(TempFile(Y4M("H2 Cmono", { Plane(8, 128) })).path.string(), 0, 0, 4));
+    CHECK(Throws(TempFile(Y4M("W4 H2 Cmono", { Plane(7, 128) })).path.string(), 0, 0, 4));
+    CHECK(Throws(TempFile("YUV4MPEG2 W4 H2").path.string(), 0, 0, 4));
+}
+
+// BGRA of one converted pixel
+uint32_t Pixel(const std::vector<uint8_t>& frame, size_t pitch, unsigned x, unsigned y)
+{
+    auto pixel = frame.data() + y * pitch + x * 4;
+    return (uint32_t)pixel[0] | (uint32_t)pixel[1] << 8 | (uint32_t)pixel[2] << 16 | (uint32_t)pixel[3] << 24;
+}
+
+constexpr uint32_t BGRA(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint32_t)b | (uint32_t)g << 8 | (uint32_t)r << 16 | 0xff000000u;
+}
+
+void CheckConversion()
+{
+    // 444 row of limited range black, white, mid grey, red, green and blue
+    {
+        const std::string y = { 16, (char)235, 126, 81, (char)145, 41 };
+        const std::string u = { (char)128, (char)128, (char)128, 90, 54, (char)240 };
+        const std::string v = { (char)128, (char)128, (char)128, (char)240, 34, 110 };
+        TempFile          temp(Y4M("W6 H1 C444", { y + u + v }));
+        FrameFile         file;
+        file.Open(temp.path.string(), 0, 0, 4);
+
+        const size_t         pitch = 6 * 4 + 8;
+        std::vector<uint8_t> frame(pitch, 0xcd);
+        file.ConvertFrame(0, frame.data(), pitch);
+        CHECK(Pixel(frame, pitch, 0, 0) == BGRA(0, 0, 0));
+        CHECK(Pixel(frame, pitch, 1, 0) == BGRA(255, 255, 255));
+        CHECK(Pixel(frame, pitch, 2, 0) == BGRA(128, 128, 128));
+        CHECK(Pixel(frame, pitch, 3, 0) == BGRA(255, 0, 0));
+        CHECK(Pixel(frame, pitch, 4, 0) == BGRA(0, 255, 1));
+        CHECK(Pixel(frame, pitch, 5, 0) == BGRA(0, 0, 255));
+
+        // the padding past the row is left alone
+        CHECK(frame[6 * 4] == 0xcd && frame[pitch - 1] == 0xcd);
+    }
+
+    // each 420 chroma sample covers a 2x2 block, odd width and height: red on the left, blue in the last column
+    // and a blue luma sample under red chroma in between, which comes out dark red
+    {
+        const std::string y = { 81, 81, 81, 41, 41, 81, 81, 81, 41, 41, 81, 81, 81, 41, 41 };
+        const std::string u = { 90, 90, (char)240, 90, 90, (char)240 };
+        const std::string v = { (char)240, (char)240, 110, (char)240, (char)240, 110 };
+        TempFile          temp(Y4M("W5 H3 C420jpeg", { y + u + v }));
+        FrameFile         file;
+        file.Open(temp.path.string(), 0, 0, 4);
+
+        const size_t         pitch = 5 * 4;
+        std::vector<uint8_t> frame(pitch * 3);
+        file.ConvertFrame(0, frame.data(), pitch);
+        for(unsigned row = 0; row < 3; row++)
+        {
+            CHECK(Pixel(frame, pitch, 0, row) == BGRA(255, 0, 0));
+            CHECK(Pixel(frame, pitch, 2, row) == BGRA(255, 0, 0));
+            CHECK(Pixel(frame, pitch, 3, row) == BGRA(208, 0, 0));
+            CHECK(Pixel(frame, pitch, 4, row) == BGRA(0, 0, 255));
+        }
+    }
+
+    // mono has neutral chroma, so grey levels clamp at both ends
+    {
+        const std::string y = { 0, 16, 126, (char)235, (char)255 };
+        TempFile          temp(Y4M("W5 H1 Cmono", { y }));
+        FrameFile         file;
+        file.Open(temp.path.string(), 0, 0, 4);
+
+        std::vector<uint8_t> frame(5 * 4);
+        file.ConvertFrame(0, frame.data(), 5 * 4);
+        CHECK(Pixel(frame, 20, 0, 0) == BGRA(0, 0, 0));
+        CHECK(Pixel(frame, 20, 1, 0) == BGRA(0, 0, 0));
+        CHECK(Pixel(frame, 20, 2, 0) == BGRA(128, 128, 128));
+        CHECK(Pixel(frame, 20, 3, 0) == BGRA(255, 255, 255));
+        CHECK(Pixel(frame, 20, 4, 0) == BGRA(255, 255, 255));
+    }
+}
+
+void CheckBands()
+{
+    // a noisy 420 frame converted in uneven bands, odd rows included, matches the whole frame
+    const unsigned width = 37, height = 29;
+    const size_t   size  = (size_t)width * height + 2 * (size_t)((width + 1) / 2) * ((height + 1) / 2);
+    std::string    planes(size, 0);
+    std::mt19937   random(1234);
+    for(auto& value : planes)
+        value = (char)(random() & 0xff);
+    TempFile  temp(Y4M("W37 H29 C420", { Plane(size, 0), planes }));
+    FrameFile file;
+    file.Open(temp.path.string(), 0, 0, 4);
+
+    const size_t         pitch = width * 4;
+    std::vector<uint8_t> whole(pitch * height);
+    std::vector<uint8_t> banded(pitch * height, 0xcd);
+    file.ConvertFrame(1, whole.data(), pitch);
+    for(unsigned firstRow = 0; firstRow < height; firstRow += 5)
+        file.ConvertRows(1, banded.data(), pitch, firstRow, 5);
+    CHECK(banded == whole);
+
+    // bands running past the bottom stop there, and an out of range frame writes nothing
+    std::vector<uint8_t> clipped(pitch * height, 0xcd);
+    file.ConvertRows(1, clipped.data(), pitch, 0, height + 100);
+    CHECK(clipped == whole);
+    file.ConvertRows(2, clipped.data(), pitch, 0, height);
+    CHECK(clipped == whole);
+}
+
+} // namespace
+
+int main()
+{
+    CheckRaw();
+    CheckParsing();
+    CheckConversion();
+    CheckBands();
+    return Report("FrameFileTest");
+}
@@ -0,0 +1,218 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// InputRing slot bookkeeping: which texture capture writes next, repeats sharing a generation, slots coming
+// back once frames age out of the held ones, and history deeper than the held frames
+
+#include <set>
+#include <stdexcept>
+
+#include "../InputRing.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+
+namespace
+{
+
+// slots held by the newest numHeld frames, each only once
+std::set<int> HeldSlots(const InputRing& ring)
+{
+    std::set<int> slots;
+    for(int age = 0; age < ring.GetNumHeld(); age++)
+        slots.insert(ring.GetSlot(age));
+    return slots;
+}
+
+void CheckReset()
+{
+    InputRing ring;
+    ring.Reset(6, 3, 4);
+    CHECK(ring.GetDepth() == 6 && ring.GetNumHeld() == 3);
+
+    // held frames start out on textures of their own, the rest have none and nothing has arrived
+    for(int age = 0; age < 3; age++)
+        CHECK(ring.GetSlot(age) == age && ring.GetGeneration(age) == 0);
+    for(int age = 3; age < 6; age++)
+        CHECK(ring.GetSlot(age) == -1 && ring.GetGeneration(age) == 0);
+    CHECK(ring.GetNextSlot() == 3);
+
+    bool thrown = false;
+    try
+    {
+        ring.Reset(2, 3, 4);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    thrown = false;
+    try
+    {
+        ring.Reset(6, 3, 2);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+void CheckPush()
+{
+    InputRing ring;
+    ring.Reset(6, 3, 4);
+
+    // the free texture is written first, then each one let go by the frame aging out of the held ones
+    const std::vector<uint8_t> tiles = { 1, 0, 1 };
+    CHECK(ring.GetNextSlot() == 3);
+    ring.Push(10.0f, FrameContent::Partial, &tiles);
+    CHECK(ring.GetSlot(0) == 3 && ring.GetGeneration(0) == 1);
+    CHECK(ring.Get(0).arrived == 10.0f && ring.Get(0).content == FrameContent::Partial && ring.Get(0).changedTiles == tiles);
+    CHECK(ring.GetSlot(1) == 0 && ring.GetSlot(2) == 1 && ring.GetSlot(3) == 2);
+    CHECK(ring.GetNextSlot() == 2);
+
+    ring.Push(20.0f, FrameContent::New, nullptr);
+    CHECK(ring.GetSlot(0) == 2 && ring.GetGeneration(0) == 2);
+    CHECK(ring.Get(0).changedTiles.empty());
+    CHECK(ring.GetNextSlot() == 1);
+
+    // every push uses a texture none of the held frames is on, so numSlots - numHeld are always spare
+    for(int frame = 0; frame < 20; frame++)
+    {
+        const int next = ring.GetNextSlot();
+        CHECK(HeldSlots(ring).count(next) == 0);
+        ring.Push(30.0f + frame, FrameContent::New, nullptr);
+        CHECK(ring.GetSlot(0) == next);
+        CHECK(HeldSlots(ring).size() == 3);
+    }
+}
+
+void CheckRepeat()
+{
+    InputRing ring;
+    ring.Reset(6, 3, 4);
+    const std::vector<uint8_t> tiles = { 1 };
+    ring.Push(10.0f, FrameContent::Partial, &tiles);
+    const int      slot       = ring.GetSlot(0);
+    const uint64_t generation = ring.GetGeneration(0);
+
+    // a repeat is the same texture and generation as what it repeats, shown unchanged
+    ring.Repeat();
+    CHECK(ring.GetSlot(0) == slot && ring.GetSlot(1) == slot);
+    CHECK(ring.GetGeneration(0) == generation && ring.GetGeneration(1) == generation);
+    CHECK(ring.Get(0).arrived == 10.0f && ring.Get(0).content == FrameContent::Identical && ring.Get(0).changedTiles.empty());
+    CHECK(ring.Get(1).content == FrameContent::Partial && ring.Get(1).changedTiles == tiles);
+    CHECK(ring.IsCurrent(slot, generation));
+
+    // with every held frame on one texture the other three are free, the shared one is not
+    ring.Repeat();
+    CHECK(HeldSlots(ring) == std::set<int> { slot });
+    CHECK(ring.GetNextSlot() != slot);
+
+    // the texture stays held until the last repeat of it ages out
+    ring.Push(20.0f, FrameContent::New, nullptr);
+    ring.Push(30.0f, FrameContent::New, nullptr);
+    CHECK(ring.GetSlot(2) == slot);
+    CHECK(ring.GetSlot(0) != slot && ring.GetSlot(1) != slot);
+    ring.Push(40.0f, FrameContent::New, nullptr);
+    CHECK(HeldSlots(ring).count(slot) == 0);
+
+    // a new frame after repeats gets a generation of its own
+    CHECK(ring.GetGeneration(0) != generation && ring.GetGeneration(0) != ring.GetGeneration(1));
+
+    // with no history there's nothing to repeat into
+    InputRing single;
+    single.Reset(1, 1, 1);
+    single.Push(10.0f, FrameContent::New, nullptr);
+    single.Repeat();
+    CHECK(single.GetGeneration(0) == 1 && single.Get(0).content == FrameContent::New);
+}
+
+void CheckIsCurrent()
+{
+    InputRing ring;
+    ring.Reset(4, 2, 3);
+    ring.Push(10.0f, FrameContent::New, nullptr);
+    const int      slot       = ring.GetSlot(0);
+    const uint64_t generation = ring.GetGeneration(0);
+    CHECK(ring.IsCurrent(slot, generation));
+    CHECK(!ring.IsCurrent(slot, generation + 1));
+    CHECK(!ring.IsCurrent(-1, generation) && !ring.IsCurrent(3, generation));
+
+    // still current while the texture holds that frame, even once it's no longer the newest
+    ring.Push(20.0f, FrameContent::New, nullptr);
+    CHECK(ring.IsCurrent(slot, generation));
+
+    // stale as soon as the texture is written again
+    while(ring.GetNextSlot() != slot)
+        ring.Push(30.0f, FrameContent::New, nullptr);
+    CHECK(ring.IsCurrent(slot, generation));
+    ring.Push(40.0f, FrameContent::New, nullptr);
+    CHECK(!ring.IsCurrent(slot, generation));
+    CHECK(ring.IsCurrent(slot, ring.GetGeneration(0)));
+}
+
+void CheckNoSpareSlots()
+{
+    // as many textures as held frames: the oldest held one is overwritten
+    InputRing ring;
+    ring.Reset(3, 2, 2);
+    CHECK(ring.GetNextSlot() == 1);
+    for(int frame = 0; frame < 8; frame++)
+    {
+        const int      oldest           = ring.GetSlot(1);
+        const uint64_t oldestGeneration = ring.GetGeneration(1);
+        const int      newest           = ring.GetSlot(0);
+        CHECK(ring.GetNextSlot() == oldest);
+        ring.Push(10.0f * frame, FrameContent::New, nullptr);
+        CHECK(ring.GetSlot(0) == oldest && ring.GetSlot(1) == newest);
+        CHECK(!ring.IsCurrent(oldest, oldestGeneration));
+        CHECK(ring.IsCurrent(newest, ring.GetGeneration(1)));
+    }
+}
+
+void CheckDeepHistory()
+{
+    // history far deeper than the held frames, e.g. compact history keeping older ones elsewhere
+    InputRing ring;
+    ring.Reset(8, 2, 3);
+    for(int frame = 1; frame <= 20; frame++)
+        ring.Push((float)frame, FrameContent::New, nullptr);
+
+    // the newest eight in order, older ones gone
+    for(int age = 0; age < 8; age++)
+    {
+        CHECK(ring.GetGeneration(age) == (uint64_t)(20 - age));
+        CHECK(ring.Get(age).arrived == (float)(20 - age));
+    }
+
+    // only the held ones and the spare texture are current, older frames remember a slot that has moved on
+    for(int age = 0; age < 8; age++)
+        CHECK(ring.IsCurrent(ring.GetSlot(age), ring.GetGeneration(age)) == (age < 3));
+    CHECK(HeldSlots(ring).size() == 2);
+    CHECK(HeldSlots(ring).count(ring.GetNextSlot()) == 0);
+
+    // a repeat still ages the unheld history by one
+    ring.Repeat();
+    CHECK(ring.GetGeneration(0) == 20 && ring.GetGeneration(1) == 20 && ring.GetGeneration(7) == 14);
+}
+
+} // namespace
+
+int main()
+{
+    CheckReset();
+    CheckPush();
+    CheckRepeat();
+    CheckIsCurrent();
+    CheckNoSpareSlots();
+    CheckDeepHistory();
+    return Report("InputRingTest");
+}
@@ -0,0 +1,186 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// PassGraph scheduling and slot sharing, on the Soft BFI graph and a few smaller ones, plus graphs it must refuse
+
+#include <stdexcept>
+#include <vector>
+
+#include "../PassGraph.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+
+namespace
+{
+
+// half of 1080p in RGBA16F, as Soft BFI uses
+constexpr TargetDesc HALF_RGBA16F { 960, 540, 10, 8 };
+constexpr TargetDesc FULL_RGBA16F { 1920, 1080, 10, 8 };
+
+template<typename Func>
+bool Throws(Func func)
+{
+    try
+    {
+        func();
+    }
+    catch(const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void CheckSoftBFI()
+{
+    // same passes as SoftBFIShader::Create
+    PassGraph graph;
+    const int linear     = graph.AddTarget(HALF_RGBA16F);
+    const int blurH      = graph.AddTarget(HALF_RGBA16F);
+    const int glow       = graph.AddTarget(HALF_RGBA16F);
+    const int downsample = graph.AddPass({ PassSource(0) }, linear, PASS_PER_INPUT);
+    const int blurHPass  = graph.AddPass({ linear }, blurH, PASS_PER_INPUT);
+    const int blurVPass  = graph.AddPass({ blurH }, glow, PASS_PER_INPUT);
+    const int mainPass   = graph.AddPass({ PassSource(0), glow }, PASS_OUTPUT, PASS_PER_SUBFRAME);
+    graph.Compile();
+
+    CHECK(graph.GetNumPasses() == 4);
+    CHECK(graph.GetRate(downsample) == PASS_PER_INPUT && graph.GetRate(blurHPass) == PASS_PER_INPUT && graph.GetRate(blurVPass) == PASS_PER_INPUT);
+    CHECK(graph.GetRate(mainPass) == PASS_PER_SUBFRAME);
+    CHECK(graph.GetNumSourcesCached() == 1);
+
+    // glow is read every subframe so it has to survive, the blur intermediates don't
+    CHECK(graph.IsPersistent(glow));
+    CHECK(!graph.IsPersistent(linear) && !graph.IsPersistent(blurH));
+
+    // linear is dead by the time glow is written so they share, blurH is live across both
+    CHECK(graph.GetSlot(linear) == graph.GetSlot(glow));
+    CHECK(graph.GetSlot(blurH) != graph.GetSlot(linear));
+    CHECK(graph.GetSlots().size() == 2);
+    CHECK(graph.GetRequestedBytes() == 3 * HALF_RGBA16F.GetBytes());
+    CHECK(graph.GetAllocatedBytes() == 2 * HALF_RGBA16F.GetBytes());
+
+    // everything runs first, after that the blur only when a new frame arrives
+    const std::vector<int> all      = { downsample, blurHPass, blurVPass, mainPass };
+    const std::vector<int> perFrame = { mainPass };
+    CHECK(graph.Schedule(false) == all);
+    CHECK(graph.Schedule(false) == perFrame);
+    CHECK(graph.Schedule(false) == perFrame);
+    CHECK(graph.Schedule(true) == all);
+    CHECK(graph.Schedule(false) == perFrame);
+
+    // recompiling drops what was cached
+    graph.Compile();
+    CHECK(graph.Schedule(false) == all);
+
+    // a target changing size needs compiling again and can no longer share with a different one
+    graph.SetTargetDesc(glow, FULL_RGBA16F);
+    CHECK(Throws([&] { graph.Schedule(false); }));
+    graph.Compile();
+    CHECK(graph.GetSlots().size() == 3);
+    CHECK(graph.GetSlot(glow) != graph.GetSlot(linear));
+    CHECK(graph.GetAllocatedBytes() == graph.GetRequestedBytes());
+    CHECK(graph.Schedule(false) == all);
+
+    // setting the same desc again keeps what's cached
+    graph.SetTargetDesc(glow, FULL_RGBA16F);
+    CHECK(graph.Schedule(false) == perFrame);
+}
+
+void CheckRates()
+{
+    // per-input work chained after per-subframe work has to run every subframe as well
+    PassGraph graph;
+    const int phase     = graph.AddTarget(HALF_RGBA16F);
+    const int history   = graph.AddTarget(HALF_RGBA16F);
+    const int shaded    = graph.AddTarget(HALF_RGBA16F);
+    const int phasePass = graph.AddPass({}, phase, PASS_PER_SUBFRAME);
+    const int histPass  = graph.AddPass({ PassSource(0), PassSource(2) }, history, PASS_PER_INPUT);
+    const int shadePass = graph.AddPass({ history, phase }, shaded, PASS_PER_INPUT);
+    const int outPass   = graph.AddPass({ shaded }, PASS_OUTPUT, PASS_PER_INPUT);
+    graph.Compile();
+
+    CHECK(graph.GetRate(phasePass) == PASS_PER_SUBFRAME);
+    CHECK(graph.GetRate(histPass) == PASS_PER_INPUT);
+    CHECK(graph.GetRate(shadePass) == PASS_PER_SUBFRAME);
+    CHECK(graph.GetRate(outPass) == PASS_PER_SUBFRAME);
+    CHECK(graph.GetNumSourcesCached() == 3);
+
+    // only the per-input result read per subframe is persistent, and it can't share with anything written
+    // per subframe
+    CHECK(graph.IsPersistent(history));
+    CHECK(!graph.IsPersistent(phase) && !graph.IsPersistent(shaded));
+    CHECK(graph.GetSlot(history) != graph.GetSlot(phase) && graph.GetSlot(history) != graph.GetSlot(shaded));
+
+    graph.Schedule(true);
+    const std::vector<int> perFrame = { phasePass, shadePass, outPass };
+    CHECK(graph.Schedule(false) == perFrame);
+}
+
+void CheckSharing()
+{
+    // a per-subframe chain reuses the same two textures all the way down
+    PassGraph        graph;
+    std::vector<int> targets;
+    for(int step = 0; step < 6; step++)
+        targets.push_back(graph.AddTarget(FULL_RGBA16F));
+    graph.AddPass({ PassSource(0) }, targets[0], PASS_PER_SUBFRAME);
+    for(int step = 1; step < 6; step++)
+        graph.AddPass({ targets[step - 1] }, targets[step], PASS_PER_SUBFRAME);
+    graph.AddPass({ targets[5] }, PASS_OUTPUT, PASS_PER_SUBFRAME);
+    graph.Compile();
+
+    CHECK(graph.GetSlots().size() == 2);
+    for(int step = 1; step < 6; step++)
+        CHECK(graph.GetSlot(targets[step]) != graph.GetSlot(targets[step - 1]));
+    CHECK(graph.GetNumSourcesCached() == 0);
+
+    // two per-input results both read every subframe each need their own
+    PassGraph persistent;
+    const int a = persistent.AddTarget(HALF_RGBA16F);
+    const int b = persistent.AddTarget(HALF_RGBA16F);
+    persistent.AddPass({ PassSource(0) }, a, PASS_PER_INPUT);
+    persistent.AddPass({ PassSource(1) }, b, PASS_PER_INPUT);
+    persistent.AddPass({ a, b }, PASS_OUTPUT, PASS_PER_SUBFRAME);
+    persistent.Compile();
+    CHECK(persistent.IsPersistent(a) && persistent.IsPersistent(b));
+    CHECK(persistent.GetSlot(a) != persistent.GetSlot(b));
+}
+
+void CheckRefused()
+{
+    PassGraph graph;
+    const int target = graph.AddTarget(HALF_RGBA16F);
+    const int unused = graph.AddTarget(HALF_RGBA16F);
+
+    CHECK(Throws([&] { graph.AddPass({}, 5, PASS_PER_INPUT); }));
+    CHECK(Throws([&] { graph.AddPass({ target }, unused, PASS_PER_INPUT); }));
+    CHECK(Throws([&] { graph.AddPass({ 7 }, PASS_OUTPUT, PASS_PER_INPUT); }));
+    graph.AddPass({ PassSource(0) }, target, PASS_PER_INPUT);
+    CHECK(Throws([&] { graph.AddPass({ PassSource(0) }, target, PASS_PER_INPUT); }));
+
+    // nothing writes the second target, and nothing can run until compiled
+    CHECK(Throws([&] { graph.Schedule(true); }));
+    CHECK(Throws([&] { graph.Compile(); }));
+
+    // cleared graphs start over
+    graph.Clear();
+    CHECK(graph.GetNumPasses() == 0 && graph.GetSlots().empty() && graph.GetRequestedBytes() == 0);
+    CHECK(Throws([&] { graph.Schedule(true); }));
+}
+
+} // namespace
+
+int main()
+{
+    CheckSoftBFI();
+    CheckRates();
+    CheckSharing();
+    CheckRefused();
+    return Report("PassGraphTest");
+}
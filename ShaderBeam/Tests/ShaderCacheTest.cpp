@@ -0,0 +1,258 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// ShaderCache with a stub compiler over sources in a temporary directory: hits, misses, keys changing with
+// includes and defines, and damaged entries on disk
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "../ShaderCache.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// counts calls and returns bytecode that differs per call, so a hit is told apart from a recompile
+struct StubCompiler
+{
+    unsigned calls { 0 };
+
+    ShaderCache::Compiler Make()
+    {
+        return [this]() {
+            calls++;
+            std::vector<uint8_t> bytecode(64 + calls);
+            for(size_t i = 0; i < bytecode.size(); i++)
+                bytecode[i] = (uint8_t)(i * 7 + calls);
+            return bytecode;
+        };
+    }
+};
+
+void WriteFile(const fs::path& path, const std::string& text)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream << text;
+}
+
+std::vector<fs::path> CacheEntries(const fs::path& directory)
+{
+    std::vector<fs::path> entries;
+    for(const auto& entry : fs::directory_iterator(directory))
+        if(entry.path().extension() == ".cso")
+            entries.push_back(entry.path());
+    return entries;
+}
+
+std::vector<uint8_t> ReadBytes(const fs::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), {});
+}
+
+void WriteBytes(const fs::path& path, const std::vector<uint8_t>& bytes)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write((const char*)bytes.data(), bytes.size());
+}
+
+struct Fixture
+{
+    fs::path     root;
+    fs::path     cacheDir;
+    fs::path     shader;
+    fs::path     common;
+    fs::path     nested;
+    ShaderCache  cache;
+    StubCompiler compiler;
+
+    Fixture()
+    {
+        root     = fs::temp_directory_path() / ("ShaderBeamCacheTest" + std::to_string(std::random_device()()));
+        cacheDir = root / "cache";
+        shader   = root / "Main.hlsl";
+        common   = root / "Include" / "Common.hlsli";
+        nested   = root / "Include" / "Nested.hlsli";
+        fs::create_directories(root / "Include");
+
+        // the include cycle must not recurse forever
+        WriteFile(shader, "#include \"Include/Common.hlsli\"\nfloat4 PSmain() : SV_Target { return COLOR; }\n");
+        WriteFile(common, "  #  include \"Nested.hlsli\"\n#include <Common.hlsli>\n#define COLOR float4(1, 0, 0, 1)\n");
+        WriteFile(nested, "static const float scale = 1.0;\n");
+        cache.SetDirectory(cacheDir);
+    }
+
+    ~Fixture()
+    {
+        std::error_code error;
+        fs::remove_all(root, error);
+    }
+
+    std::vector<uint8_t> Get(const ShaderMacros& macros = { { "HARDWARE_SRGB", "0" } },
+                             const std::string&  entryPoint = "PSmain",
+                             const std::string&  target     = "ps_5_0",
+                             const std::string&  version    = "47")
+    {
+        return cache.Get(shader, macros, entryPoint, target, version, compiler.Make());
+    }
+};
+
+void CheckHitAndMiss()
+{
+    Fixture fixture;
+
+    const auto first = fixture.Get();
+    CHECK(fixture.compiler.calls == 1);
+    CHECK(CacheEntries(fixture.cacheDir).size() == 1);
+
+    const auto second = fixture.Get();
+    CHECK(fixture.compiler.calls == 1);
+    CHECK(second == first);
+
+    // a fresh cache on the same directory, i.e. the next run
+    ShaderCache reopened;
+    reopened.SetDirectory(fixture.cacheDir);
+    CHECK(reopened.Get(fixture.shader, { { "HARDWARE_SRGB", "0" } }, "PSmain", "ps_5_0", "47", fixture.compiler.Make()) == first);
+    CHECK(fixture.compiler.calls == 1);
+
+    const auto stats = fixture.cache.GetStats();
+    CHECK(stats.compiled == 1 && stats.loaded == 1 && stats.rejected == 0);
+}
+
+void CheckKeys()
+{
+    Fixture fixture;
+    fixture.Get();
+    unsigned calls = fixture.compiler.calls;
+
+    // every part of the key gives a miss of its own, then a hit
+    auto missThenHit = [&](auto get) {
+        get();
+        CHECK(fixture.compiler.calls == ++calls);
+        get();
+        CHECK(fixture.compiler.calls == calls);
+    };
+    missThenHit([&] { return fixture.Get({ { "HARDWARE_SRGB", "1" } }); });
+    missThenHit([&] { return fixture.Get({ { "HARDWARE_SRGB", "0" }, { "COMPUTE_SHADER", "1" } }); });
+    missThenHit([&] { return fixture.Get({ { "A", "BC" } }); });
+    missThenHit([&] { return fixture.Get({ { "AB", "C" } }); });
+    missThenHit([&] { return fixture.Get({ { "HARDWARE_SRGB", "0" } }, "CSmain"); });
+    missThenHit([&] { return fixture.Get({ { "HARDWARE_SRGB", "0" } }, "PSmain", "ps_5_1"); });
+    missThenHit([&] { return fixture.Get({ { "HARDWARE_SRGB", "0" } }, "PSmain", "ps_5_0", "48"); });
+
+    // editing the source itself, a direct include and one included from there
+    const auto keyBefore = ShaderCache::HashSources(fixture.shader);
+    WriteFile(fixture.nested, "static const float scale = 2.0;\n");
+    CHECK(ShaderCache::HashSources(fixture.shader) != keyBefore);
+    missThenHit([&] { return fixture.Get(); });
+
+    WriteFile(fixture.common, "  #  include \"Nested.hlsli\"\n#define COLOR float4(0, 1, 0, 1)\n");
+    missThenHit([&] { return fixture.Get(); });
+
+    WriteFile(fixture.shader, "#include \"Include/Common.hlsli\"\nfloat4 PSmain() : SV_Target { return COLOR * 0.5; }\n");
+    missThenHit([&] { return fixture.Get(); });
+
+    // an include that goes missing changes the key too
+    fs::remove(fixture.nested);
+    missThenHit([&] { return fixture.Get(); });
+
+    // edits to files that aren't included don't matter
+    WriteFile(fixture.root / "Include" / "Unused.hlsli", "#define UNUSED 1\n");
+    fixture.Get();
+    CHECK(fixture.compiler.calls == calls);
+}
+
+void CheckCorruptEntries()
+{
+    Fixture fixture;
+    const auto good = fixture.Get();
+    CHECK(CacheEntries(fixture.cacheDir).size() == 1);
+    const auto entry    = CacheEntries(fixture.cacheDir)[0];
+    const auto original = ReadBytes(entry);
+    unsigned   calls    = fixture.compiler.calls;
+    unsigned   rejected = 0;
+
+    // each damaged entry is rejected, recompiled and written back whole so the next run hits again
+    auto damaged = [&](std::vector<uint8_t> bytes) {
+        WriteBytes(entry, bytes);
+        const auto bytecode = fixture.Get();
+        CHECK(fixture.compiler.calls == ++calls);
+        CHECK(fixture.cache.GetStats().rejected == ++rejected);
+        CHECK(!bytecode.empty() && bytecode != good);
+
+        fixture.Get();
+        CHECK(fixture.compiler.calls == calls);
+        CHECK(fixture.cache.GetStats().rejected == rejected);
+    };
+
+    auto truncated = original;
+    truncated.resize(original.size() - 5);
+    damaged(truncated);
+
+    auto headerOnly = original;
+    headerOnly.resize(12);
+    damaged(headerOnly);
+
+    auto flipped = original;
+    flipped.back() ^= 0x40;
+    damaged(flipped);
+
+    auto badMagic = original;
+    badMagic[0] ^= 0xff;
+    damaged(badMagic);
+
+    damaged({});
+
+    // no stray temporaries from the rewrites
+    for(const auto& file : fs::directory_iterator(fixture.cacheDir))
+        CHECK(file.path().extension() == ".cso");
+}
+
+void CheckFailuresAndNoDirectory()
+{
+    Fixture fixture;
+
+    // a failed compile leaves nothing behind
+    bool thrown = false;
+    try
+    {
+        fixture.cache.Get(fixture.shader, {}, "PSmain", "ps_5_0", "47", []() -> std::vector<uint8_t> { throw std::runtime_error("syntax error"); });
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(CacheEntries(fixture.cacheDir).empty());
+    fixture.cache.Get(fixture.shader, {}, "PSmain", "ps_5_0", "47", fixture.compiler.Make());
+    CHECK(fixture.compiler.calls == 1);
+
+    // without a directory everything is compiled
+    ShaderCache memoryOnly;
+    StubCompiler compiler;
+    memoryOnly.Get(fixture.shader, {}, "PSmain", "ps_5_0", "47", compiler.Make());
+    memoryOnly.Get(fixture.shader, {}, "PSmain", "ps_5_0", "47", compiler.Make());
+    CHECK(compiler.calls == 2);
+    CHECK(memoryOnly.GetStats().loaded == 0);
+}
+
+} // namespace
+
+int main()
+{
+    CheckHitAndMiss();
+    CheckKeys();
+    CheckCorruptEntries();
+    CheckFailuresAndNoDirectory();
+    return Report("ShaderCacheTest");
+}
@@ -0,0 +1,193 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// WakeupJitter statistics on known wakeups, and the SCHED_DEADLINE -> SCHED_FIFO -> nice fallback in an
+// unprivileged process, which has to give up quietly and leave the thread as it was
+
+#include <cmath>
+#include <exception>
+#include <string>
+#include <thread>
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../ThreadScheduler.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+
+namespace
+{
+
+bool Near(double value, double expected)
+{
+    return std::fabs(value - expected) < 1e-9;
+}
+
+void CheckJitter()
+{
+    WakeupJitter jitter;
+    CHECK(jitter.Count() == 0 && jitter.Mean() == 0 && jitter.StdDev() == 0 && jitter.Max() == 0);
+
+    // the first wakeup only sets the reference
+    jitter.AddWakeup(1000, 10);
+    CHECK(jitter.Count() == 0);
+
+    // 1 late, 1 early, a missed vsync 2 late, then 0.5 early: deviations 0, 1, 1, 2, 0.5
+    for(double time : { 1010.0, 1021.0, 1030.0, 1052.0, 1061.5 })
+        jitter.AddWakeup(time, 10);
+    CHECK(jitter.Count() == 5);
+    CHECK(Near(jitter.Mean(), 0.9));
+    CHECK(Near(jitter.StdDev(), std::sqrt(6.25 / 5 - 0.81)));
+    CHECK(Near(jitter.Max(), 2));
+
+    // a wakeup well short of the interval still counts as one interval
+    jitter.AddWakeup(1065.5, 10);
+    CHECK(jitter.Count() == 6 && Near(jitter.Max(), 6));
+
+    // without an expected interval nothing is counted, but the reference moves on
+    jitter.AddWakeup(2000, 0);
+    CHECK(jitter.Count() == 6);
+    jitter.AddWakeup(2010, 10);
+    CHECK(jitter.Count() == 7 && Near(jitter.Max(), 6));
+
+    // perfectly paced wakeups have no spread
+    jitter.Reset();
+    CHECK(jitter.Count() == 0 && jitter.Max() == 0);
+    for(int frame = 0; frame <= 100; frame++)
+        jitter.AddWakeup(frame * 16.0, 16);
+    CHECK(jitter.Count() == 100 && Near(jitter.Mean(), 0) && Near(jitter.StdDev(), 0) && Near(jitter.Max(), 0));
+}
+
+struct Applied
+{
+    bool        result { false };
+    bool        thrown { false };
+    std::string error;
+    int         policy { -1 };
+    int         nice { 0 };
+    cpu_set_t   cores {};
+};
+
+// applies the policy on a fresh thread and reports what the thread ended up with
+Applied Apply(const SchedulingPolicy& policy, ThreadRole role)
+{
+    Applied applied;
+    std::thread([&]() {
+        ThreadScheduler scheduler;
+        scheduler.SetPolicy(policy);
+        try
+        {
+            applied.result = scheduler.Apply(role);
+            scheduler.Release();
+        }
+        catch(...)
+        {
+            applied.thrown = true;
+        }
+        applied.error  = scheduler.GetLastError();
+        applied.policy = sched_getscheduler(0);
+        applied.nice   = getpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid));
+        sched_getaffinity(0, sizeof(applied.cores), &applied.cores);
+    }).join();
+    return applied;
+}
+
+bool StartsWith(const std::string& text, const std::string& prefix)
+{
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+void CheckUnprivileged()
+{
+    cpu_set_t allowed;
+    CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    int firstCore = 0;
+    while(firstCore < 63 && !CPU_ISSET(firstCore, &allowed))
+        firstCore++;
+    const int niceBefore = getpriority(PRIO_PROCESS, 0);
+
+    SchedulingPolicy policy;
+    policy.renderCores       = 1ull << firstCore;
+    policy.deadlinePeriodUs  = 16667;
+    policy.deadlineRuntimeUs = 4000;
+
+    // nothing to ask for, nothing to refuse
+    policy.schedulingClass = SCHEDULING_DEFAULT;
+    auto applied           = Apply(policy, ThreadRole::Render);
+    CHECK(applied.result && !applied.thrown && applied.error.empty());
+    CHECK(CPU_COUNT(&applied.cores) == 1 && CPU_ISSET(firstCore, &applied.cores));
+
+    // every class that needs privileges ends up refused by the last fallback, renicing
+    for(int schedulingClass : { SCHEDULING_HIGH, SCHEDULING_REALTIME, SCHEDULING_DEADLINE })
+    {
+        policy.schedulingClass = schedulingClass;
+        for(auto role : { ThreadRole::Render, ThreadRole::Capture, ThreadRole::Worker })
+        {
+            applied = Apply(policy, role);
+            CHECK(!applied.thrown);
+            CHECK(!applied.result);
+            CHECK(StartsWith(applied.error, "Unable to set thread priority"));
+            CHECK(applied.policy == SCHED_OTHER);
+            CHECK(applied.nice == niceBefore);
+        }
+    }
+
+    // affinity doesn't need privileges and is kept even though the priority was refused, except under
+    // SCHED_DEADLINE which doesn't allow it
+    policy.schedulingClass = SCHEDULING_REALTIME;
+    applied                = Apply(policy, ThreadRole::Render);
+    CHECK(CPU_COUNT(&applied.cores) == 1 && CPU_ISSET(firstCore, &applied.cores));
+    policy.schedulingClass = SCHEDULING_DEADLINE;
+    applied                = Apply(policy, ThreadRole::Render);
+    CHECK(CPU_EQUAL(&applied.cores, &allowed));
+
+    // the UI thread is never boosted, so it can't fail
+    applied = Apply(policy, ThreadRole::UI);
+    CHECK(applied.result && !applied.thrown && applied.error.empty());
+}
+
+// runs the unprivileged checks in a child that has dropped root and any rlimit allowance for raising priority
+void CheckFallback()
+{
+    fflush(stdout);
+    fflush(stderr);
+    auto child = fork();
+    CHECK(child >= 0);
+    if(child == 0)
+    {
+        rlimit none { 0, 0 };
+        setrlimit(RLIMIT_NICE, &none);
+        setrlimit(RLIMIT_RTPRIO, &none);
+        if(geteuid() == 0 && (setgid(65534) != 0 || setuid(65534) != 0))
+        {
+            fprintf(stderr, "ThreadSchedulerTest: unable to drop root\n");
+            _exit(1);
+        }
+        CheckUnprivileged();
+        fflush(stderr);
+        _exit(g_failures);
+    }
+
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status));
+    g_failures += WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+} // namespace
+
+int main()
+{
+    CheckJitter();
+    CheckFallback();
+    return Report("ThreadSchedulerTest");
+}
@@ -0,0 +1,104 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+// TileHasher classification, for CPU-hashed frames and for hashes computed on the GPU
+
+#include <random>
+#include <vector>
+
+#include "../TileHasher.h"
+#include "../WorkerPool.h"
+#include "Check.h"
+
+using namespace ShaderBeam;
+
+static void CheckHash(WorkerPool& pool)
+{
+    const int            width = 300, height = 200, bpp = 4;
+    const size_t         pitch = width * bpp + 16;
+    std::mt19937         random(7);
+    std::vector<uint8_t> frame(pitch * height);
+    for(auto& b : frame)
+        b = (uint8_t)random();
+
+    DirtyRegions full;
+    full.Reset(width, height);
+    full.SetFull();
+
+    TileHasher hasher(pool);
+    hasher.Reset(width, height, bpp);
+    CHECK(hasher.GetTilesX() == 5 && hasher.GetTilesY() == 4);
+    CHECK(hasher.Hash(frame.data(), pitch, full) == FrameContent::New);
+    CHECK(hasher.Hash(frame.data(), pitch, full) == FrameContent::Identical);
+    CHECK(hasher.GetNumChanged() == 0);
+
+    // one pixel in the last (partial) tile
+    frame[(height - 1) * pitch + (width - 1) * bpp] ^= 1;
+    CHECK(hasher.Hash(frame.data(), pitch, full) == FrameContent::Partial);
+    CHECK(hasher.GetNumChanged() == 1);
+    CHECK(hasher.GetChangedTiles().back() == 1);
+
+    // padding past the row isn't part of the frame
+    frame[pitch - 1] ^= 1;
+    CHECK(hasher.Hash(frame.data(), pitch, full) == FrameContent::Identical);
+
+    hasher.Invalidate();
+    CHECK(hasher.GetNumChanged() == hasher.GetTilesX() * hasher.GetTilesY());
+    CHECK(hasher.Hash(frame.data(), pitch, full) == FrameContent::New);
+}
+
+static void CheckCompare(WorkerPool& pool)
+{
+    TileHasher hasher(pool);
+    hasher.Reset(1920, 1080, 4);
+    const size_t tiles = (size_t)hasher.GetTilesX() * hasher.GetTilesY();
+
+    std::vector<uint64_t> hashes(tiles);
+    for(size_t tile = 0; tile < tiles; tile++)
+        hashes[tile] = tile * 0x9e3779b97f4a7c15ull;
+
+    CHECK(hasher.Compare(hashes) == FrameContent::New);
+    CHECK(hasher.Compare(hashes) == FrameContent::Identical);
+
+    hashes[3]++;
+    CHECK(hasher.Compare(hashes) == FrameContent::Partial);
+    CHECK(hasher.GetNumChanged() == 1 && hasher.GetChangedTiles()[3] == 1);
+    CHECK(hasher.GetChangedRegions().GetRects().size() == 1);
+
+    // beyond DIRTY_FULL_COVERAGE it's simpler to treat it as a new frame
+    for(auto& hash : hashes)
+        hash++;
+    CHECK(hasher.Compare(hashes) == FrameContent::New);
+
+    // frame shown before its hashes came back, they're still compared against the one before
+    hasher.MarkAllChanged();
+    CHECK(hasher.GetNumChanged() == tiles);
+    hashes[5]++;
+    CHECK(hasher.Compare(hashes) == FrameContent::Partial);
+    CHECK(hasher.GetNumChanged() == 1);
+
+    // a missed readback leaves no baseline, the next one becomes it
+    hasher.Invalidate();
+    CHECK(hasher.Compare(hashes) == FrameContent::New);
+    CHECK(hasher.Compare(hashes) == FrameContent::Identical);
+
+    // grid from a different size can't be compared
+    hashes.pop_back();
+    CHECK(hasher.Compare(hashes) == FrameContent::New);
+}
+
+int main()
+{
+    for(auto threads : { 0u, 3u })
+    {
+        WorkerPool pool;
+        pool.Start(threads);
+        CheckHash(pool);
+        CheckCompare(pool);
+    }
+    return Report("TileHasherTest");
+}
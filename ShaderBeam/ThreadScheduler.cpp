@@ -0,0 +1,291 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "ThreadScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    define NOMINMAX
+#    include <windows.h>
+#    include <avrt.h>
+#else
+#    include <pthread.h>
+#    include <sched.h>
+#    include <sys/resource.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    include <cerrno>
+#    include <cstring>
+#endif
+
+namespace ShaderBeam
+{
+
+void WakeupJitter::Reset()
+{
+    m_lastWakeup = -1.0;
+    m_sum        = 0;
+    m_sumSquares = 0;
+    m_max        = 0;
+    m_count      = 0;
+}
+
+void WakeupJitter::AddWakeup(double timeMs, double expectedIntervalMs)
+{
+    if(m_lastWakeup >= 0 && expectedIntervalMs > 0)
+    {
+        // deviation from the expected interval, missed vsyncs count as multiples of it
+        auto interval  = timeMs - m_lastWakeup;
+        auto intervals = std::max(1.0, std::round(interval / expectedIntervalMs));
+        auto deviation = std::fabs(interval - intervals * expectedIntervalMs);
+        m_sum += deviation;
+        m_sumSquares += deviation * deviation;
+        m_max = std::max(m_max, deviation);
+        m_count++;
+    }
+    m_lastWakeup = timeMs;
+}
+
+double WakeupJitter::Mean() const
+{
+    return m_count ? m_sum / m_count : 0;
+}
+
+double WakeupJitter::StdDev() const
+{
+    if(m_count == 0)
+        return 0;
+
+    auto mean = Mean();
+    return std::sqrt(std::max(0.0, m_sumSquares / m_count - mean * mean));
+}
+
+double WakeupJitter::Max() const
+{
+    return m_max;
+}
+
+uint64_t WakeupJitter::Count() const
+{
+    return m_count;
+}
+
+void ThreadScheduler::SetPolicy(const SchedulingPolicy& policy)
+{
+    m_policy = policy;
+}
+
+const SchedulingPolicy& ThreadScheduler::GetPolicy() const
+{
+    return m_policy;
+}
+
+const std::string& ThreadScheduler::GetLastError() const
+{
+    return m_lastError;
+}
+
+uint64_t ThreadScheduler::GetAllCores()
+{
+    auto numCores = std::min(std::thread::hardware_concurrency(), 64u);
+    return numCores >= 64 ? ~0ull : ((1ull << numCores) - 1);
+}
+
+uint64_t ThreadScheduler::GetCores(ThreadRole role) const
+{
+    switch(role)
+    {
+    case ThreadRole::Render:
+        return m_policy.renderCores;
+    case ThreadRole::Capture:
+        return m_policy.captureCores;
+    case ThreadRole::Worker:
+        return m_policy.workerCores;
+    case ThreadRole::UI:
+        // anything not reserved (nothing left means any core)
+        return m_policy.isolateUI ? GetAllCores() & ~GetReservedCores() : 0;
+    }
+    return 0;
+}
+
+uint64_t ThreadScheduler::GetReservedCores() const
+{
+    return m_policy.renderCores | m_policy.captureCores | m_policy.workerCores;
+}
+
+bool ThreadScheduler::Apply(ThreadRole role)
+{
+    m_lastError.clear();
+
+    bool result = true;
+    if(m_policy.schedulingClass != SCHEDULING_DEADLINE || role == ThreadRole::UI)
+    {
+        // SCHED_DEADLINE threads can't have a restricted affinity
+        auto cores = GetCores(role) & GetAllCores();
+        if(cores)
+            result &= SetAffinity(cores);
+    }
+    result &= SetPriority(role);
+    return result;
+}
+
+#ifdef _WIN32
+
+static thread_local HANDLE s_mmcssHandle = NULL;
+
+bool ThreadScheduler::SetAffinity(uint64_t cores)
+{
+    if(SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)cores) == 0)
+    {
+        m_lastError = "Unable to set thread affinity";
+        return false;
+    }
+    return true;
+}
+
+bool ThreadScheduler::SetPriority(ThreadRole role)
+{
+    if(role == ThreadRole::UI || m_policy.schedulingClass == SCHEDULING_DEFAULT)
+        return true;
+
+    if(m_policy.schedulingClass >= SCHEDULING_REALTIME && role != ThreadRole::Worker && s_mmcssHandle == NULL)
+    {
+        // let MMCSS boost us, it also keeps us ahead of the game's own threads
+        DWORD taskIndex = 0;
+        s_mmcssHandle   = AvSetMmThreadCharacteristicsW(role == ThreadRole::Render ? L"Games" : L"Capture", &taskIndex);
+        if(s_mmcssHandle)
+            return AvSetMmThreadPriority(s_mmcssHandle, role == ThreadRole::Render ? AVRT_PRIORITY_CRITICAL : AVRT_PRIORITY_HIGH) != FALSE;
+
+        m_lastError = "Unable to register thread with MMCSS";
+    }
+
+    int priority = THREAD_PRIORITY_HIGHEST;
+    switch(role)
+    {
+    case ThreadRole::Render:
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+        break;
+    case ThreadRole::Capture:
+        priority = THREAD_PRIORITY_HIGHEST;
+        break;
+    case ThreadRole::Worker:
+        priority = THREAD_PRIORITY_ABOVE_NORMAL;
+        break;
+    }
+    if(!SetThreadPriority(GetCurrentThread(), priority))
+    {
+        m_lastError = "Unable to set thread priority";
+        return false;
+    }
+    return true;
+}
+
+void ThreadScheduler::Release()
+{
+    if(s_mmcssHandle)
+    {
+        AvRevertMmThreadCharacteristics(s_mmcssHandle);
+        s_mmcssHandle = NULL;
+    }
+}
+
+#else
+
+#    ifndef SCHED_DEADLINE
+#        define SCHED_DEADLINE 6
+#    endif
+
+// not exposed by older glibc
+struct SchedAttr
+{
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t  sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+bool ThreadScheduler::SetAffinity(uint64_t cores)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int core = 0; core < 64; core++)
+    {
+        if(cores & (1ull << core))
+            CPU_SET(core, &set);
+    }
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+        m_lastError = "Unable to set thread affinity";
+        return false;
+    }
+    return true;
+}
+
+bool ThreadScheduler::SetPriority(ThreadRole role)
+{
+    if(role == ThreadRole::UI || m_policy.schedulingClass == SCHEDULING_DEFAULT)
+        return true;
+
+    if(m_policy.schedulingClass == SCHEDULING_DEADLINE && role == ThreadRole::Render && m_policy.deadlinePeriodUs && m_policy.deadlineRuntimeUs)
+    {
+        SchedAttr attr {};
+        attr.size           = sizeof(attr);
+        attr.sched_policy   = SCHED_DEADLINE;
+        attr.sched_runtime  = m_policy.deadlineRuntimeUs * 1000ull;
+        attr.sched_deadline = m_policy.deadlinePeriodUs * 1000ull;
+        attr.sched_period   = m_policy.deadlinePeriodUs * 1000ull;
+        if(syscall(SYS_sched_setattr, 0, &attr, 0) == 0)
+            return true;
+
+        m_lastError = std::string("Unable to set SCHED_DEADLINE: ") + strerror(errno);
+        // fall back to FIFO below
+    }
+
+    if(m_policy.schedulingClass >= SCHEDULING_REALTIME)
+    {
+        sched_param param {};
+        switch(role)
+        {
+        case ThreadRole::Render:
+            param.sched_priority = 80;
+            break;
+        case ThreadRole::Capture:
+            param.sched_priority = 70;
+            break;
+        default:
+            param.sched_priority = 60;
+            break;
+        }
+        if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+            return true;
+
+        m_lastError = std::string("Unable to set SCHED_FIFO: ") + strerror(errno);
+    }
+
+    // high class, or no permission for realtime: just renice
+    int nice = role == ThreadRole::Worker ? -5 : -10;
+    if(setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice) != 0)
+    {
+        m_lastError = std::string("Unable to set thread priority: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void ThreadScheduler::Release() { }
+
+#endif
+
+} // namespace ShaderBeam
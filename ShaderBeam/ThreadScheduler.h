@@ -0,0 +1,85 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so pacing code can be exercised on Linux too
+
+#include <cstdint>
+#include <string>
+
+namespace ShaderBeam
+{
+
+enum class ThreadRole
+{
+    Render,
+    Capture,
+    Worker,
+    UI
+};
+
+constexpr int SCHEDULING_DEFAULT  = 0;
+constexpr int SCHEDULING_HIGH     = 1;
+constexpr int SCHEDULING_REALTIME = 2; // MMCSS on Windows, SCHED_FIFO on Linux
+constexpr int SCHEDULING_DEADLINE = 3; // SCHED_DEADLINE on Linux, same as realtime on Windows
+
+struct SchedulingPolicy
+{
+    int      schedulingClass { SCHEDULING_HIGH };
+    uint64_t renderCores { 0 }; // affinity masks, 0 = any core
+    uint64_t captureCores { 0 };
+    uint64_t workerCores { 0 };
+    bool     isolateUI { true }; // keep UI thread off cores reserved above
+    unsigned deadlinePeriodUs { 0 }; // SCHED_DEADLINE period, normally one vsync
+    unsigned deadlineRuntimeUs { 0 }; // SCHED_DEADLINE budget within the period
+};
+
+class WakeupJitter
+{
+public:
+    void Reset();
+    void AddWakeup(double timeMs, double expectedIntervalMs);
+
+    double   Mean() const;
+    double   StdDev() const;
+    double   Max() const;
+    uint64_t Count() const;
+
+private:
+    double   m_lastWakeup { -1.0 };
+    double   m_sum { 0 };
+    double   m_sumSquares { 0 };
+    double   m_max { 0 };
+    uint64_t m_count { 0 };
+};
+
+class ThreadScheduler
+{
+public:
+    void                    SetPolicy(const SchedulingPolicy& policy);
+    const SchedulingPolicy& GetPolicy() const;
+
+    // apply the policy for given role to the calling thread, returns false if OS refused (usually privileges)
+    bool Apply(ThreadRole role);
+    // undo anything that has to be released before the calling thread exits
+    void Release();
+
+    const std::string& GetLastError() const;
+
+    static uint64_t GetAllCores();
+
+private:
+    SchedulingPolicy m_policy;
+    std::string      m_lastError;
+
+    uint64_t GetCores(ThreadRole role) const;
+    uint64_t GetReservedCores() const;
+    bool     SetAffinity(uint64_t cores);
+    bool     SetPriority(ThreadRole role);
+};
+} // namespace ShaderBeam
@@ -0,0 +1,269 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "TileHasher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#    include <emmintrin.h>
+#    define TILE_HASHER_SSE2
+#endif
+
+namespace ShaderBeam
+{
+
+// multiply-accumulate over 64-bit lanes like XXH3, keys advance per block so moved pixels hash differently
+static constexpr uint64_t HASH_KEY0  = 0x9e3779b185ebca87ull;
+static constexpr uint64_t HASH_KEY1  = 0xc2b2ae3d27d4eb4full;
+static constexpr uint64_t HASH_KEY2  = 0x165667b19e3779f9ull;
+static constexpr uint64_t HASH_KEY3  = 0x85ebca77c2b2ae63ull;
+static constexpr uint64_t HASH_STEP  = 0x27d4eb2f165667c5ull;
+static constexpr size_t   HASH_BLOCK = 32;
+
+static uint64_t Mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+#ifndef TILE_HASHER_SSE2
+static void AccumulateLane(uint64_t& acc, uint64_t value, uint64_t other, uint64_t key)
+{
+    auto keyed = value ^ key;
+    acc += (keyed & 0xffffffffull) * (keyed >> 32) + other;
+}
+#endif
+
+TileHasher::TileHasher(WorkerPool& pool) : m_pool(pool) { }
+
+void TileHasher::Reset(int width, int height, unsigned bytesPerPixel)
+{
+    m_width         = std::max(width, 0);
+    m_height        = std::max(height, 0);
+    m_bytesPerPixel = bytesPerPixel;
+    m_tilesX        = (m_width + HASH_TILE_SIZE - 1) / HASH_TILE_SIZE;
+    m_tilesY        = (m_height + HASH_TILE_SIZE - 1) / HASH_TILE_SIZE;
+    m_numChanged    = 0;
+    m_valid         = false;
+    m_hashes.assign(m_tilesX * m_tilesY, 0);
+    m_changed.assign(m_tilesX * m_tilesY, 1);
+    m_selected.assign(m_tilesX * m_tilesY, 0);
+}
+
+FrameContent TileHasher::Hash(const uint8_t* data, size_t pitch, const DirtyRegions& regions)
+{
+    if(!m_tilesX || !m_tilesY)
+        return FrameContent::New;
+
+    // pick tiles worth looking at, without previous hashes it has to be all of them
+    if(!m_valid || regions.IsFull())
+    {
+        std::fill(m_selected.begin(), m_selected.end(), (uint8_t)1);
+    }
+    else
+    {
+        std::fill(m_selected.begin(), m_selected.end(), (uint8_t)0);
+        for(const auto& rect : regions.GetRects())
+        {
+            if(rect.IsEmpty())
+                continue;
+            const unsigned x0 = std::max(rect.left, 0) / HASH_TILE_SIZE;
+            const unsigned y0 = std::max(rect.top, 0) / HASH_TILE_SIZE;
+            const unsigned x1 = std::min((unsigned)(rect.right - 1) / HASH_TILE_SIZE, m_tilesX - 1);
+            const unsigned y1 = std::min((unsigned)(rect.bottom - 1) / HASH_TILE_SIZE, m_tilesY - 1);
+            for(unsigned y = y0; y <= y1; y++)
+                std::fill(m_selected.begin() + y * m_tilesX + x0, m_selected.begin() + y * m_tilesX + x1 + 1, (uint8_t)1);
+        }
+    }
+
+    // a row of tiles per task, they share cache lines within a row anyway
+    const bool valid = m_valid;
+    m_pool.Run(m_tilesY, [&](unsigned tileY) {
+        const unsigned top  = tileY * HASH_TILE_SIZE;
+        const unsigned rows = std::min(HASH_TILE_SIZE, (unsigned)m_height - top);
+        for(unsigned tileX = 0; tileX < m_tilesX; tileX++)
+        {
+            const auto index = tileY * m_tilesX + tileX;
+            if(!m_selected[index])
+            {
+                m_changed[index] = 0;
+                continue;
+            }
+
+            const unsigned left    = tileX * HASH_TILE_SIZE;
+            const unsigned columns = std::min(HASH_TILE_SIZE, (unsigned)m_width - left);
+            const auto     hash    = HashTile(data + top * pitch + left * m_bytesPerPixel, pitch, columns * m_bytesPerPixel, rows);
+            m_changed[index]       = !valid || hash != m_hashes[index];
+            m_hashes[index]        = hash;
+        }
+    });
+
+    return Classify(valid);
+}
+
+FrameContent TileHasher::Compare(const std::vector<uint64_t>& hashes)
+{
+    if(!m_tilesX || !m_tilesY || hashes.size() != m_hashes.size())
+        return FrameContent::New;
+
+    const bool valid = m_valid;
+    for(size_t index = 0; index < m_hashes.size(); index++)
+    {
+        m_changed[index] = !valid || hashes[index] != m_hashes[index];
+        m_hashes[index]  = hashes[index];
+    }
+    return Classify(valid);
+}
+
+void TileHasher::Invalidate()
+{
+    m_valid = false;
+    MarkAllChanged();
+}
+
+void TileHasher::MarkAllChanged()
+{
+    m_numChanged = (unsigned)m_changed.size();
+    std::fill(m_changed.begin(), m_changed.end(), (uint8_t)1);
+}
+
+FrameContent TileHasher::Classify(bool valid)
+{
+    m_numChanged = (unsigned)std::count(m_changed.begin(), m_changed.end(), (uint8_t)1);
+    m_valid      = true;
+
+    if(!valid)
+        return FrameContent::New;
+    if(m_numChanged == 0)
+        return FrameContent::Identical;
+    if(m_numChanged > DIRTY_FULL_COVERAGE * m_changed.size())
+        return FrameContent::New;
+    return FrameContent::Partial;
+}
+
+const std::vector<uint8_t>& TileHasher::GetChangedTiles() const
+{
+    return m_changed;
+}
+
+unsigned TileHasher::GetTilesX() const
+{
+    return m_tilesX;
+}
+
+unsigned TileHasher::GetTilesY() const
+{
+    return m_tilesY;
+}
+
+unsigned TileHasher::GetNumChanged() const
+{
+    return m_numChanged;
+}
+
+DirtyRegions TileHasher::GetChangedRegions() const
+{
+    DirtyRegions regions;
+    regions.Reset(m_width, m_height);
+    for(unsigned tileY = 0; tileY < m_tilesY; tileY++)
+    {
+        // runs of changed tiles in a row go in as one rect
+        unsigned tileX = 0;
+        while(tileX < m_tilesX)
+        {
+            if(!m_changed[tileY * m_tilesX + tileX])
+            {
+                tileX++;
+                continue;
+            }
+            const unsigned first = tileX;
+            while(tileX < m_tilesX && m_changed[tileY * m_tilesX + tileX])
+                tileX++;
+            regions.Add({ (int)(first * HASH_TILE_SIZE), (int)(tileY * HASH_TILE_SIZE), (int)(tileX * HASH_TILE_SIZE), (int)((tileY + 1) * HASH_TILE_SIZE) });
+        }
+    }
+    return regions;
+}
+
+uint64_t TileHasher::HashTile(const uint8_t* data, size_t pitch, size_t rowBytes, unsigned rows)
+{
+    uint64_t tail = 0;
+    uint64_t lanes[4];
+
+#ifdef TILE_HASHER_SSE2
+    auto       acc0 = _mm_set_epi64x((long long)HASH_KEY1, (long long)HASH_KEY0);
+    auto       acc1 = _mm_set_epi64x((long long)HASH_KEY3, (long long)HASH_KEY2);
+    auto       key0 = acc0;
+    auto       key1 = acc1;
+    const auto step = _mm_set1_epi64x((long long)HASH_STEP);
+
+    for(unsigned row = 0; row < rows; row++)
+    {
+        const uint8_t* p     = data + row * pitch;
+        size_t         bytes = rowBytes;
+        while(bytes >= HASH_BLOCK)
+        {
+            auto d0 = _mm_loadu_si128((const __m128i*)p);
+            auto d1 = _mm_loadu_si128((const __m128i*)(p + 16));
+            auto k0 = _mm_xor_si128(d0, key0);
+            auto k1 = _mm_xor_si128(d1, key1);
+            // low * high half of each keyed lane, plus the neighbouring lane as is
+            acc0 = _mm_add_epi64(acc0, _mm_mul_epu32(k0, _mm_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1))));
+            acc1 = _mm_add_epi64(acc1, _mm_mul_epu32(k1, _mm_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1))));
+            acc0 = _mm_add_epi64(acc0, _mm_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2)));
+            acc1 = _mm_add_epi64(acc1, _mm_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2)));
+            key0 = _mm_add_epi64(key0, step);
+            key1 = _mm_add_epi64(key1, step);
+            p += HASH_BLOCK;
+            bytes -= HASH_BLOCK;
+        }
+
+        // tiles at the right edge may not fill a block
+        for(size_t i = 0; i < bytes; i++)
+            tail = (tail ^ p[i]) * 0x100000001b3ull;
+    }
+    _mm_storeu_si128((__m128i*)lanes, acc0);
+    _mm_storeu_si128((__m128i*)(lanes + 2), acc1);
+#else
+    uint64_t acc[4] = { HASH_KEY0, HASH_KEY1, HASH_KEY2, HASH_KEY3 };
+    uint64_t key[4] = { HASH_KEY0, HASH_KEY1, HASH_KEY2, HASH_KEY3 };
+
+    for(unsigned row = 0; row < rows; row++)
+    {
+        const uint8_t* p     = data + row * pitch;
+        size_t         bytes = rowBytes;
+        while(bytes >= HASH_BLOCK)
+        {
+            uint64_t d[4];
+            memcpy(d, p, sizeof(d));
+            AccumulateLane(acc[0], d[0], d[1], key[0]);
+            AccumulateLane(acc[1], d[1], d[0], key[1]);
+            AccumulateLane(acc[2], d[2], d[3], key[2]);
+            AccumulateLane(acc[3], d[3], d[2], key[3]);
+            for(auto& k : key)
+                k += HASH_STEP;
+            p += HASH_BLOCK;
+            bytes -= HASH_BLOCK;
+        }
+
+        for(size_t i = 0; i < bytes; i++)
+            tail = (tail ^ p[i]) * 0x100000001b3ull;
+    }
+    memcpy(lanes, acc, sizeof(lanes));
+#endif
+
+    auto hash = Mix(lanes[0] ^ Mix(lanes[1] ^ Mix(lanes[2] ^ Mix(lanes[3] ^ tail))));
+    return Mix(hash ^ (rowBytes * rows));
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,78 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DirtyRegions.h"
+#include "WorkerPool.h"
+
+namespace ShaderBeam
+{
+
+// tile edge in pixels, small enough for a cursor to touch only a few
+constexpr unsigned HASH_TILE_SIZE = 64;
+
+enum class FrameContent
+{
+    Identical,
+    Partial,
+    New
+};
+
+// hashes a mapped frame tile by tile and compares against the previous frame to find what really changed
+class TileHasher
+{
+public:
+    explicit TileHasher(WorkerPool& pool);
+
+    void Reset(int width, int height, unsigned bytesPerPixel);
+
+    // only tiles touching regions are hashed, the rest are known to be unchanged
+    FrameContent Hash(const uint8_t* data, size_t pitch, const DirtyRegions& regions);
+
+    // same classification for hashes computed elsewhere (e.g. on the GPU), one per tile, row-major
+    FrameContent Compare(const std::vector<uint64_t>& hashes);
+
+    // hashes kept no longer describe the last frame delivered, next one counts as new
+    void Invalidate();
+
+    // frame went out before its hashes were known, baseline stays for when they arrive
+    void MarkAllChanged();
+
+    // one entry per tile, row-major, non-zero when tile changed in the last Hash or Compare
+    const std::vector<uint8_t>& GetChangedTiles() const;
+    unsigned                    GetTilesX() const;
+    unsigned                    GetTilesY() const;
+    unsigned                    GetNumChanged() const;
+
+    // changed tiles as regions, clipped to the frame
+    DirtyRegions GetChangedRegions() const;
+
+    static uint64_t HashTile(const uint8_t* data, size_t pitch, size_t rowBytes, unsigned rows);
+
+private:
+    WorkerPool&           m_pool;
+    int                   m_width { 0 };
+    int                   m_height { 0 };
+    unsigned              m_bytesPerPixel { 4 };
+    unsigned              m_tilesX { 0 };
+    unsigned              m_tilesY { 0 };
+    unsigned              m_numChanged { 0 };
+    bool                  m_valid { false }; // hashes of a previous frame are present
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint8_t>  m_changed;
+    std::vector<uint8_t>  m_selected;
+
+    FrameContent Classify(bool valid);
+};
+} // namespace ShaderBeam
@@ -0,0 +1,75 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "TransientTargetPool.h"
+#include "Helpers.h"
+
+namespace ShaderBeam
+{
+
+void TransientTargetPool::Allocate(const RenderContext& renderContext, const std::vector<TargetDesc>& slots)
+{
+    Destroy();
+    m_resources = renderContext.resources;
+
+    static const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    for(const auto& desc : slots)
+    {
+        D3D11_TEXTURE2D_DESC textureDesc {};
+        textureDesc.Width              = desc.width;
+        textureDesc.Height             = desc.height;
+        textureDesc.ArraySize          = 1;
+        textureDesc.Format             = (DXGI_FORMAT)desc.format;
+        textureDesc.SampleDesc.Count   = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.MipLevels          = 1;
+        textureDesc.MiscFlags          = 0;
+        textureDesc.CPUAccessFlags     = 0;
+        textureDesc.Usage              = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+
+        auto& slot   = m_slots.emplace_back();
+        slot.desc    = desc;
+        slot.texture = m_resources->AcquireTexture(renderContext.device.get(), textureDesc);
+        THROW(renderContext.device->CreateShaderResourceView(slot.texture.get(), nullptr, slot.view.put()), "Unable to create pass target view");
+        THROW(renderContext.device->CreateRenderTargetView(slot.texture.get(), nullptr, slot.target.put()), "Unable to create pass target");
+        renderContext.deviceContext->ClearRenderTargetView(slot.target.get(), black);
+    }
+}
+
+void TransientTargetPool::Destroy()
+{
+    for(auto& slot : m_slots)
+    {
+        slot.target = nullptr;
+        slot.view   = nullptr;
+        m_resources->Release(slot.texture);
+    }
+    m_slots.clear();
+}
+
+ID3D11ShaderResourceView* TransientTargetPool::GetView(int slot) const
+{
+    return m_slots[slot].view.get();
+}
+
+ID3D11RenderTargetView* TransientTargetPool::GetTarget(int slot) const
+{
+    return m_slots[slot].target.get();
+}
+
+size_t TransientTargetPool::GetBytes() const
+{
+    size_t bytes = 0;
+    for(const auto& slot : m_slots)
+        bytes += slot.desc.GetBytes();
+    return bytes;
+}
+
+} // namespace ShaderBeam
@@ -0,0 +1,41 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+#include "RenderContext.h"
+#include "PassGraph.h"
+
+namespace ShaderBeam
+{
+
+// render targets behind pass graph slots, several intermediates share one when their lifetimes don't overlap
+class TransientTargetPool
+{
+public:
+    // textures come from (and go back to) the renderer's resource pool, so a resize or restart gets them back where descs match
+    void Allocate(const RenderContext& renderContext, const std::vector<TargetDesc>& slots);
+    void Destroy();
+
+    ID3D11ShaderResourceView* GetView(int slot) const;
+    ID3D11RenderTargetView*   GetTarget(int slot) const;
+    size_t                    GetBytes() const;
+
+private:
+    struct PooledTarget
+    {
+        TargetDesc                               desc;
+        winrt::com_ptr<ID3D11Texture2D>          texture;
+        winrt::com_ptr<ID3D11ShaderResourceView> view;
+        winrt::com_ptr<ID3D11RenderTargetView>   target;
+    };
+
+    std::vector<PooledTarget> m_slots;
+    ResourcePool*             m_resources { nullptr };
+};
+} // namespace ShaderBeam
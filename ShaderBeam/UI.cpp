@@ -100,6 +100,7 @@ void UI::Start(HWND window, float scale, winrt::com_ptr<ID3D11Device> device, wi
 
     m_errorMessage.clear();
     m_ready = true;
+    Invalidate();
 }
 
 bool UI::MouseRequired()
@@ -111,7 +112,10 @@ bool UI::Input(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
     try
     {
-        return m_ready && m_options.ui && ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam);
+        if(!m_ready || !m_options.ui)
+            return false;
+        Invalidate();
+        return ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam);
     }
     catch(...)
     { }
@@ -120,7 +124,7 @@ bool UI::Input(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 bool UI::RenderRequired() const
 {
-    return m_ready && (m_options.ui || m_options.banner);
+    return m_ready && (m_options.ui || m_immediate.banner);
 }
 
 static void ShowHelpMarker(const char* desc)
@@ -215,7 +219,8 @@ void UI::Render()
                 PostMessage(m_options.outputWindow, WM_DESTROY, 0, 0);
 
             ImGui::SameLine();
-            ImGui::Checkbox("Show Banner", &m_options.banner);
+            if(ImGui::Checkbox("Show Banner", &m_immediate.banner))
+                SubmitChanges(false);
             ShowHelpMarker("Helps you confirm if ShaderBeam is in front of the game. Press 'Force on top' hotkey when it isn't.");
 
             ////////////////////////////////////////////////
@@ -240,9 +245,104 @@ void UI::Render()
             ImGui::Text("                    Captured FPS: %7.02f", m_inputFPS);
             ShowHelpMarker("Provided by capture API.\nCan vary, ideally should be same as Content FPS (if it's higher, frame-limit your game to Content FPS using RTSS).");
 
+            ImGui::Text("     Jitter: %7.02f ms", m_wakeupJitter);
+            ShowHelpMarker("Render thread wake-up jitter (standard deviation from VSync).\nSee [scheduling] section of ShaderBeam.ini to pin threads to cores or use realtime priority.");
+            ImGui::SameLine();
+            ImGui::Text("                      Max Jitter: %7.02f ms", m_wakeupJitterMax);
+
+            if(m_options.crossAdapter)
+            {
+                ImGui::Text("   Readback: %7.02f queued", m_readbackQueue);
+                ShowHelpMarker("Average frames in flight between capture and render GPU.\n"
+                               "Set readbackDepth in [capture] section of ShaderBeam.ini:\n1 = lowest latency but render waits for capture GPU, 2-4 = never waits.");
+                ImGui::SameLine();
+                ImGui::Text("                       Dropped: %7.02f /s", m_readbackDrops);
+            }
+
+            if(m_transferShare < 0.999f)
+            {
+                ImGui::Text("   Transfer: %7.02f %%", m_transferShare * 100.0f);
+                ShowHelpMarker("Average share of each frame copied.\nDesktop Duplication reports which parts of the screen changed, only those are transferred.");
+            }
+
+            if(m_duplicateFrames > 0)
+            {
+                ImGui::Text("  Duplicate: %7.02f /s", m_duplicateFrames);
+                ShowHelpMarker("Captured frames identical to the previous one (e.g. only the cursor moved).\nThey are dropped so they don't take up input history.");
+            }
+
+            if(m_recordedFPS > 0 || m_recordDrops > 0)
+            {
+                ImGui::Text("  Recording: %7.02f /s", m_recordedFPS);
+                ShowHelpMarker("Shaded subframes written to recordFile (see [record] section of ShaderBeam.ini).\n"
+                               "When readback or disk can't keep up subframes are dropped, try recordEvery or a larger recordDepth.");
+                ImGui::SameLine();
+                ImGui::Text("                       Dropped: %7.02f /s", m_recordDrops);
+                ImGui::Text("    Written: %7.0f MB", m_recordedMB);
+            }
+
+            const auto& captureCounters = m_captureStats.GetCounters();
+            if(captureCounters.polls && ImGui::TreeNode("Capture Statistics"))
+            {
+                ImGui::Text("  Delivered: %7.02f /s", captureCounters.delivered / m_captureSeconds);
+                ShowHelpMarker("Frames from capture API that went into inputs.");
+                ImGui::SameLine();
+                ImGui::Text("             Coalesced: %7.02f /s", captureCounters.coalesced / m_captureSeconds);
+                ShowHelpMarker("Frames that were queued but superseded by a newer one before we polled.\nHigh values mean we poll less often than the game presents.");
+
+                ImGui::Text("     Missed: %7.02f /s", captureCounters.missed / m_captureSeconds);
+                ShowHelpMarker("Game presents that capture API folded into a single frame (Desktop Duplication only).");
+                ImGui::SameLine();
+                ImGui::Text("           Empty Polls: %7.02f %%", captureCounters.emptyPolls * 100.0f / captureCounters.polls);
+
+                const auto& occupancy = m_captureStats.GetOccupancy();
+                ImGui::Text("      Queue: %7.02f avg", occupancy.Average());
+                ShowHelpMarker("Frames waiting in capture API at each poll.\nReaching the pool size (wgcBuffers in ShaderBeam.ini) means frames are being lost.");
+                ImGui::SameLine();
+                ImGui::Text("              Max/Pool: %3.0f / %u", occupancy.Percentile(1.0f) - occupancy.GetBinWidth(), m_captureStats.GetPoolSize());
+
+                ImGui::Text("    Latency: %7.02f ms", m_captureStats.GetLatency().Percentile(0.5f));
+                ShowHelpMarker("From game present to our poll, median.");
+                ImGui::SameLine();
+                ImGui::Text("             Poll p99: %7.02f ms", m_captureStats.GetPollInterval().Percentile(0.99f));
+
+                // game cadence, spikes here come from the game (or capture API timestamps) rather than from us
+                const auto& frameInterval = m_captureStats.GetFrameInterval();
+                float       bins[HISTOGRAM_BINS];
+                for(unsigned bin = 0; bin < HISTOGRAM_BINS; bin++)
+                    bins[bin] = (float)frameInterval.GetBins()[bin];
+                ImGui::PlotHistogram("Frame Interval", bins, HISTOGRAM_BINS, 0, "0-32 ms", 0.0f, FLT_MAX, ImVec2(0, 60));
+                ShowHelpMarker("Time between game presents as reported by capture API, 1 ms per bar.\nAn uneven spread here means the game itself is stuttering.");
+
+                ImGui::TreePop();
+            }
+
+            if(ImGui::TreeNode("GPU Resources"))
+            {
+                ImGui::Text("       Live: %7.02f MB", m_resourceStats.liveBytes / (1024.0f * 1024.0f));
+                ShowHelpMarker("GPU memory in textures and buffers ShaderBeam created (besides the swap chain).");
+                ImGui::SameLine();
+                ImGui::Text("                Pooled: %7.02f MB", m_resourceStats.idleBytes / (1024.0f * 1024.0f));
+                ShowHelpMarker("Kept from earlier sessions so a restart (or a resize back) picks them up instead of re-creating.");
+
+                ImGui::Text("  Allocated: %7u", m_resourceStats.allocations);
+                ShowHelpMarker("Resources created since ShaderBeam started, restarts served from the pool don't add to it.");
+                ImGui::SameLine();
+                ImGui::Text("                Reused: %7u", m_resourceStats.reuses);
+
+                ImGui::Text("    Shaders: %7.01f ms", m_shaderStartup.compileMs + m_shaderStartup.loadMs);
+                ShowHelpMarker("Time taken to get shaders ready at the last start.\n"
+                               "Compiled shaders are kept in ShaderCache folder, so only the first start (or one after a shader changed) has to compile.");
+                ImGui::SameLine();
+                ImGui::Text("       Compiled/Cached: %3u / %3u", m_shaderStartup.compiled, m_shaderStartup.loaded);
+
+                ImGui::TreePop();
+            }
+
 #ifdef _DEBUG2
             ImGui::Text("Capture Lag: %7.02f ms", m_captureLag);
             ShowHelpMarker("As reported by Windows Capture.");
+            ImGui::Text("Submit p99: %7.02f ms          Missed VSyncs: %6.02f%%", m_submitP99, m_missedVsyncRate * 100.0f);
 #endif
 
             ImGui::SeparatorText("Render Parameters");
@@ -398,6 +498,16 @@ void UI::Render()
             }
             ShowHelpMarker("Queued presentation frames, increase if you're getting irregular flashing.\nTrade-off between input latency and stability.\nThese are output (Display Hz) frames. Driver default is usually 3.");
 
+            if(ImGui::Button(m_autoTuneRunning ? "Cancel Auto-Tune" : "Auto-Tune"))
+                PostMessage(m_options.outputWindow, WM_USER_AUTOTUNE, 0, 0);
+            ShowHelpMarker("Tries every Queued Frames, Shader GPU and capture method combination for a few seconds each\n"
+                           "and keeps the one with fewest missed VSyncs. Run it with your game in motion, takes a few minutes.");
+            if(m_autoTuneStatus[0])
+            {
+                ImGui::SameLine();
+                ImGui::TextUnformatted(m_autoTuneStatus);
+            }
+
             if(ImGui::Checkbox("Auto-Sync", &m_pending.autoSync))
             {
                 SetApplyRequired();
@@ -428,31 +538,37 @@ void UI::Render()
             }
             if(ImGui::Button("Apply Changes"))
             {
-                ApplyPendingChanges();
-                PostMessage(m_options.outputWindow, WM_USER_RESTART, 0, 0);
+                SubmitChanges(true);
             }
             if(applyRequired)
             {
                 ImGui::PopStyleColor(3);
             }
             ImGui::SameLine();
-            ImGui::Checkbox("Remember", &m_options.rememberSettings);
+            if(ImGui::Checkbox("Remember", &m_immediate.rememberSettings))
+                SubmitChanges(false);
+            if(m_lastReconfigure >= 0)
+            {
+                ImGui::SameLine();
+                ImGui::Text("%s: %.1f ms", ReconfigurationPlanner::KindName(m_lastReconfigure), m_reconfigureMs[m_lastReconfigure]);
+                ShowHelpMarker("Time taken to apply the last change.\nOnly resources affected by the change are re-created, Full means complete restart.");
+            }
 
             //////////////////////////////////////////
 
             ImGui::SeparatorText("Shader");
 
-            if(ImGui::BeginCombo("Type", m_shaders[m_options.shaderProfileNo].name.c_str(), 0))
+            if(ImGui::BeginCombo("Type", m_shaders[m_immediate.shaderProfileNo].name.c_str(), 0))
             {
                 for(const auto& shader : m_shaders)
                 {
-                    auto selected = shader.no == m_options.shaderProfileNo;
+                    auto selected = shader.no == m_immediate.shaderProfileNo;
                     if(ImGui::Selectable(shader.name.c_str(), selected))
                     {
-                        if(shader.no != m_options.shaderProfileNo)
+                        if(shader.no != m_immediate.shaderProfileNo)
                         {
-                            m_options.shaderProfileNo = shader.no;
-                            PostMessage(m_options.outputWindow, WM_USER_RESTART, 0, 0);
+                            m_immediate.shaderProfileNo = shader.no;
+                            SubmitChanges(false);
                         }
                     }
                     if(selected)
@@ -462,7 +578,7 @@ void UI::Render()
                 }
                 ImGui::EndCombo();
             }
-            ShowHelpMarker("Shader effect to use.");
+            ShowHelpMarker("Shader effect to use.\nAll of them are kept ready, switching happens at the start of the next cycle without a restart.");
 
             ImGui::PushItemWidth(m_fontSize * 16);
             for(const auto& p : m_shaderManager.GetParameterInfos())
@@ -524,9 +640,23 @@ void UI::Render()
             if(ImGui::BeginPopupModal("Benchmark Result"))
             {
                 if(m_benchmarkResult.copyFPS != 0)
+                {
                     ImGui::Text("      Copy FPS: %8.0f\n", m_benchmarkResult.copyFPS);
+                    ImGui::Text("     Copy GB/s: %8.2f\n", m_benchmarkResult.copyGBps);
+                    ImGui::Text(" CPU Copy GB/s: %8.2f\n", m_benchmarkResult.cpuCopyGBps);
+                    ShowHelpMarker("Pitch-aware copy between mapped surfaces on its own, without the GPU transfers.\n"
+                                   "Set workerThreads in [scheduling] section of ShaderBeam.ini to change how many threads share it.");
+                }
                 ImGui::Text("    Shader FPS: %8.0f\n", m_benchmarkResult.renderFPS);
                 ImGui::Text("   Present FPS: %8.0f\n", m_benchmarkResult.presentFPS);
+                if(m_benchmarkResult.historyPsnr != 0)
+                {
+                    ImGui::Text("  History PSNR: %8.1f dB\n", m_benchmarkResult.historyPsnr);
+                    ShowHelpMarker("Precision kept by compact history (R11G11B10), measured on a synthetic HDR frame.\n"
+                                   "Set compactHistory in [render] section of ShaderBeam.ini to store older frames this way.");
+                    ImGui::Text("   Chroma PSNR: %8.1f dB\n", m_benchmarkResult.chromaPsnr);
+                    ShowHelpMarker("Half-resolution chroma for comparison, not used.");
+                }
                 ImGui::Text(" -------------------------\n");
                 ImGui::Text("   Overall FPS: %8.0f\n\n", m_benchmarkResult.totalFPS);
 
@@ -555,7 +685,7 @@ void UI::Render()
         }
         ImGui::End();
     }
-    if(m_options.banner)
+    if(m_immediate.banner)
     {
         RenderBanner();
     }
@@ -580,9 +710,20 @@ void UI::Stop()
 bool UI::Toggle()
 {
     m_options.ui = !m_options.ui;
+    Invalidate();
     return m_options.ui;
 }
 
+void UI::Invalidate()
+{
+    m_redraw = true;
+}
+
+bool UI::ConsumeRedraw()
+{
+    return m_redraw.exchange(false);
+}
+
 void UI::SetStyle(ImGuiStyle& style)
 {
     style.Colors[ImGuiCol_Text]                  = ImVec4(1.00f, 1.00f, 1.00f, 1.00f);
@@ -667,35 +808,92 @@ void UI::ClearPendingChanges()
     m_pending.autoSync         = m_options.autoSync;
     m_pending.maxQueuedFrames  = m_options.maxQueuedFrames;
     m_pending.useHdr           = m_options.useHdr;
+
+    m_immediate.banner           = m_options.banner;
+    m_immediate.rememberSettings = m_options.rememberSettings;
+    m_immediate.shaderProfileNo  = m_options.shaderProfileNo;
+
+    // anything submitted but not taken is superseded by a restart
+    std::lock_guard lock(m_submitMutex);
+    m_hasSubmittedImmediate = false;
+    m_hasSubmittedPending   = false;
+}
+
+void UI::SubmitChanges(bool pending)
+{
+    // Options belong to the message thread, it takes these in WM_USER_APPLY
+    {
+        std::lock_guard lock(m_submitMutex);
+        m_submittedImmediate    = m_immediate;
+        m_hasSubmittedImmediate = true;
+        if(pending)
+        {
+            m_submittedPending    = m_pending;
+            m_hasSubmittedPending = true;
+            m_applyRequired       = false;
+        }
+    }
+    PostMessage(m_options.outputWindow, WM_USER_APPLY, 0, 0);
 }
 
-void UI::ApplyPendingChanges()
+bool UI::TakeChanges(Options& options)
 {
-    m_options.captureAdapterNo = m_pending.captureAdapterNo;
-    m_options.shaderAdapterNo  = m_pending.shaderAdapterNo;
-    m_options.captureDisplayNo = m_pending.captureDisplayNo;
-    m_options.captureWindow    = m_pending.captureWindow;
-    m_options.shaderDisplayNo  = m_pending.shaderDisplayNo;
-    m_options.subFrames        = m_pending.subFrames;
-    m_options.hardwareSrgb     = m_pending.hardwareSrgb;
-    m_options.captureMethod    = m_pending.captureMethod;
-    m_options.splitScreen      = m_pending.splitScreen;
-    m_options.monitorType      = m_pending.monitorType;
-    m_options.autoSync         = m_pending.autoSync;
-    m_options.maxQueuedFrames  = m_pending.maxQueuedFrames;
-    m_options.useHdr           = m_pending.useHdr;
+    std::lock_guard lock(m_submitMutex);
+    if(m_hasSubmittedImmediate)
+    {
+        options.banner           = m_submittedImmediate.banner;
+        options.rememberSettings = m_submittedImmediate.rememberSettings;
+        options.shaderProfileNo  = m_submittedImmediate.shaderProfileNo;
+    }
+    if(m_hasSubmittedPending)
+    {
+        options.captureAdapterNo = m_submittedPending.captureAdapterNo;
+        options.shaderAdapterNo  = m_submittedPending.shaderAdapterNo;
+        options.captureDisplayNo = m_submittedPending.captureDisplayNo;
+        options.captureWindow    = m_submittedPending.captureWindow;
+        options.shaderDisplayNo  = m_submittedPending.shaderDisplayNo;
+        options.subFrames        = m_submittedPending.subFrames;
+        options.hardwareSrgb     = m_submittedPending.hardwareSrgb;
+        options.captureMethod    = m_submittedPending.captureMethod;
+        options.splitScreen      = m_submittedPending.splitScreen;
+        options.monitorType      = m_submittedPending.monitorType;
+        options.autoSync         = m_submittedPending.autoSync;
+        options.maxQueuedFrames  = m_submittedPending.maxQueuedFrames;
+        options.useHdr           = m_submittedPending.useHdr;
+    }
+
+    const bool taken        = m_hasSubmittedImmediate || m_hasSubmittedPending;
+    m_hasSubmittedImmediate = false;
+    m_hasSubmittedPending   = false;
+    return taken;
 }
 
 void UI::SetBenchmark(const BenchmarkResult& result)
 {
     m_benchmarkResult = result;
     m_hasBenchmark    = true;
+    Invalidate();
+}
+
+void UI::SetReconfigured(int kind, float ms)
+{
+    m_reconfigureMs[kind] = ms;
+    m_lastReconfigure     = kind;
+    Invalidate();
+}
+
+void UI::SetAutoTuneStatus(bool running, const char* status)
+{
+    m_autoTuneRunning = running;
+    strncpy_s(m_autoTuneStatus, status, _TRUNCATE);
+    Invalidate();
 }
 
 void UI::SetError(const char* message)
 {
     m_hasError     = true;
     m_errorMessage = message;
+    Invalidate();
 }
 
 // See http://blogs.msdn.com/b/oldnewthing/archive/2007/10/08/5351207.aspx
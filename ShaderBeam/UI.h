@@ -7,8 +7,15 @@ MIT License
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include "Common.h"
 #include "ShaderManager.h"
+#include "ReconfigurationPlanner.h"
+#include "CaptureStats.h"
+#include "ResourcePool.h"
+#include "ShaderCache.h"
 
 struct ImFont;
 struct ImGuiStyle;
@@ -29,13 +36,38 @@ public:
 
     void SetError(const char* message);
     void SetBenchmark(const BenchmarkResult& result);
+    void SetAutoTuneStatus(bool running, const char* status);
+    void SetReconfigured(int kind, float ms);
     void AddWindow(HWND hWnd);
     bool RenderRequired() const;
     bool Toggle();
 
+    // message thread: copies what the UI (drawn on the render thread) submitted into options, false if nothing was
+    bool TakeChanges(Options& options);
+
+    // anything shown changed, the cached overlay gets redrawn on the next subframe instead of at its capped rate
+    void Invalidate();
+    bool ConsumeRedraw();
+
     float m_inputFPS { 0 };
     float m_outputFPS { 0 };
     float m_captureLag { 0 };
+    float m_submitP99 { 0 };
+    float m_missedVsyncRate { 0 };
+    float m_wakeupJitter { 0 };
+    float m_wakeupJitterMax { 0 };
+    float m_readbackQueue { 0 };
+    float m_readbackDrops { 0 };
+    float m_transferShare { 1 };
+    float m_duplicateFrames { 0 };
+    float m_recordedFPS { 0 };
+    float m_recordDrops { 0 };
+    float m_recordedMB { 0 };
+
+    CaptureStats      m_captureStats; // last snapshot window
+    float             m_captureSeconds { 1 };
+    ResourcePoolStats m_resourceStats;
+    ShaderCacheStats  m_shaderStartup; // shaders created by the last start
 
     std::vector<AdapterInfo> m_adapters;
     std::vector<DisplayInfo> m_displays;
@@ -50,11 +82,12 @@ private:
     void SetStyle(ImGuiStyle& style);
     void RenderBanner();
     void SetApplyRequired();
-    void ApplyPendingChanges();
+    void SubmitChanges(bool pending);
     void ClearPendingChanges();
     void ScanWindows();
 
-    struct
+    // waiting for Apply Changes
+    struct PendingChanges
     {
         int  captureAdapterNo;
         int  shaderAdapterNo;
@@ -69,7 +102,18 @@ private:
         bool autoSync;
         int  maxQueuedFrames;
         bool useHdr;
-    } m_pending;
+    };
+
+    // applied as soon as they're changed
+    struct ImmediateChanges
+    {
+        bool banner;
+        bool rememberSettings;
+        int  shaderProfileNo;
+    };
+
+    PendingChanges   m_pending;
+    ImmediateChanges m_immediate;
 
     ImFont*         m_smallFont;
     ImFont*         m_largeFont;
@@ -85,5 +129,17 @@ private:
     std::string     m_captureWindowName;
     bool            m_hasError { false };
     std::string     m_errorMessage;
+    bool            m_autoTuneRunning { false };
+    char            m_autoTuneStatus[128] {};
+    int             m_lastReconfigure { -1 };
+    float           m_reconfigureMs[RECONFIGURE_KINDS] {};
+
+    std::atomic<bool> m_redraw { true }; // set from the message thread, taken by the render thread
+
+    std::mutex       m_submitMutex; // guards the submitted copies below, taken by the message thread
+    PendingChanges   m_submittedPending {};
+    ImmediateChanges m_submittedImmediate {};
+    bool             m_hasSubmittedPending { false };
+    bool             m_hasSubmittedImmediate { false };
 };
 } // namespace ShaderBeam
\ No newline at end of file
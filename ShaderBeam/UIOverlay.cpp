@@ -0,0 +1,137 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "stdafx.h"
+
+#include "UIOverlay.h"
+#include "Helpers.h"
+
+#include "imgui.h"
+
+namespace ShaderBeam
+{
+
+UIOverlay::UIOverlay(UI& ui) : m_ui(ui) { }
+
+void UIOverlay::Create(const RenderContext& renderContext, DXGI_FORMAT format, unsigned width, unsigned height)
+{
+    // plain copy of a texel, same as compact history uses
+    auto vertexCode = Helpers::CompileShader(L"Shaders\\History.hlsl", nullptr, "VSmain", "vs_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreateVertexShader(vertexCode.data(), vertexCode.size(), NULL, m_vertexShader.put()), "Unable to create vertex shader");
+    auto pixelCode = Helpers::CompileShader(L"Shaders\\History.hlsl", nullptr, "PSmain", "ps_5_0", renderContext.shaderCache);
+    THROW(renderContext.device->CreatePixelShader(pixelCode.data(), pixelCode.size(), NULL, m_pixelShader.put()), "Unable to create pixel shader");
+
+    // ImGui blends colour by its alpha and alpha by one, so on a cleared target it leaves premultiplied colour
+    D3D11_BLEND_DESC blendDesc {};
+    blendDesc.RenderTarget[0].BlendEnable           = TRUE;
+    blendDesc.RenderTarget[0].SrcBlend              = D3D11_BLEND_ONE;
+    blendDesc.RenderTarget[0].DestBlend             = D3D11_BLEND_INV_SRC_ALPHA;
+    blendDesc.RenderTarget[0].BlendOp               = D3D11_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].SrcBlendAlpha         = D3D11_BLEND_ONE;
+    blendDesc.RenderTarget[0].DestBlendAlpha        = D3D11_BLEND_INV_SRC_ALPHA;
+    blendDesc.RenderTarget[0].BlendOpAlpha          = D3D11_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    THROW(renderContext.device->CreateBlendState(&blendDesc, m_blendState.put()), "Unable to create overlay blend state");
+
+    D3D11_TEXTURE2D_DESC desc {};
+    desc.Width              = width;
+    desc.Height             = height;
+    desc.ArraySize          = 1;
+    desc.Format             = format;
+    desc.SampleDesc.Count   = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.MipLevels          = 1;
+    desc.MiscFlags          = 0;
+    desc.CPUAccessFlags     = 0;
+    desc.Usage              = D3D11_USAGE_DEFAULT;
+    desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+
+    m_resources = renderContext.resources;
+    m_texture   = m_resources->AcquireTexture(renderContext.device.get(), desc);
+    THROW(renderContext.device->CreateShaderResourceView(m_texture.get(), nullptr, m_view.put()), "Unable to create overlay view");
+    THROW(renderContext.device->CreateRenderTargetView(m_texture.get(), nullptr, m_target.put()), "Unable to create overlay target");
+
+    m_width      = width;
+    m_height     = height;
+    m_bounds     = {};
+    m_drawnTicks = 0;
+    m_ui.Invalidate();
+}
+
+void UIOverlay::Destroy()
+{
+    m_target = nullptr;
+    m_view   = nullptr;
+    if(m_resources)
+        m_resources->Release(m_texture);
+    m_blendState   = nullptr;
+    m_pixelShader  = nullptr;
+    m_vertexShader = nullptr;
+}
+
+void UIOverlay::Render(const RenderContext& renderContext, ID3D11RenderTargetView* target)
+{
+    if(!m_texture)
+        return;
+
+    const auto now = Helpers::GetTicks();
+    if(m_ui.ConsumeRedraw() || now - m_drawnTicks >= TICKS_PER_SEC / UI_OVERLAY_RATE)
+    {
+        m_drawnTicks = now;
+        Draw(renderContext);
+    }
+
+    if(m_bounds.right <= m_bounds.left || m_bounds.bottom <= m_bounds.top)
+        return;
+
+    // copy is 1:1, so only the texels the UI covers get touched
+    renderContext.deviceContext->RSSetScissorRects(1, &m_bounds);
+    renderContext.deviceContext->OMSetRenderTargets(1, &target, NULL);
+    renderContext.deviceContext->OMSetBlendState(m_blendState.get(), NULL, 0xffffffff);
+
+    renderContext.deviceContext->VSSetShader(m_vertexShader.get(), NULL, 0);
+    renderContext.deviceContext->PSSetShader(m_pixelShader.get(), NULL, 0);
+    renderContext.deviceContext->IASetInputLayout(NULL);
+    renderContext.deviceContext->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    ID3D11ShaderResourceView* views[] = { m_view.get() };
+    renderContext.deviceContext->PSSetShaderResources(0, 1, views);
+    renderContext.deviceContext->Draw(3, 0);
+
+    ID3D11ShaderResourceView* nullv[] = { nullptr };
+    renderContext.deviceContext->PSSetShaderResources(0, 1, nullv);
+}
+
+void UIOverlay::Draw(const RenderContext& renderContext)
+{
+    static const float transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    renderContext.deviceContext->ClearRenderTargetView(m_target.get(), transparent);
+
+    // ImGui saves and restores the pipeline state it changes
+    ID3D11RenderTargetView* targets[1] = { m_target.get() };
+    renderContext.deviceContext->OMSetRenderTargets(1, targets, NULL);
+    m_ui.Render();
+
+    // union of the clip rectangles is a safe bound of what was drawn
+    m_bounds            = { LONG_MAX, LONG_MAX, LONG_MIN, LONG_MIN };
+    const auto drawData = ImGui::GetDrawData();
+    for(int list = 0; drawData && list < drawData->CmdListsCount; list++)
+    {
+        for(const auto& command : drawData->CmdLists[list]->CmdBuffer)
+        {
+            m_bounds.left   = min(m_bounds.left, (LONG)floorf(command.ClipRect.x - drawData->DisplayPos.x));
+            m_bounds.top    = min(m_bounds.top, (LONG)floorf(command.ClipRect.y - drawData->DisplayPos.y));
+            m_bounds.right  = max(m_bounds.right, (LONG)ceilf(command.ClipRect.z - drawData->DisplayPos.x));
+            m_bounds.bottom = max(m_bounds.bottom, (LONG)ceilf(command.ClipRect.w - drawData->DisplayPos.y));
+        }
+    }
+    m_bounds.left   = max(m_bounds.left, 0L);
+    m_bounds.top    = max(m_bounds.top, 0L);
+    m_bounds.right  = min(m_bounds.right, (LONG)m_width);
+    m_bounds.bottom = min(m_bounds.bottom, (LONG)m_height);
+}
+
+} // namespace ShaderBeam
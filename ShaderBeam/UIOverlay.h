@@ -0,0 +1,49 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+#include "Common.h"
+#include "RenderContext.h"
+#include "UI.h"
+
+namespace ShaderBeam
+{
+
+#define UI_OVERLAY_RATE 60 // redraws per second when nothing was invalidated
+
+// UI drawn into a premultiplied texture when something changed (or at a capped rate for live stats),
+// every subframe only blends what it covers onto the output
+class UIOverlay
+{
+public:
+    UIOverlay(UI& ui);
+
+    void Create(const RenderContext& renderContext, DXGI_FORMAT format, unsigned width, unsigned height);
+    void Destroy();
+
+    // caller restores targets, blend state and scissor for the main pass
+    void Render(const RenderContext& renderContext, ID3D11RenderTargetView* target);
+
+private:
+    UI& m_ui;
+
+    winrt::com_ptr<ID3D11Texture2D>          m_texture;
+    winrt::com_ptr<ID3D11ShaderResourceView> m_view;
+    winrt::com_ptr<ID3D11RenderTargetView>   m_target;
+    winrt::com_ptr<ID3D11VertexShader>       m_vertexShader;
+    winrt::com_ptr<ID3D11PixelShader>        m_pixelShader;
+    winrt::com_ptr<ID3D11BlendState>         m_blendState;
+    ResourcePool*                            m_resources { nullptr };
+    unsigned                                 m_width { 0 };
+    unsigned                                 m_height { 0 };
+    D3D11_RECT                               m_bounds {}; // of everything drawn, empty when nothing is
+    float                                    m_drawnTicks { 0 };
+
+    void Draw(const RenderContext& renderContext);
+};
+} // namespace ShaderBeam
@@ -101,22 +101,77 @@ float Chart::Min(int numSamples)
     return min;
 }
 
-Watcher::Watcher(UI& ui) : m_ui(ui) { }
+float Chart::Percentile(int numSamples, float percentile)
+{
+    numSamples = min(numSamples, CHARTS_LEN);
+    if(numSamples <= 0)
+        return 0;
+
+    float samples[CHARTS_LEN];
+    auto  index = m_index;
+    for(int i = 0; i < numSamples; i++)
+    {
+        index--;
+        if(index < 0)
+            index += CHARTS_LEN;
+        samples[i] = m_values[index];
+    }
+
+    auto nth = std::clamp((int)ceilf(percentile * numSamples) - 1, 0, numSamples - 1);
+    std::nth_element(samples, samples + nth, samples + numSamples);
+    return samples[nth];
+}
+
+int Chart::CountAbove(int numSamples, float threshold)
+{
+    numSamples = min(numSamples, CHARTS_LEN);
+
+    int  count = 0;
+    auto index = m_index;
+    for(int i = 0; i < numSamples; i++)
+    {
+        index--;
+        if(index < 0)
+            index += CHARTS_LEN;
+        if(m_values[index] > threshold)
+            count++;
+    }
+    return count;
+}
+
+Watcher::Watcher(UI& ui, const Options& options, const ResourcePool& resourcePool) : m_ui(ui), m_options(options), m_resourcePool(resourcePool) { }
 
 void Watcher::Start()
 {
     m_receiveChart.Clear();
     m_submitChart.Clear();
-    m_lastSnapshot = Helpers::GetTicks();
-    m_inputFrames  = 0;
-    m_outputFrames = 0;
+    m_presentChart.Clear();
+    m_pollChart.Clear();
+    m_phaseChart.Clear();
+    m_lastPresentCount = 0;
+    m_lastSyncQPC      = 0;
+    m_lastSnapshot     = Helpers::GetTicks();
+    m_inputFrames      = 0;
+    m_outputFrames     = 0;
+    m_readbacks        = 0;
+    m_readbackQueued   = 0;
+    m_readbackDrops    = 0;
+    m_duplicates       = 0;
+    m_transfers        = 0;
+    m_transferCoverage = 0;
+    m_recorded         = 0;
+    m_recordDrops      = 0;
+    m_recordedBytes    = 0;
+    m_wakeupJitter.Reset();
 }
 
 void Watcher::Stop() { }
 
 void Watcher::FrameSubmitted()
 {
-    m_submitChart.AddDelta();
+    auto now = Helpers::GetTicks();
+    m_submitChart.AddDelta(now);
+    m_wakeupJitter.AddWakeup(now, m_options.vsyncDuration);
     m_outputFrames++;
     UpdateSnapshot();
 }
@@ -130,18 +185,114 @@ void Watcher::FrameReceived(float value)
     UpdateSnapshot();
 }
 
+void Watcher::FramePresented(unsigned presentCount, ULONGLONG syncQPC)
+{
+    if(presentCount == m_lastPresentCount)
+        return;
+
+    if(m_lastPresentCount && syncQPC > m_lastSyncQPC)
+    {
+        // several presents since the last call share the interval
+        m_presentChart.AddValue(Helpers::QPCToDeltaMs(syncQPC - m_lastSyncQPC) / (presentCount - m_lastPresentCount));
+
+        // statistics can trail by a few vblanks, only the position within one refresh matters
+        auto sinceVblank = Helpers::QPCToDeltaMs(Helpers::GetQPC() - syncQPC);
+        m_phaseChart.AddValue(m_options.vsyncDuration > 0 ? fmodf(sinceVblank, m_options.vsyncDuration) : sinceVblank);
+    }
+    m_lastPresentCount = presentCount;
+    m_lastSyncQPC      = syncQPC;
+}
+
+void Watcher::CapturePolled(float ms)
+{
+    m_pollChart.AddValue(ms);
+}
+
+void Watcher::ReadbackCompleted(unsigned queued)
+{
+    m_readbacks++;
+    m_readbackQueued += queued;
+}
+
+void Watcher::ReadbackDropped()
+{
+    m_readbackDrops++;
+}
+
+void Watcher::FrameTransferred(float coverage)
+{
+    m_transfers++;
+    m_transferCoverage += coverage;
+}
+
+void Watcher::FrameDuplicated()
+{
+    m_duplicates++;
+}
+
+void Watcher::SubframeRecorded(bool written)
+{
+    if(written)
+        m_recorded++;
+    else
+        m_recordDrops++;
+}
+
+void Watcher::RecordingProgress(uint64_t bytesWritten)
+{
+    m_recordedBytes = bytesWritten;
+}
+
+void Watcher::RecordingFailed(const std::string& path)
+{
+    // UI is drawn on the render thread too, so this is safe from here
+    m_ui.SetError(("Recording stopped, unable to write to " + path + " (disk full?)").c_str());
+}
+
+CaptureStats& Watcher::GetCaptureStats()
+{
+    return m_captureStats;
+}
+
 void Watcher::UpdateSnapshot()
 {
     auto now = Helpers::GetTicks();
     if(now - m_lastSnapshot > SNAPSHOT_DURATION)
     {
-        auto secondsElapsed = (now - m_lastSnapshot) / TICKS_PER_SEC;
-        m_ui.m_inputFPS     = m_inputFrames / secondsElapsed;
-        m_ui.m_outputFPS    = m_outputFrames / secondsElapsed;
-        m_ui.m_captureLag   = m_receiveChart.Min(m_inputFrames);
-        m_inputFrames       = 0;
-        m_outputFrames      = 0;
-        m_lastSnapshot      = now;
+        // a submit interval half a vsync longer than expected means we've missed one
+        auto missedVsyncs = m_submitChart.CountAbove(m_outputFrames, m_options.vsyncDuration * 1.5f);
+
+        auto secondsElapsed    = (now - m_lastSnapshot) / TICKS_PER_SEC;
+        m_ui.m_inputFPS        = m_inputFrames / secondsElapsed;
+        m_ui.m_outputFPS       = m_outputFrames / secondsElapsed;
+        m_ui.m_captureLag      = m_receiveChart.Min(m_inputFrames);
+        m_ui.m_submitP99       = m_submitChart.Percentile(m_outputFrames, 0.99f);
+        m_ui.m_missedVsyncRate = m_outputFrames ? missedVsyncs / (float)m_outputFrames : 0;
+        m_ui.m_wakeupJitter    = (float)m_wakeupJitter.StdDev();
+        m_ui.m_wakeupJitterMax = (float)m_wakeupJitter.Max();
+        m_ui.m_readbackQueue   = m_readbacks ? m_readbackQueued / (float)m_readbacks : 0;
+        m_ui.m_readbackDrops   = m_readbackDrops / secondsElapsed;
+        m_ui.m_transferShare   = m_transfers ? m_transferCoverage / m_transfers : 1.0f;
+        m_ui.m_duplicateFrames = m_duplicates / secondsElapsed;
+        m_ui.m_recordedFPS     = m_recorded / secondsElapsed;
+        m_ui.m_recordDrops     = m_recordDrops / secondsElapsed;
+        m_ui.m_recordedMB      = m_recordedBytes / (1024.0f * 1024.0f);
+        m_ui.m_captureStats    = m_captureStats;
+        m_ui.m_captureSeconds  = secondsElapsed;
+        m_ui.m_resourceStats   = m_resourcePool.GetStats();
+        m_inputFrames          = 0;
+        m_outputFrames         = 0;
+        m_readbacks            = 0;
+        m_readbackQueued       = 0;
+        m_readbackDrops        = 0;
+        m_duplicates           = 0;
+        m_transfers            = 0;
+        m_transferCoverage     = 0;
+        m_recorded             = 0;
+        m_recordDrops          = 0;
+        m_lastSnapshot         = now;
+        m_captureStats.ClearWindow();
+        m_wakeupJitter.Reset();
     }
 }
 
@@ -8,6 +8,9 @@ MIT License
 #pragma once
 
 #include "UI.h"
+#include "ThreadScheduler.h"
+#include "CaptureStats.h"
+#include "ResourcePool.h"
 
 namespace ShaderBeam
 {
@@ -27,15 +30,17 @@ struct Chart
     void SetStart(float value);
     void AddValue(float value);
 
-    bool Read(int& index, float& value);
+    bool  Read(int& index, float& value);
     float Average(int numSamples);
     float Min(int numSamples);
+    float Percentile(int numSamples, float percentile);
+    int   CountAbove(int numSamples, float threshold);
 };
 
 class Watcher
 {
 public:
-    Watcher(UI& ui);
+    Watcher(UI& ui, const Options& options, const ResourcePool& resourcePool);
 
     void Start();
 
@@ -43,18 +48,61 @@ public:
 
     void FrameReceived(float value);
 
+    // from swap chain frame statistics, the vblank the last present was shown at
+    void FramePresented(unsigned presentCount, ULONGLONG syncQPC);
+
+    void CapturePolled(float ms);
+
+    void ReadbackCompleted(unsigned queued);
+
+    void ReadbackDropped();
+
+    void FrameTransferred(float coverage);
+
+    void FrameDuplicated();
+
+    void SubframeRecorded(bool written);
+
+    // writer's running total, and when it can't write any more (recording stops then)
+    void RecordingProgress(uint64_t bytesWritten);
+    void RecordingFailed(const std::string& path);
+
+    // filled in by the active capture backend
+    CaptureStats& GetCaptureStats();
+
     void Stop();
 
     Chart m_submitChart;
     Chart m_receiveChart;
+    Chart m_presentChart; // between displayed presents
+    Chart m_pollChart;    // capture poll duration
+    Chart m_phaseChart;   // render thread wakeup after the vblank
 
 private:
-    UI& m_ui;
+    UI&                 m_ui;
+    const Options&      m_options;
+    const ResourcePool& m_resourcePool;
 
     float m_lastSnapshot { 0 };
 
+    unsigned  m_lastPresentCount { 0 };
+    ULONGLONG m_lastSyncQPC { 0 };
+
     int m_inputFrames { 0 };
     int m_outputFrames { 0 };
+    int m_readbacks { 0 };
+    int m_readbackQueued { 0 };
+    int m_readbackDrops { 0 };
+    int      m_duplicates { 0 };
+    int      m_transfers { 0 };
+    float    m_transferCoverage { 0 };
+    int      m_recorded { 0 };
+    int      m_recordDrops { 0 };
+    uint64_t m_recordedBytes { 0 };
+
+    CaptureStats m_captureStats;
+
+    WakeupJitter m_wakeupJitter;
 
     void UpdateSnapshot();
 };
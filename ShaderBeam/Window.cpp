@@ -27,7 +27,6 @@ LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ int nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
 
     SetProcessDPIAware();
 
@@ -42,6 +41,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
         return FALSE;
     }
 
+    // unattended deployments can tune the machine on first run
+    if(lpCmdLine && wcsstr(lpCmdLine, L"/autotune"))
+        PostMessage(s_shaderBeam.m_options.outputWindow, WM_USER_AUTOTUNE, 0, 0);
+
     HACCEL hAccelTable = LoadAccelerators(hInstance, MAKEINTRESOURCE(IDC_SHADERBEAM));
 
     MSG msg;
@@ -174,6 +177,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     case WM_TIMER: {
         if(s_shaderBeam.m_options.ui)
             s_shaderBeam.UpdateVsyncRate();
+        s_shaderBeam.UpdateAutoTune();
         break;
     }
     case WM_USER_RESTART: {
@@ -187,9 +191,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         s_shaderBeam.RunBenchmark();
         break;
     }
+    case WM_USER_APPLY: {
+        s_shaderBeam.m_ui.TakeChanges(s_shaderBeam.m_options);
+        if(!s_shaderBeam.ApplyOptions())
+            PostMessage(hWnd, WM_USER_RESTART, 0, 0);
+        break;
+    }
+    case WM_USER_AUTOTUNE: {
+        s_shaderBeam.StartAutoTune();
+        break;
+    }
     case WM_USER_NOWINDOW: {
         s_shaderBeam.m_options.captureWindow = NULL;
-        PostMessage(hWnd, WM_USER_RESTART, 0, 0);
+        PostMessage(hWnd, WM_USER_APPLY, 0, 0);
         break;
     }
     case WM_HOTKEY: {
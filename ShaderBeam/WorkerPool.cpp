@@ -0,0 +1,127 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+namespace ShaderBeam
+{
+
+WorkerPool::~WorkerPool()
+{
+    Stop();
+}
+
+void WorkerPool::Start(unsigned numThreads, const std::function<void()>& threadInit)
+{
+    Stop();
+
+    m_stop = false;
+    for(unsigned i = 0; i < numThreads; i++)
+        m_threads.emplace_back(&WorkerPool::Work, this, threadInit);
+}
+
+void WorkerPool::Stop()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_jobPosted.notify_all();
+    for(auto& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+unsigned WorkerPool::GetNumThreads() const
+{
+    return (unsigned)m_threads.size();
+}
+
+unsigned WorkerPool::DefaultThreads()
+{
+    // leave room for render, capture and the game itself
+    auto cores = std::thread::hardware_concurrency();
+    return std::clamp(cores / 4, 1u, 4u);
+}
+
+void WorkerPool::Run(unsigned numTasks, const std::function<void(unsigned)>& task)
+{
+    if(numTasks == 0)
+        return;
+
+    if(m_threads.empty() || numTasks == 1)
+    {
+        for(unsigned i = 0; i < numTasks; i++)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_task      = &task;
+        m_numTasks  = numTasks;
+        m_nextTask  = 0;
+        m_tasksDone = 0;
+        m_generation++;
+    }
+    m_jobPosted.notify_all();
+
+    RunTasks(task, numTasks);
+
+    // workers that joined late must be out before task goes out of scope
+    std::unique_lock lock(m_mutex);
+    m_jobDone.wait(lock, [&] { return m_tasksDone == numTasks && m_activeWorkers == 0; });
+    m_task = nullptr;
+}
+
+void WorkerPool::RunTasks(const std::function<void(unsigned)>& task, unsigned numTasks)
+{
+    unsigned done = 0;
+    for(auto i = m_nextTask++; i < numTasks; i = m_nextTask++)
+    {
+        task(i);
+        done++;
+    }
+    if(done && m_tasksDone.fetch_add(done) + done == numTasks)
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobDone.notify_all();
+    }
+}
+
+void WorkerPool::Work(const std::function<void()>& threadInit)
+{
+    if(threadInit)
+        threadInit();
+
+    uint64_t generation = 0;
+    while(true)
+    {
+        const std::function<void(unsigned)>* task;
+        unsigned                             numTasks;
+        {
+            std::unique_lock lock(m_mutex);
+            m_jobPosted.wait(lock, [&] { return m_stop || (m_task && m_generation != generation); });
+            if(m_stop)
+                return;
+            generation = m_generation;
+            task       = m_task;
+            numTasks   = m_numTasks;
+            m_activeWorkers++;
+        }
+        RunTasks(*task, numTasks);
+        {
+            std::lock_guard lock(m_mutex);
+            m_activeWorkers--;
+        }
+        m_jobDone.notify_all();
+    }
+}
+
+} // namespace ShaderBeam
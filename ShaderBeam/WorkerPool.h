@@ -0,0 +1,56 @@
+/*
+ShaderBeam: shader effect overlay
+Copyright (C) 2025 mausimus (mausimus.net)
+https://github.com/mausimus/ShaderBeam
+MIT License
+*/
+
+#pragma once
+
+// no Windows dependencies in here so it can be exercised on Linux too
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ShaderBeam
+{
+
+// fixed set of threads running parallel-for style jobs, calling thread takes part too
+class WorkerPool
+{
+public:
+    ~WorkerPool();
+
+    // threadInit runs once on each worker (e.g. to apply scheduling policy)
+    void Start(unsigned numThreads, const std::function<void()>& threadInit = nullptr);
+    void Stop();
+
+    // runs task(0..numTasks-1) across workers and the caller, returns when all are done
+    void Run(unsigned numTasks, const std::function<void(unsigned)>& task);
+
+    unsigned GetNumThreads() const;
+
+    static unsigned DefaultThreads();
+
+private:
+    void Work(const std::function<void()>& threadInit);
+    void RunTasks(const std::function<void(unsigned)>& task, unsigned numTasks);
+
+    std::vector<std::thread>             m_threads;
+    std::mutex                           m_mutex;
+    std::condition_variable              m_jobPosted;
+    std::condition_variable              m_jobDone;
+    const std::function<void(unsigned)>* m_task { nullptr };
+    unsigned                             m_numTasks { 0 };
+    std::atomic<unsigned>                m_nextTask { 0 };
+    std::atomic<unsigned>                m_tasksDone { 0 };
+    unsigned                             m_activeWorkers { 0 };
+    uint64_t                             m_generation { 0 };
+    bool                                 m_stop { false };
+};
+} // namespace ShaderBeam
@@ -14,6 +14,7 @@ MIT License
 #include <comdef.h>
 #include <timeapi.h>
 #include <dwmapi.h>
+#include <bcrypt.h>
 // C RunTime Header Files
 #include <stdlib.h>
 #include <malloc.h>
@@ -32,5 +33,6 @@ MIT License
 #include <winrt/Windows.Graphics.Capture.h>
 
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <d3dcompiler.h>
 #include <dxgi1_6.h>